@@ -2,6 +2,8 @@
 
 #pragma once
 
+#include <functional>
+
 #include "entity.h"
 #include "spimpl.h"
 #include "global.h"
@@ -10,12 +12,16 @@ namespace libscratchcpp
 {
 
 class Target;
+class AssetCache;
 class AssetPrivate;
 
 /*! \brief The Asset class represents a Scratch asset, for example a Costume or a Sound. */
 class LIBSCRATCHCPP_EXPORT Asset : public Entity
 {
     public:
+        /*! A function which loads the asset data into the given buffer and returns its size. */
+        using DataLoader = std::function<size_t(std::shared_ptr<const void> &)>;
+
         Asset(const std::string &name, const std::string &id, const std::string &format);
         Asset(const Asset &) = delete;
 
@@ -30,8 +36,14 @@ class LIBSCRATCHCPP_EXPORT Asset : public Entity
         const std::string &dataFormat() const;
 
         const void *data() const;
+        std::shared_ptr<const void> sharedData() const;
         unsigned int dataSize() const;
         void setData(unsigned int size, void *data);
+        void setData(unsigned int size, std::shared_ptr<const void> data);
+
+        void setDataLoader(const DataLoader &loader);
+        bool isDataLoaded() const;
+        void prefetch();
 
         Target *target() const;
         void setTarget(Target *target);
@@ -41,7 +53,13 @@ class LIBSCRATCHCPP_EXPORT Asset : public Entity
         virtual bool isClone() const { return false; }
 
     private:
+        void setDataLoaderUnlocked(const DataLoader &loader);
+        void loadData();
+        void evictData();
+
         spimpl::unique_impl_ptr<AssetPrivate> impl;
+
+        friend class AssetCache;
 };
 
 } // namespace libscratchcpp
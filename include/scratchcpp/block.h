@@ -29,6 +29,7 @@ class LIBSCRATCHCPP_EXPORT Block
         CompilerValue *compile(Compiler *compiler);
 
         const std::string &opcode() const;
+        unsigned int opcodeId() const;
 
         Block *next() const;
         const std::string &nextId() const;
@@ -10,6 +10,8 @@ namespace libscratchcpp
 
 class IEngine;
 class Target;
+class Thread;
+struct ValueData;
 class CompilerContextPrivate;
 
 /*! \brief The CompilerContext represents a context for a specific target which is used with the Compiler class. */
@@ -23,12 +25,25 @@ class LIBSCRATCHCPP_EXPORT CompilerContext
         IEngine *engine() const;
         Target *target() const;
 
+        bool reporterBatchEnabled() const;
+        void setReporterBatchEnabled(bool enabled);
+
         /*!
          * Optimizes compiled scripts ahead of time.
          * \see Compiler#preoptimize()
          */
         virtual void preoptimize() { }
 
+        /*!
+         * Runs all reporters compiled in this context using a single call.\n
+         * Reporters are indexed in the order they were compiled. Reporters with a false value in the mask
+         * are skipped, the return values of the other reporters are stored in the results array.
+         * \note Make sure to call value_free() to free the stored values.
+         * \returns False if the context doesn't support running reporters in a batch.
+         * \see setReporterBatchEnabled()
+         */
+        virtual bool runReporters(Thread *thread, const bool *mask, ValueData *results) { return false; }
+
     private:
         spimpl::unique_impl_ptr<CompilerContextPrivate> impl;
 };
@@ -19,6 +19,7 @@ class LIBSCRATCHCPP_EXPORT Drawable
     public:
         Drawable();
         Drawable(const Drawable &) = delete;
+        ~Drawable();
 
         /*! Returns true if this Drawable is a Target. */
         virtual bool isTarget() const { return false; }
@@ -34,6 +35,8 @@ class LIBSCRATCHCPP_EXPORT Drawable
         virtual void setEngine(IEngine *engine);
 
     private:
+        friend class LayerList;
+
         spimpl::unique_impl_ptr<DrawablePrivate> impl;
 };
 
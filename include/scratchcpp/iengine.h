@@ -97,6 +97,27 @@ class LIBSCRATCHCPP_EXPORT IEngine
         /*! Sets the global volume of all sounds (in %). */
         virtual void setGlobalVolume(double volume) = 0;
 
+        /*!
+         * Returns the sound mixed by step() since the last call to clearRenderedAudio().
+         * The samples are interleaved (see renderedAudioChannels()) and the audio is only rendered with offline audio.
+         * \warning Every step appends to the rendered audio (about 23 MB per minute of 48 kHz stereo audio),
+         * so call clearRenderedAudio() after consuming it, otherwise it grows for as long as the project runs.
+         * \see ScratchConfiguration::setOfflineAudio()
+         */
+        virtual const std::vector<float> &renderedAudio() const = 0;
+
+        /*! Returns the sample rate of renderedAudio(). */
+        virtual unsigned int renderedAudioSampleRate() const = 0;
+
+        /*! Returns the number of channels of renderedAudio(). */
+        virtual unsigned int renderedAudioChannels() const = 0;
+
+        /*! Clears the rendered audio. */
+        virtual void clearRenderedAudio() = 0;
+
+        /*! Writes the rendered audio to the given WAV file. Returns false if the file couldn't be written. */
+        virtual bool saveRenderedAudio(const std::string &fileName) const = 0;
+
         /*! Updates the values of stage monitors. */
         virtual void updateMonitors() = 0;
 
@@ -147,6 +168,9 @@ class LIBSCRATCHCPP_EXPORT IEngine
         /*! Returns true if the given key is pressed. */
         virtual bool keyPressed(const std::string &name) const = 0;
 
+        /*! Returns true if the key with the given code is pressed (see KeyEvent#code()). */
+        virtual bool keyPressed(unsigned int keyCode) const = 0;
+
         /*! Sets the state of the key with the given name. */
         virtual void setKeyState(const std::string &name, bool pressed) = 0;
 
@@ -216,6 +240,19 @@ class LIBSCRATCHCPP_EXPORT IEngine
         /*! Toggles sprite fencing. */
         virtual void setSpriteFencingEnabled(bool enable) = 0;
 
+        /*! Returns true if results of touching queries are cached. */
+        virtual bool collisionCacheEnabled() const = 0;
+
+        /*!
+         * Toggles caching of touching query results (disabled by default).\n
+         * Cached results are reused within a frame until any of the involved targets changes.
+         * \note Pen drawing isn't tracked, so color queries may return outdated results until the next frame.
+         */
+        virtual void setCollisionCacheEnabled(bool enable) = 0;
+
+        /*! Returns the number of frames which have been stepped since the engine was created. */
+        virtual unsigned int frameCount() const = 0;
+
         /*!
          * Call this from a block implementation to force a redraw (screen refresh).
          * \note This has no effect in "run without screen refresh" custom blocks.
@@ -268,6 +305,12 @@ class LIBSCRATCHCPP_EXPORT IEngine
         /*! Returns the list of indexes of the broadcasts with the given name (case insensitive). */
         virtual std::vector<int> findBroadcasts(const std::string &broadcastName) const = 0;
 
+        /*!
+         * Returns the list of indices of the broadcasts with the given UTF-16 name (case insensitive).\n
+         * The broadcasts are indexed by name when they're set, so the returned list remains valid until setBroadcasts() is called.
+         */
+        virtual const std::vector<int> &findBroadcasts(const StringPtr *broadcastName) const = 0;
+
         /*! Returns the index of the broadcast with the given ID. */
         virtual int findBroadcastById(const std::string &broadcastId) const = 0;
 
@@ -314,6 +357,13 @@ class LIBSCRATCHCPP_EXPORT IEngine
          */
         virtual int findTarget(const std::string &targetName) const = 0;
 
+        /*!
+         * Returns the index of the target with the given UTF-16 name.\n
+         * This uses a hash index of target names, which is built when the targets are set.
+         * \see findTarget(const std::string &)
+         */
+        virtual int findTarget(const StringPtr *targetName) const = 0;
+
         /*! Moves the given sprite to the front layer. */
         virtual void moveDrawableToFront(Drawable *drawable) = 0;
 
@@ -25,11 +25,15 @@ class LIBSCRATCHCPP_EXPORT KeyEvent
             Enter
         };
 
+        /*! The number of distinct key codes returned by code(). */
+        static constexpr unsigned int CODE_COUNT = 263;
+
         KeyEvent(Type type = Type::Any);
         KeyEvent(const std::string &name);
 
         Type type() const;
         const std::string &name() const;
+        unsigned int code() const;
 
         friend bool operator==(const KeyEvent &ev1, const KeyEvent &ev2) { return ev1.name() == ev2.name(); }
 
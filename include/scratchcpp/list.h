@@ -64,6 +64,18 @@ class LIBSCRATCHCPP_EXPORT List : public Entity
         /*! Returns the list size. */
         inline size_t size() const { return m_size; }
 
+        /*!
+         * Returns the version of the list. It is incremented every time the list is modified,
+         * so it can be used to detect changes (e.g. in monitors).
+         */
+        inline unsigned int version() const { return m_version; }
+
+        /*!
+         * Returns a pointer to the version of the list.
+         * \note This is used internally by compiled code to bump the version after modifying the list.
+         */
+        inline unsigned int *versionPtr() { return &m_version; }
+
         /*! Returns true if the list is empty. */
         inline bool empty() const { return m_size == 0; }
 
@@ -93,6 +105,7 @@ class LIBSCRATCHCPP_EXPORT List : public Entity
             // Keep at least 200,000 items allocated if the list has more
             constexpr size_t limit = 200000;
             m_size = 0;
+            m_version++;
 
             if (m_dataPtr->size() > limit)
                 reserve(limit);
@@ -102,6 +115,7 @@ class LIBSCRATCHCPP_EXPORT List : public Entity
         inline ValueData &appendEmpty()
         {
             m_size++;
+            m_version++;
             reserve(getAllocSize(m_size));
             return m_dataPtr->operator[](m_size - 1);
         }
@@ -118,6 +132,7 @@ class LIBSCRATCHCPP_EXPORT List : public Entity
             assert(index >= 0 && index < size());
             std::rotate(m_dataPtr->begin() + index, m_dataPtr->begin() + index + 1, m_dataPtr->begin() + m_size);
             m_size--;
+            m_version++;
         }
 
         /*! Inserts an empty item at index and returns the reference to it. Can be used for custom initialization. */
@@ -125,6 +140,7 @@ class LIBSCRATCHCPP_EXPORT List : public Entity
         {
             assert(index >= 0 && index <= size());
             m_size++;
+            m_version++;
             reserve(getAllocSize(m_size));
             std::rotate(m_dataPtr->rbegin() + m_dataPtr->size() - m_size, m_dataPtr->rbegin() + m_dataPtr->size() - m_size + 1, m_dataPtr->rend() - index);
             return m_dataPtr->operator[](index);
@@ -141,6 +157,7 @@ class LIBSCRATCHCPP_EXPORT List : public Entity
         {
             assert(index >= 0 && index < size());
             value_assign_copy(&m_dataPtr->operator[](index), &value);
+            m_version++;
         }
 
         /*! Replaces the item at index. */
@@ -276,6 +293,7 @@ class LIBSCRATCHCPP_EXPORT List : public Entity
         veque::veque<ValueData> *m_dataPtr = nullptr; // NOTE: accessing through pointer is faster! (from benchmarks)
         ValueData *m_rawDataPtr = nullptr;
         size_t m_size = 0;
+        unsigned int m_version = 0;
 };
 
 } // namespace libscratchcpp
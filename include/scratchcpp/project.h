@@ -38,9 +38,13 @@ class LIBSCRATCHCPP_EXPORT Project
         const std::string &fileName() const;
         void setFileName(const std::string &newFileName);
 
+        bool lazyAssetLoading() const;
+        void setLazyAssetLoading(bool lazy);
+
         std::shared_ptr<IEngine> engine() const;
 
         sigslot::signal<unsigned int, unsigned int> &downloadProgressChanged();
+        sigslot::signal<unsigned int, unsigned int> &assetLoadProgressChanged();
 
     private:
         spimpl::unique_impl_ptr<ProjectPrivate> impl;
@@ -41,6 +41,15 @@ class LIBSCRATCHCPP_EXPORT ScratchConfiguration
         static void removeGraphicsEffect(const std::string &name);
         static IGraphicsEffect *getGraphicsEffect(const std::string &name);
 
+        static size_t assetMemoryBudget();
+        static void setAssetMemoryBudget(size_t bytes);
+
+        static size_t audioMemoryBudget();
+        static void setAudioMemoryBudget(size_t bytes);
+
+        static bool offlineAudio();
+        static void setOfflineAudio(bool enabled);
+
         static const std::string &version();
         static int majorVersion();
         static int minorVersion();
@@ -24,7 +24,7 @@ class LIBSCRATCHCPP_EXPORT Sound : public Asset
 
         Sound(const std::string &name, const std::string &id, const std::string &format);
         Sound(const Sound &) = delete;
-        virtual ~Sound() { }
+        virtual ~Sound();
 
         int rate() const;
         void setRate(int newRate);
@@ -49,6 +49,10 @@ class LIBSCRATCHCPP_EXPORT Sound : public Asset
         virtual bool isClone() const override;
 
     private:
+        Sound(const std::string &name, const std::string &id, const std::string &format, const Sound *cloneRoot);
+
+        void acquireVoice();
+        void releaseVoice();
         void stopCloneSounds();
 
         spimpl::unique_impl_ptr<SoundPrivate> impl;
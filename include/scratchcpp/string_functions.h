@@ -14,6 +14,8 @@ extern "C"
     LIBSCRATCHCPP_EXPORT void string_assign(StringPtr *str, const StringPtr *another);
     LIBSCRATCHCPP_EXPORT void string_assign_cstring(StringPtr *str, const char *another);
 
+    LIBSCRATCHCPP_EXPORT void string_append(StringPtr *str, const StringPtr *another);
+
     LIBSCRATCHCPP_EXPORT int string_compare_raw_case_sensitive(const char16_t *str1, size_t n1, const char16_t *str2, size_t n2);
     LIBSCRATCHCPP_EXPORT int string_compare_case_sensitive(const StringPtr *str1, const StringPtr *str2);
 
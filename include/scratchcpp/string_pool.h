@@ -13,6 +13,13 @@ extern "C"
 {
     LIBSCRATCHCPP_EXPORT StringPtr *string_pool_new();
     LIBSCRATCHCPP_EXPORT void string_pool_free(StringPtr *str);
+
+    LIBSCRATCHCPP_EXPORT void string_pool_trim();
+
+    LIBSCRATCHCPP_EXPORT size_t string_pool_live_count();
+    LIBSCRATCHCPP_EXPORT size_t string_pool_live_bytes();
+    LIBSCRATCHCPP_EXPORT size_t string_pool_free_count();
+    LIBSCRATCHCPP_EXPORT size_t string_pool_free_bytes();
 }
 
 } // namespace libscratchcpp
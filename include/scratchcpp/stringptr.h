@@ -9,24 +9,43 @@ namespace libscratchcpp
 
 extern "C"
 {
-    /*! \brief The StringPtr struct holds a string data pointer and string size */
+    /*!
+     * \brief The StringPtr struct holds a string data pointer and string size
+     *
+     * Short strings (up to INLINE_CAPACITY - 1 characters) are stored in inlineData, in which case data points to inlineData.
+     * The number the string represents is cached in numberValue when it's converted to a number, see numberState.
+     * \note StringPtr must not be moved in memory (e. g. with memcpy()) because data may point into the struct.
+     */
     struct LIBSCRATCHCPP_EXPORT StringPtr
     {
+            static constexpr size_t INLINE_CAPACITY = 12; // including the null terminator
+
+            enum class NumberState : int
+            {
+                Unknown = 0, // not converted since the last change
+                Valid,       // numberValue holds a valid number
+                Invalid      // not a valid number, numberValue holds the conversion result (0)
+            };
+
             // NOTE: Constructors and destructors only work in C++ code and are not supposed to be used in LLVM IR
             StringPtr() = default;
             StringPtr(const std::string &str);
             StringPtr(const StringPtr &) = delete;
 
-            ~StringPtr()
-            {
-                if (data && allocatedSize > 0)
-                    free(data);
-            }
+            ~StringPtr();
+
+            /*! Returns true if the characters are stored in inlineData. */
+            bool isInline() const { return data == inlineData; }
 
             // NOTE: Any changes must also be done in the LLVM code builder!
             char16_t *data = nullptr;
             size_t size = 0;
             size_t allocatedSize = 0;
+            char16_t inlineData[INLINE_CAPACITY];
+
+            // Set by value_stringToDouble(), reset by string_alloc()
+            mutable double numberValue = 0;
+            mutable NumberState numberState = NumberState::Unknown;
     };
 }
 
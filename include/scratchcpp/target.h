@@ -46,6 +46,7 @@ class LIBSCRATCHCPP_EXPORT Target : public Drawable
         int findVariableById(const std::string &id) const;
 
         ValueData **variableData();
+        unsigned int **variableVersionData();
 
         const std::vector<std::shared_ptr<List>> &lists() const;
         int addList(std::shared_ptr<List> list);
@@ -94,12 +95,17 @@ class LIBSCRATCHCPP_EXPORT Target : public Drawable
         virtual Rect boundingRect() const;
         virtual Rect fastBoundingRect() const;
 
+        unsigned int renderVersion() const;
+
         bool touchingSprite(Sprite *sprite) const;
         virtual bool touchingPoint(double x, double y) const;
         bool touchingEdge() const;
         virtual bool touchingColor(Rgb color) const;
         virtual bool touchingColor(Rgb color, Rgb mask) const;
 
+        unsigned long collisionCacheHits() const;
+        unsigned long collisionCacheMisses() const;
+
         double graphicsEffectValue(IGraphicsEffect *effect) const;
         virtual void setGraphicsEffectValue(IGraphicsEffect *effect, double value);
 
@@ -117,6 +123,11 @@ class LIBSCRATCHCPP_EXPORT Target : public Drawable
         /*! Override this method to check whether the target touches the given sprite clones. */
         virtual bool touchingClones(const std::vector<Sprite *> &clones) const { return false; }
 
+        void invalidateRenderState();
+
+        bool findCachedTouchingColor(Rgb color, Rgb mask, bool masked, bool &result) const;
+        void cacheTouchingColor(Rgb color, Rgb mask, bool masked, bool result) const;
+
     private:
         spimpl::unique_impl_ptr<TargetPrivate> impl;
 };
@@ -28,6 +28,9 @@ class LIBSCRATCHCPP_EXPORT Variable : public Entity
 
         void setValue(const Value &value);
 
+        unsigned int version() const;
+        unsigned int *versionPtr();
+
         bool isCloudVariable() const;
         void setIsCloudVariable(bool isCloudVariable);
 
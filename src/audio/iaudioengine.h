@@ -2,6 +2,8 @@
 
 #pragma once
 
+#include <cstddef>
+
 #include "test_export.h"
 
 namespace libscratchcpp
@@ -16,6 +18,18 @@ class LIBSCRATCHCPP_TEST_EXPORT IAudioEngine
 
         virtual float volume() const = 0;
         virtual void setVolume(float volume) = 0;
+
+        virtual size_t decodedMemoryBudget() const = 0;
+        virtual void setDecodedMemoryBudget(size_t bytes) = 0;
+        virtual size_t decodedMemoryUsage() const = 0;
+
+        virtual bool isOffline() const = 0;
+        virtual void setOffline(bool offline) = 0;
+
+        virtual unsigned int sampleRate() const = 0;
+        virtual unsigned int channelCount() const = 0;
+
+        virtual size_t render(float *buffer, size_t frameCount) = 0;
 };
 
 } // namespace libscratchcpp
@@ -11,6 +11,12 @@ class IAudioLoudness
         virtual ~IAudioLoudness() { }
 
         virtual int getLoudness() const = 0;
+
+        virtual unsigned int windowSize() const = 0;
+        virtual void setWindowSize(unsigned int size) = 0;
+
+        virtual unsigned int updateInterval() const = 0;
+        virtual void setUpdateInterval(unsigned int interval) = 0;
 };
 
 } // namespace libscratchcpp
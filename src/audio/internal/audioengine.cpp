@@ -1,9 +1,12 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include <iostream>
+#include <cassert>
+#include <algorithm>
 #include <miniaudio.h>
 
 #include "audioengine.h"
+#include "decodedaudiocache.h"
 
 using namespace libscratchcpp;
 
@@ -30,6 +33,19 @@ bool AudioEngine::initialized()
     return INSTANCE.m_initialized;
 }
 
+/*! Registers a sound which uses the miniaudio engine (see setOffline()). */
+void AudioEngine::addSound()
+{
+    INSTANCE.m_soundCount++;
+}
+
+/*! Unregisters a sound registered using addSound(). */
+void AudioEngine::removeSound()
+{
+    assert(INSTANCE.m_soundCount > 0);
+    INSTANCE.m_soundCount--;
+}
+
 float AudioEngine::volume() const
 {
     return m_volume;
@@ -43,28 +59,123 @@ void AudioEngine::setVolume(float volume)
         ma_engine_set_volume(m_engine, volume);
 }
 
+size_t AudioEngine::decodedMemoryBudget() const
+{
+    return DecodedAudioCache::instance().memoryBudget();
+}
+
+void AudioEngine::setDecodedMemoryBudget(size_t bytes)
+{
+    DecodedAudioCache::instance().setMemoryBudget(bytes);
+}
+
+size_t AudioEngine::decodedMemoryUsage() const
+{
+    return DecodedAudioCache::instance().memoryUsage();
+}
+
+bool AudioEngine::isOffline() const
+{
+    return m_offline;
+}
+
+/*!
+ * Enables or disables offline mixing. In offline mode, no audio device is used
+ * and the sounds only advance when render() is called.
+ * \note The mode can't be changed while any sound is loaded, so call this before loading projects.
+ */
+void AudioEngine::setOffline(bool offline)
+{
+    if (offline == m_offline)
+        return;
+
+    // The miniaudio engine is re-created with the new mode, so it mustn't be used by any sound
+    if (m_soundCount > 0) {
+        std::cerr << "Cannot change the audio mode while sounds are loaded." << std::endl;
+        return;
+    }
+
+    m_offline = offline;
+
+    // The engine will be initialized with the new mode on next use
+    uninit();
+}
+
+unsigned int AudioEngine::sampleRate() const
+{
+    if (m_initialized)
+        return ma_engine_get_sample_rate(m_engine);
+
+    return m_offline ? OFFLINE_SAMPLE_RATE : 0;
+}
+
+unsigned int AudioEngine::channelCount() const
+{
+    if (m_initialized)
+        return ma_engine_get_channels(m_engine);
+
+    return m_offline ? OFFLINE_CHANNEL_COUNT : 0;
+}
+
+/*! Mixes the given number of frames (interleaved samples) in offline mode and returns the number of mixed frames. */
+size_t AudioEngine::render(float *buffer, size_t frameCount)
+{
+    if (!m_offline || !initialized())
+        return 0;
+
+    ma_uint64 framesRead = 0;
+
+    if (ma_engine_read_pcm_frames(m_engine, buffer, frameCount, &framesRead) != MA_SUCCESS)
+        return 0;
+
+    // The node graph doesn't output anything if no sound is attached, but the time passes anyway
+    const unsigned int channels = ma_engine_get_channels(m_engine);
+    std::fill(buffer + framesRead * channels, buffer + frameCount * channels, 0.0f);
+
+    return frameCount;
+}
+
 AudioEngine::AudioEngine()
 {
 }
 
 AudioEngine::~AudioEngine()
 {
-    if (m_initialized && m_engine) {
-        ma_engine_uninit(m_engine);
-        delete m_engine;
-    }
+    uninit();
 }
 
 void AudioEngine::init()
 {
     ma_result result;
     m_engine = new ma_engine;
-    result = ma_engine_init(NULL, m_engine);
+
+    if (m_offline) {
+        ma_engine_config config = ma_engine_config_init();
+        config.noDevice = MA_TRUE;
+        config.channels = OFFLINE_CHANNEL_COUNT;
+        config.sampleRate = OFFLINE_SAMPLE_RATE;
+        result = ma_engine_init(&config, m_engine);
+    } else
+        result = ma_engine_init(NULL, m_engine);
 
     if (result != MA_SUCCESS) {
         std::cerr << "Failed to initialize audio engine." << std::endl;
+        delete m_engine;
+        m_engine = nullptr;
         return;
     }
 
     m_initialized = true;
+    ma_engine_set_volume(m_engine, m_volume);
+}
+
+void AudioEngine::uninit()
+{
+    if (m_initialized && m_engine) {
+        ma_engine_uninit(m_engine);
+        delete m_engine;
+    }
+
+    m_engine = nullptr;
+    m_initialized = false;
 }
@@ -2,6 +2,8 @@
 
 #pragma once
 
+#include <atomic>
+
 #include "../iaudioengine.h"
 
 struct ma_engine;
@@ -21,14 +23,35 @@ class LIBSCRATCHCPP_TEST_EXPORT AudioEngine : public IAudioEngine
         static ma_engine *engine();
         static bool initialized();
 
+        static void addSound();
+        static void removeSound();
+
         float volume() const override;
         void setVolume(float volume) override;
 
+        size_t decodedMemoryBudget() const override;
+        void setDecodedMemoryBudget(size_t bytes) override;
+        size_t decodedMemoryUsage() const override;
+
+        bool isOffline() const override;
+        void setOffline(bool offline) override;
+
+        unsigned int sampleRate() const override;
+        unsigned int channelCount() const override;
+
+        size_t render(float *buffer, size_t frameCount) override;
+
+        static constexpr unsigned int OFFLINE_SAMPLE_RATE = 48000;
+        static constexpr unsigned int OFFLINE_CHANNEL_COUNT = 2;
+
     private:
         void init();
+        void uninit();
 
         ma_engine *m_engine = nullptr;
         bool m_initialized = false;
+        std::atomic<unsigned int> m_soundCount = 0; // sounds which use the miniaudio engine
+        bool m_offline = false; // mix without a device (see render())
         float m_volume = 1.0f;
 };
 
@@ -1,5 +1,7 @@
 // SPDX-License-Identifier: Apache-2.0
 
+#include <algorithm>
+
 #include "audioenginestub.h"
 
 using namespace libscratchcpp;
@@ -24,3 +26,48 @@ void AudioEngineStub::setVolume(float volume)
 {
     m_volume = volume;
 }
+
+size_t AudioEngineStub::decodedMemoryBudget() const
+{
+    return m_decodedMemoryBudget;
+}
+
+void AudioEngineStub::setDecodedMemoryBudget(size_t bytes)
+{
+    m_decodedMemoryBudget = bytes;
+}
+
+size_t AudioEngineStub::decodedMemoryUsage() const
+{
+    return 0;
+}
+
+bool AudioEngineStub::isOffline() const
+{
+    return m_offline;
+}
+
+void AudioEngineStub::setOffline(bool offline)
+{
+    m_offline = offline;
+}
+
+unsigned int AudioEngineStub::sampleRate() const
+{
+    return m_offline ? OFFLINE_SAMPLE_RATE : 0;
+}
+
+unsigned int AudioEngineStub::channelCount() const
+{
+    return m_offline ? OFFLINE_CHANNEL_COUNT : 0;
+}
+
+size_t AudioEngineStub::render(float *buffer, size_t frameCount)
+{
+    if (!m_offline)
+        return 0;
+
+    // There's no audio support, render silence
+    std::fill(buffer, buffer + frameCount * OFFLINE_CHANNEL_COUNT, 0.0f);
+    return frameCount;
+}
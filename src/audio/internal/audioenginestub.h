@@ -17,8 +17,25 @@ class LIBSCRATCHCPP_TEST_EXPORT AudioEngineStub : public IAudioEngine
         float volume() const override;
         void setVolume(float volume) override;
 
+        size_t decodedMemoryBudget() const override;
+        void setDecodedMemoryBudget(size_t bytes) override;
+        size_t decodedMemoryUsage() const override;
+
+        bool isOffline() const override;
+        void setOffline(bool offline) override;
+
+        unsigned int sampleRate() const override;
+        unsigned int channelCount() const override;
+
+        size_t render(float *buffer, size_t frameCount) override;
+
+        static constexpr unsigned int OFFLINE_SAMPLE_RATE = 48000;
+        static constexpr unsigned int OFFLINE_CHANNEL_COUNT = 2;
+
     private:
         float m_volume = 1.0f;
+        size_t m_decodedMemoryBudget = 64 * 1024 * 1024;
+        bool m_offline = false;
 };
 
 } // namespace libscratchcpp
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "../iaudioloudness.h"
+#include "loudnessmeter.h"
 #include "test_export.h"
 
 struct ma_device;
@@ -18,8 +19,17 @@ class LIBSCRATCHCPP_TEST_EXPORT AudioLoudness : public IAudioLoudness
 
         int getLoudness() const override;
 
+        unsigned int windowSize() const override;
+        void setWindowSize(unsigned int size) override;
+
+        unsigned int updateInterval() const override;
+        void setUpdateInterval(unsigned int interval) override;
+
     private:
+        static void dataCallback(ma_device *device, void *output, const void *input, unsigned int frameCount);
+
         ma_device *m_device = nullptr;
+        LoudnessMeter m_meter;
 };
 
 } // namespace libscratchcpp
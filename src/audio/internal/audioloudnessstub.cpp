@@ -12,3 +12,23 @@ int AudioLoudnessStub::getLoudness() const
 {
     return -1;
 }
+
+unsigned int AudioLoudnessStub::windowSize() const
+{
+    return m_windowSize;
+}
+
+void AudioLoudnessStub::setWindowSize(unsigned int size)
+{
+    m_windowSize = size;
+}
+
+unsigned int AudioLoudnessStub::updateInterval() const
+{
+    return m_updateInterval;
+}
+
+void AudioLoudnessStub::setUpdateInterval(unsigned int interval)
+{
+    m_updateInterval = interval;
+}
@@ -14,6 +14,16 @@ class LIBSCRATCHCPP_TEST_EXPORT AudioLoudnessStub : public IAudioLoudness
         AudioLoudnessStub();
 
         int getLoudness() const override;
+
+        unsigned int windowSize() const override;
+        void setWindowSize(unsigned int size) override;
+
+        unsigned int updateInterval() const override;
+        void setUpdateInterval(unsigned int interval) override;
+
+    private:
+        unsigned int m_windowSize = 1024;
+        unsigned int m_updateInterval = 512;
 };
 
 } // namespace libscratchcpp
@@ -6,41 +6,67 @@
 
 #include "audioplayer.h"
 #include "audioengine.h"
+#include "decodedaudiocache.h"
 
 using namespace libscratchcpp;
 
+static const ma_uint32 CHANNELS = 2;
+
+struct AudioPlayer::BufferRef
+{
+        ma_audio_buffer_ref ref;
+};
+
 AudioPlayer::AudioPlayer()
 {
     m_decoder = new ma_decoder;
     m_sound = new ma_sound;
+    m_buffer = new BufferRef;
 }
 
 AudioPlayer::~AudioPlayer()
 {
-    if (m_loaded) {
-        ma_sound_uninit(m_sound);
+    // Unregister first so that the cache can't release the data while the player is being destroyed
+    if (!m_copy)
+        DecodedAudioCache::instance().remove(this);
+
+    uninitSound();
+
+    if (m_pcm) {
+        ma_audio_buffer_ref_uninit(&m_buffer->ref);
 
         if (!m_copy)
-            ma_decoder_uninit(m_decoder);
+            ma_free(m_pcm, NULL);
     }
 
+    if (m_loaded && !m_copy)
+        ma_decoder_uninit(m_decoder);
+
+    if (m_root)
+        m_root->m_copyCount--;
+
     delete m_sound;
+    delete m_buffer;
 
     if (!m_copy)
         delete m_decoder;
 }
 
+/*!
+ * Loads the sound from the given encoded data (the data must stay valid while the player exists).
+ * Short sounds are decoded to PCM while the memory budget allows it, long sounds are streamed (decoded while playing).
+ */
 bool AudioPlayer::load(unsigned int size, const void *data, unsigned long sampleRate)
 {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
     if (!AudioEngine::initialized() || m_loaded)
         return false;
 
-    ma_engine *engine = AudioEngine::engine();
-
     if (!data || size == 0)
         return false;
 
-    ma_decoder_config config = ma_decoder_config_init(ma_format_f32, 2, sampleRate);
+    ma_decoder_config config = ma_decoder_config_init(ma_format_f32, CHANNELS, sampleRate);
     ma_result result = ma_decoder_init_memory(data, size, &config, m_decoder);
 
     if (result != MA_SUCCESS) {
@@ -48,43 +74,79 @@ bool AudioPlayer::load(unsigned int size, const void *data, unsigned long sample
         return false;
     }
 
-    ma_result initResult = ma_sound_init_from_data_source(engine, m_decoder, MA_SOUND_FLAG_DECODE, NULL, m_sound);
+    m_loaded = true;
+    m_data = data;
+    m_size = size;
+    m_sampleRate = sampleRate;
 
-    if (initResult != MA_SUCCESS) {
-        std::cerr << "Failed to init sound." << std::endl;
-        ma_decoder_uninit(m_decoder);
-        return false;
+    // The length of some formats (e.g. MP3) can't be determined without decoding the whole sound
+    ma_uint64 length = 0;
+
+    if (ma_decoder_get_length_in_pcm_frames(m_decoder, &length) != MA_SUCCESS)
+        length = 0;
+
+    m_frameCount = length;
+    m_streamed = (length == 0 || length > MAX_DECODED_LENGTH * m_decoder->outputSampleRate ||
+                  !DecodedAudioCache::instance().fits(length * CHANNELS * sizeof(float)));
+
+    if (m_streamed || !decode(this)) {
+        m_streamed = true;
+
+        if (!initSound(m_decoder)) {
+            ma_decoder_uninit(m_decoder);
+            m_loaded = false;
+            return false;
+        }
     }
 
-    m_loaded = true;
-    ma_sound_set_volume(m_sound, m_volume);
-    ma_sound_set_pitch(m_sound, m_pitch);
-    ma_sound_set_pan(m_sound, m_pan);
     return true;
 }
 
+/*!
+ * Loads a copy of the given player.
+ * Decoded sounds get their own read cursor over the PCM data of the original player, streamed sounds share its decoder.
+ * \note The original player must exist while the copy exists.
+ */
 bool AudioPlayer::loadCopy(IAudioPlayer *player)
 {
     assert(player && dynamic_cast<AudioPlayer *>(player));
+    std::lock_guard<std::mutex> lock(m_mutex);
 
     if (!AudioEngine::initialized() || !player || !player->isLoaded())
         return false;
 
-    ma_engine *engine = AudioEngine::engine();
-
     AudioPlayer *playerPtr = static_cast<AudioPlayer *>(player);
-    ma_result initResult = ma_sound_init_from_data_source(engine, playerPtr->m_decoder, MA_SOUND_FLAG_DECODE, NULL, m_sound);
 
-    if (initResult != MA_SUCCESS) {
+    // Copies of copies refer to the original player
+    if (playerPtr->m_root)
+        playerPtr = playerPtr->m_root;
+
+    // The data of the original player can't be released while it has copies
+    std::lock_guard<std::mutex> rootLock(playerPtr->m_mutex);
+
+    delete m_decoder;
+    m_decoder = playerPtr->m_decoder;
+    m_copy = true;
+    m_root = playerPtr;
+    m_root->m_copyCount++;
+    m_streamed = playerPtr->m_streamed;
+
+    if (!playerPtr->m_pcm && !playerPtr->m_streamed)
+        playerPtr->decode(playerPtr);
+
+    bool ret;
+
+    if (playerPtr->m_pcm)
+        ret = decode(playerPtr);
+    else
+        ret = initSound(m_decoder);
+
+    if (!ret) {
         std::cerr << "Failed to init sound copy." << std::endl;
         return false;
     }
 
     m_loaded = true;
-    m_copy = true;
-    ma_sound_set_volume(m_sound, m_volume);
-    ma_sound_set_pitch(m_sound, m_pitch);
-    ma_sound_set_pan(m_sound, m_pan);
     return true;
 }
 
@@ -95,9 +157,10 @@ float AudioPlayer::volume() const
 
 void AudioPlayer::setVolume(float volume)
 {
+    std::lock_guard<std::mutex> lock(m_mutex);
     m_volume = volume;
 
-    if (!m_loaded)
+    if (!m_soundInitialized)
         return;
 
     ma_sound_set_volume(m_sound, volume);
@@ -117,9 +180,10 @@ void AudioPlayer::setPitch(float pitch)
      * 4 -> 1760 Hz
      * ...
      */
+    std::lock_guard<std::mutex> lock(m_mutex);
     m_pitch = pitch;
 
-    if (!m_loaded)
+    if (!m_soundInitialized)
         return;
 
     ma_sound_set_pitch(m_sound, pitch);
@@ -133,9 +197,10 @@ float AudioPlayer::pan() const
 void AudioPlayer::setPan(float pan)
 {
     // -1 ... 0 ... 1
+    std::lock_guard<std::mutex> lock(m_mutex);
     m_pan = pan;
 
-    if (!m_loaded)
+    if (!m_soundInitialized)
         return;
 
     ma_sound_set_pan(m_sound, pan);
@@ -148,11 +213,24 @@ bool AudioPlayer::isLoaded() const
 
 void AudioPlayer::start()
 {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
     if (!m_loaded)
         return;
 
-    if (isPlaying())
-        stop();
+    // Decode the sound again if its PCM data has been released
+    if (!m_soundInitialized && !decode(this) && !initSound(m_decoder))
+        return;
+
+    if (m_pcm && !m_copy)
+        DecodedAudioCache::instance().touch(this);
+    else if (m_root)
+        DecodedAudioCache::instance().touch(m_root);
+
+    if (playing()) {
+        if (ma_sound_stop(m_sound) != MA_SUCCESS)
+            std::cerr << "Failed to stop sound." << std::endl;
+    }
 
     ma_result result = ma_sound_seek_to_pcm_frame(m_sound, 0);
 
@@ -172,7 +250,9 @@ void AudioPlayer::start()
 
 void AudioPlayer::stop()
 {
-    if (!m_loaded)
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (!m_soundInitialized)
         return;
 
     ma_result result = ma_sound_stop(m_sound);
@@ -184,8 +264,131 @@ void AudioPlayer::stop()
 
 bool AudioPlayer::isPlaying() const
 {
-    if (!m_loaded)
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return playing();
+}
+
+/*! Returns true if the sound is decoded while playing. */
+bool AudioPlayer::isStreamed() const
+{
+    return m_loaded && m_streamed;
+}
+
+/*! Returns true if the decoded PCM data of the sound is in memory. */
+bool AudioPlayer::isDecoded() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_pcm;
+}
+
+bool AudioPlayer::initSound(void *dataSource)
+{
+    uninitSound();
+    ma_result result = ma_sound_init_from_data_source(AudioEngine::engine(), dataSource, 0, NULL, m_sound);
+
+    if (result != MA_SUCCESS) {
+        std::cerr << "Failed to init sound." << std::endl;
+        return false;
+    }
+
+    m_soundInitialized = true;
+    AudioEngine::addSound();
+    ma_sound_set_volume(m_sound, m_volume);
+    ma_sound_set_pitch(m_sound, m_pitch);
+    ma_sound_set_pan(m_sound, m_pan);
+    return true;
+}
+
+void AudioPlayer::uninitSound()
+{
+    if (!m_soundInitialized)
+        return;
+
+    ma_sound_uninit(m_sound);
+    m_soundInitialized = false;
+    AudioEngine::removeSound();
+}
+
+bool AudioPlayer::decode(AudioPlayer *source)
+{
+    if (m_streamed)
+        return false;
+
+    if (source == this && !m_pcm) {
+        ma_decoder_config config = ma_decoder_config_init(ma_format_f32, CHANNELS, m_sampleRate);
+        ma_uint64 frameCount;
+        void *pcm;
+
+        if (ma_decode_memory(m_data, m_size, &config, &frameCount, &pcm) != MA_SUCCESS) {
+            std::cerr << "Failed to decode sound." << std::endl;
+            return false;
+        }
+
+        m_pcm = pcm;
+        m_frameCount = frameCount;
+    }
+
+    if (!source->m_pcm)
+        return false;
+
+    // Registers the PCM data in the cache once the player is ready to use it (this can release the data of other players)
+    auto registerDecoded = [this, source]() {
+        if (source == this)
+            DecodedAudioCache::instance().add(this, m_frameCount * CHANNELS * sizeof(float));
+    };
+
+    // Frees the PCM data if it can't be used
+    auto freeDecoded = [this, source]() {
+        if (source == this)
+            ma_free(m_pcm, NULL);
+
+        m_pcm = nullptr;
+    };
+
+    // Copies read the PCM data of the original player with their own cursor
+    if (source != this)
+        m_pcm = source->m_pcm;
+
+    if (ma_audio_buffer_ref_init(ma_format_f32, CHANNELS, source->m_pcm, source->m_frameCount, &m_buffer->ref) != MA_SUCCESS) {
+        std::cerr << "Failed to init audio buffer." << std::endl;
+        freeDecoded();
+        return false;
+    }
+
+    if (!initSound(&m_buffer->ref)) {
+        ma_audio_buffer_ref_uninit(&m_buffer->ref);
+        freeDecoded();
+        return false;
+    }
+
+    registerDecoded();
+    return true;
+}
+
+bool AudioPlayer::playing() const
+{
+    if (!m_soundInitialized)
         return false;
 
     return m_started && !m_sound->atEnd;
 }
+
+bool AudioPlayer::tryReleaseDecoded()
+{
+    // Called by DecodedAudioCache (possibly from another thread) when the memory budget is exceeded
+    // Players which are being loaded or used right now are skipped, as well as sounds which are playing or used by copies
+    std::unique_lock<std::mutex> lock(m_mutex, std::try_to_lock);
+
+    if (!lock.owns_lock() || m_copy || m_copyCount > 0 || !m_pcm || playing())
+        return false;
+
+    uninitSound();
+
+    if (m_pcm) {
+        ma_audio_buffer_ref_uninit(&m_buffer->ref);
+        ma_free(m_pcm, NULL);
+        m_pcm = nullptr;
+    }
+
+    return true;
+}
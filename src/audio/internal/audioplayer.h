@@ -2,6 +2,9 @@
 
 #pragma once
 
+#include <mutex>
+#include <atomic>
+
 #include "../iaudioplayer.h"
 #include "test_export.h"
 
@@ -36,10 +39,36 @@ class LIBSCRATCHCPP_TEST_EXPORT AudioPlayer : public IAudioPlayer
 
         bool isPlaying() const override;
 
+        bool isStreamed() const;
+        bool isDecoded() const;
+
+        static constexpr double MAX_DECODED_LENGTH = 10; // longer sounds are streamed (in seconds)
+
     private:
+        friend class DecodedAudioCache;
+
+        struct BufferRef;
+
+        bool initSound(void *dataSource);
+        void uninitSound();
+        bool decode(AudioPlayer *source);
+        bool playing() const;
+        bool tryReleaseDecoded();
+
         ma_decoder *m_decoder = nullptr;
         ma_sound *m_sound;
+        BufferRef *m_buffer = nullptr;
+        const void *m_data = nullptr; // encoded data
+        unsigned int m_size = 0;
+        unsigned long m_sampleRate = 0;
+        void *m_pcm = nullptr; // decoded PCM frames (owned by the original player)
+        unsigned long long m_frameCount = 0;
+        AudioPlayer *m_root = nullptr; // the original player of a copy
+        std::atomic<int> m_copyCount = 0;
+        mutable std::mutex m_mutex; // the PCM data can be released by DecodedAudioCache from other threads
         bool m_loaded = false;
+        bool m_soundInitialized = false;
+        bool m_streamed = false;
         bool m_copy = false;
         bool m_started = false;
         float m_volume = 1;
@@ -0,0 +1,101 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "decodedaudiocache.h"
+#include "audioplayer.h"
+
+using namespace libscratchcpp;
+
+DecodedAudioCache &DecodedAudioCache::instance()
+{
+    static DecodedAudioCache cache;
+    return cache;
+}
+
+/*! Returns the maximum size of decoded PCM data in bytes (0 means no limit). */
+size_t DecodedAudioCache::memoryBudget() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_budget;
+}
+
+/*! Sets the maximum size of decoded PCM data in bytes (0 means no limit). */
+void DecodedAudioCache::setMemoryBudget(size_t budget)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_budget = budget;
+    evict(nullptr);
+}
+
+/*! Returns the size of the currently decoded PCM data in bytes. */
+size_t DecodedAudioCache::memoryUsage() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_usage;
+}
+
+/*! Returns true if PCM data of the given size can be held at all (it's not larger than the whole budget). */
+bool DecodedAudioCache::fits(size_t size) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_budget == 0 || size <= m_budget;
+}
+
+/*! Registers the decoded data of the given player and releases the data of other players if the budget is exceeded. */
+void DecodedAudioCache::add(AudioPlayer *player, size_t size)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_index.find(player);
+
+    if (it != m_index.cend()) {
+        m_usage -= it->second->size;
+        m_entries.erase(it->second);
+    }
+
+    m_entries.push_front({ player, size });
+    m_index[player] = m_entries.begin();
+    m_usage += size;
+    evict(player);
+}
+
+/*! Marks the decoded data of the given player as recently used. */
+void DecodedAudioCache::touch(AudioPlayer *player)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_index.find(player);
+
+    if (it != m_index.cend())
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+}
+
+/*! Stops tracking the decoded data of the given player (call this when the data is released). */
+void DecodedAudioCache::remove(AudioPlayer *player)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_index.find(player);
+
+    if (it != m_index.cend()) {
+        m_usage -= it->second->size;
+        m_entries.erase(it->second);
+        m_index.erase(it);
+    }
+}
+
+void DecodedAudioCache::evict(AudioPlayer *keep)
+{
+    if (m_budget == 0)
+        return;
+
+    // Release the least recently used data (players which are busy, playing or used by copies are skipped)
+    auto it = m_entries.end();
+
+    while (m_usage > m_budget && it != m_entries.begin()) {
+        --it;
+
+        if (it->player == keep || !it->player->tryReleaseDecoded())
+            continue;
+
+        m_usage -= it->size;
+        m_index.erase(it->player);
+        it = m_entries.erase(it);
+    }
+}
@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <list>
+#include <unordered_map>
+#include <mutex>
+
+#include "test_export.h"
+
+namespace libscratchcpp
+{
+
+class AudioPlayer;
+
+/*! The DecodedAudioCache class tracks the decoded PCM data of audio players and releases the least recently used data when the memory budget is exceeded. */
+class LIBSCRATCHCPP_TEST_EXPORT DecodedAudioCache
+{
+    public:
+        DecodedAudioCache() = default;
+        DecodedAudioCache(const DecodedAudioCache &) = delete;
+
+        static DecodedAudioCache &instance();
+
+        size_t memoryBudget() const;
+        void setMemoryBudget(size_t budget);
+
+        size_t memoryUsage() const;
+        bool fits(size_t size) const;
+
+        void add(AudioPlayer *player, size_t size);
+        void touch(AudioPlayer *player);
+        void remove(AudioPlayer *player);
+
+    private:
+        struct Entry
+        {
+                AudioPlayer *player;
+                size_t size;
+        };
+
+        void evict(AudioPlayer *keep);
+
+        mutable std::mutex m_mutex;
+        size_t m_budget = 64 * 1024 * 1024; // 0 means no limit
+        size_t m_usage = 0;
+        std::list<Entry> m_entries; // most recently used first
+        std::unordered_map<AudioPlayer *, std::list<Entry>::iterator> m_index;
+};
+
+} // namespace libscratchcpp
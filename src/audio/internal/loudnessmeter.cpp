@@ -0,0 +1,131 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include <algorithm>
+#include <cmath>
+
+#include "loudnessmeter.h"
+
+using namespace libscratchcpp;
+
+/*! Constructs LoudnessMeter. */
+LoudnessMeter::LoudnessMeter(unsigned int windowSize, unsigned int updateInterval) :
+    m_windowSize(std::max(windowSize, 1u)),
+    m_updateInterval(std::max(updateInterval, 1u))
+{
+}
+
+/*! Returns the number of last samples the loudness is computed from. */
+unsigned int LoudnessMeter::windowSize() const
+{
+    return m_windowSize;
+}
+
+/*! Sets the number of last samples the loudness is computed from. */
+void LoudnessMeter::setWindowSize(unsigned int size)
+{
+    m_windowSize = std::max(size, 1u);
+}
+
+/*! Returns the number of samples after which the loudness is updated. */
+unsigned int LoudnessMeter::updateInterval() const
+{
+    return m_updateInterval;
+}
+
+/*! Sets the number of samples after which the loudness is updated. */
+void LoudnessMeter::setUpdateInterval(unsigned int interval)
+{
+    m_updateInterval = std::max(interval, 1u);
+}
+
+/*! Adds captured (mono) samples. This must always be called from the same thread. */
+void LoudnessMeter::process(const float *samples, size_t count)
+{
+    const unsigned int windowSize = m_windowSize;
+    const unsigned int updateInterval = m_updateInterval;
+
+    if (m_window.size() != windowSize) {
+        m_window.assign(windowSize, 0.0f);
+        m_writePos = 0;
+        m_filled = 0;
+    }
+
+    // Scale the smoothing to the update rate, so that the loudness doesn't depend on the update interval
+    if (m_decayInterval != updateInterval) {
+        m_decay = std::pow(0.6f, static_cast<float>(updateInterval) / SMOOTHING_INTERVAL);
+        m_decayInterval = updateInterval;
+    }
+
+    while (count > 0) {
+        // Copy until the next update or the end of the ring buffer
+        size_t n = std::min({ count, windowSize - m_writePos, updateInterval - m_sinceUpdate });
+        std::copy(samples, samples + n, m_window.begin() + m_writePos);
+        samples += n;
+        count -= n;
+        m_writePos = (m_writePos + n) % windowSize;
+        m_filled = std::min<size_t>(m_filled + n, windowSize);
+        m_sinceUpdate += n;
+
+        if (m_sinceUpdate >= updateInterval) {
+            update();
+            m_sinceUpdate = 0;
+        }
+    }
+}
+
+/*! Returns the last computed loudness (0-100), or -1 if no samples have been processed yet. */
+int LoudnessMeter::loudness() const
+{
+    return m_loudness.load(std::memory_order_relaxed);
+}
+
+/*! Returns the sum of squares of the given samples. */
+float LoudnessMeter::sumOfSquares(const float *data, size_t count)
+{
+    // Use independent accumulators, so that the compiler can vectorize the loop
+    constexpr size_t lanes = 8;
+    float acc[lanes] = { 0.0f };
+    size_t i = 0;
+
+    for (; i + lanes <= count; i += lanes) {
+        for (size_t j = 0; j < lanes; j++)
+            acc[j] += data[i + j] * data[i + j];
+    }
+
+    float sum = 0.0f;
+
+    for (size_t j = 0; j < lanes; j++)
+        sum += acc[j];
+
+    for (; i < count; i++)
+        sum += data[i] * data[i];
+
+    return sum;
+}
+
+void LoudnessMeter::update()
+{
+    if (m_filled == 0)
+        return;
+
+    // https://github.com/scratchfoundation/scratch-audio/blob/068aca613604e39b2adbe785b17931cc43eec35f/src/Loudness.js#L36-L80
+    // Compute the RMS of the sound (the samples which haven't been written yet are zero)
+    float sum = sumOfSquares(m_window.data(), m_window.size()) / 20.0f; // TODO: Convert the value properly (it's different than in JS)
+    float rms = std::sqrt(sum / static_cast<float>(m_filled));
+
+    // Smooth the value, if it is descending
+    if (m_lastValue != 0.0f)
+        rms = std::max(rms, m_lastValue * m_decay);
+
+    m_lastValue = rms;
+
+    // Scale the measurement
+    rms *= 1.63f;
+    rms = std::sqrt(rms);
+    // Scale it up to 0-100 and round
+    rms = std::round(rms * 100.0f);
+    // Prevent it from going above 100
+    rms = std::min(rms, 100.0f);
+
+    m_loudness.store(rms, std::memory_order_relaxed);
+}
@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <cstddef>
+
+#include "test_export.h"
+
+namespace libscratchcpp
+{
+
+/*!
+ * The LoudnessMeter class computes the Scratch loudness of captured samples.
+ * Samples are processed on the capture thread and the latest loudness is published atomically,
+ * so it can be read from any thread without locking.
+ */
+class LIBSCRATCHCPP_TEST_EXPORT LoudnessMeter
+{
+    public:
+        // The descending loudness decays by 40 % per this number of samples (the capture period in Scratch 3)
+        static constexpr unsigned int SMOOTHING_INTERVAL = 2048;
+
+        LoudnessMeter(unsigned int windowSize = 1024, unsigned int updateInterval = 512);
+        LoudnessMeter(const LoudnessMeter &) = delete;
+
+        unsigned int windowSize() const;
+        void setWindowSize(unsigned int size);
+
+        unsigned int updateInterval() const;
+        void setUpdateInterval(unsigned int interval);
+
+        void process(const float *samples, size_t count);
+
+        int loudness() const;
+
+        static float sumOfSquares(const float *data, size_t count);
+
+    private:
+        void update();
+
+        // Configuration (written by any thread, applied on the capture thread)
+        std::atomic<unsigned int> m_windowSize;
+        std::atomic<unsigned int> m_updateInterval;
+
+        // Capture thread only
+        std::vector<float> m_window; // ring buffer of the last samples
+        size_t m_writePos = 0;
+        size_t m_filled = 0;
+        size_t m_sinceUpdate = 0;
+        float m_lastValue = 0.0f;
+        float m_decay = 0.6f; // smoothing factor per update
+        unsigned int m_decayInterval = SMOOTHING_INTERVAL;
+
+        std::atomic<int> m_loudness = -1;
+};
+
+} // namespace libscratchcpp
@@ -13,7 +13,6 @@
 #include <scratchcpp/sprite.h>
 #include <scratchcpp/stringptr.h>
 #include <scratchcpp/string_functions.h>
-#include <utf8.h>
 
 #include "controlblocks.h"
 
@@ -232,8 +231,7 @@ BLOCK_EXPORT void control_create_clone(ExecutionContext *ctx, const StringPtr *s
         control_create_clone_of_myself(ctx->thread()->target());
     else {
         IEngine *engine = ctx->engine();
-        // TODO: Use UTF-16 in engine
-        auto index = engine->findTarget(utf8::utf16to8(std::u16string(spriteName->data)));
+        auto index = engine->findTarget(spriteName);
         Target *target = engine->targetAt(index);
 
         if (!target->isStage())
@@ -13,7 +13,6 @@
 #include <scratchcpp/string_functions.h>
 #include <scratchcpp/sprite.h>
 #include <scratchcpp/itimer.h>
-#include <utf8.h>
 
 #include "eventblocks.h"
 #include "audio/audioinput.h"
@@ -147,21 +146,38 @@ CompilerValue *EventBlocks::compileWhenGreaterThanPredicate(Compiler *compiler)
 
 CompilerValue *EventBlocks::compileBroadcast(Compiler *compiler)
 {
-    auto input = compiler->addInput("BROADCAST_INPUT");
-    auto wait = compiler->addConstValue(false);
-    compiler->addFunctionCallWithCtx("event_broadcast", Compiler::StaticType::Void, { Compiler::StaticType::String, Compiler::StaticType::Bool }, { input, wait });
+    addBroadcastCall(compiler, false);
     return nullptr;
 }
 
 CompilerValue *EventBlocks::compileBroadcastAndWait(Compiler *compiler)
 {
-    auto input = compiler->addInput("BROADCAST_INPUT");
-    auto wait = compiler->addConstValue(true);
-    compiler->addFunctionCallWithCtx("event_broadcast", Compiler::StaticType::Void, { Compiler::StaticType::String, Compiler::StaticType::Bool }, { input, wait });
+    addBroadcastCall(compiler, true);
     compiler->createYield();
     return nullptr;
 }
 
+void EventBlocks::addBroadcastCall(Compiler *compiler, bool wait)
+{
+    auto input = compiler->addInput("BROADCAST_INPUT");
+    auto waitValue = compiler->addConstValue(wait);
+
+    if (CompilerConstant *constInput = dynamic_cast<CompilerConstant *>(input)) {
+        // Look up the broadcasts at compile time and bake their indices into the code
+        StringPtr name(constInput->value().toString());
+        const std::vector<int> broadcasts = compiler->engine()->findBroadcasts(&name);
+
+        for (int index : broadcasts) {
+            CompilerValue *arg = compiler->addConstValue(index);
+            compiler->addFunctionCallWithCtx("event_broadcast_by_index", Compiler::StaticType::Void, { Compiler::StaticType::Number, Compiler::StaticType::Bool }, { arg, waitValue });
+        }
+
+        if (wait)
+            compiler->addFunctionCallWithCtx("event_broadcast_wait");
+    } else
+        compiler->addFunctionCallWithCtx("event_broadcast", Compiler::StaticType::Void, { Compiler::StaticType::String, Compiler::StaticType::Bool }, { input, waitValue });
+}
+
 CompilerValue *EventBlocks::compileWhenKeyPressed(Compiler *compiler)
 {
     auto block = compiler->block();
@@ -195,9 +211,7 @@ BLOCK_EXPORT bool event_whentouchingobject_predicate(Target *target, const Strin
     else if (strings_equal_case_sensitive(name, &EDGE_STR))
         return target->touchingEdge();
     else {
-        // TODO: Use UTF-16 in engine
-        const std::string u8name = utf8::utf16to8(std::u16string(name->data));
-        Target *anotherTarget = engine->targetAt(engine->findTarget(u8name));
+        Target *anotherTarget = engine->targetAt(engine->findTarget(name));
 
         if (anotherTarget && !anotherTarget->isStage())
             return target->touchingSprite(static_cast<Sprite *>(anotherTarget));
@@ -220,12 +234,22 @@ BLOCK_EXPORT bool event_whengreaterthan_timer_predicate(ExecutionContext *ctx, d
     return ctx->engine()->timer()->value() > value;
 }
 
+BLOCK_EXPORT void event_broadcast_by_index(ExecutionContext *ctx, double index, bool wait)
+{
+    Thread *thread = ctx->thread();
+    thread->engine()->broadcast(index, thread, wait);
+}
+
+BLOCK_EXPORT void event_broadcast_wait(ExecutionContext *ctx)
+{
+    ctx->setPromise(std::make_shared<Promise>());
+}
+
 BLOCK_EXPORT void event_broadcast(ExecutionContext *ctx, const StringPtr *name, bool wait)
 {
     Thread *thread = ctx->thread();
     IEngine *engine = thread->engine();
-    // TODO: Use UTF-16 in engine
-    std::vector<int> broadcasts = engine->findBroadcasts(utf8::utf16to8(std::u16string(name->data)));
+    const std::vector<int> &broadcasts = engine->findBroadcasts(name);
 
     for (int index : broadcasts)
         engine->broadcast(index, thread, wait);
@@ -37,6 +37,8 @@ class LIBSCRATCHCPP_TEST_EXPORT EventBlocks : public IExtension
         static CompilerValue *compileBroadcastAndWait(Compiler *compiler);
         static CompilerValue *compileWhenKeyPressed(Compiler *compiler);
 
+        static void addBroadcastCall(Compiler *compiler, bool wait);
+
         static inline IAudioInput *m_audioInput = nullptr;
 };
 
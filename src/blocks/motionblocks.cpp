@@ -14,7 +14,6 @@
 #include <scratchcpp/stringptr.h>
 #include <scratchcpp/string_functions.h>
 #include <cmath>
-#include <utf8.h>
 
 #include "motionblocks.h"
 
@@ -422,10 +421,8 @@ BLOCK_EXPORT void motion_pointtowards(ExecutionContext *ctx, const StringPtr *to
     else if (strings_equal_case_sensitive(towards, &RANDOM_STR))
         motion_point_towards_random_direction(ctx);
     else {
-        // TODO: Use UTF-16 in engine
-        std::string u8name = utf8::utf16to8(std::u16string(towards->data));
         IEngine *engine = ctx->engine();
-        Target *anotherTarget = engine->targetAt(engine->findTarget(u8name));
+        Target *anotherTarget = engine->targetAt(engine->findTarget(towards));
 
         if (anotherTarget && !anotherTarget->isStage()) {
             Sprite *anotherSprite = static_cast<Sprite *>(anotherTarget);
@@ -472,10 +469,8 @@ BLOCK_EXPORT void motion_goto(ExecutionContext *ctx, const StringPtr *towards)
     else if (strings_equal_case_sensitive(towards, &RANDOM_STR))
         motion_go_to_random_pos(ctx);
     else {
-        // TODO: Use UTF-16 in engine
-        std::string u8name = utf8::utf16to8(std::u16string(towards->data));
         IEngine *engine = ctx->engine();
-        Target *anotherTarget = engine->targetAt(engine->findTarget(u8name));
+        Target *anotherTarget = engine->targetAt(engine->findTarget(towards));
 
         if (anotherTarget && !anotherTarget->isStage()) {
             Sprite *anotherSprite = static_cast<Sprite *>(anotherTarget);
@@ -557,10 +552,8 @@ BLOCK_EXPORT double motion_get_target_x(ExecutionContext *ctx, const StringPtr *
     else if (strings_equal_case_sensitive(name, &RANDOM_STR))
         return motion_get_random_x(ctx);
     else {
-        // TODO: Use UTF-16 in engine
-        std::string u8name = utf8::utf16to8(std::u16string(name->data));
         IEngine *engine = ctx->engine();
-        Target *target = engine->targetAt(engine->findTarget(u8name));
+        Target *target = engine->targetAt(engine->findTarget(name));
 
         if (target && !target->isStage()) {
             Sprite *sprite = static_cast<Sprite *>(target);
@@ -580,10 +573,8 @@ BLOCK_EXPORT double motion_get_target_y(ExecutionContext *ctx, const StringPtr *
     else if (strings_equal_case_sensitive(name, &RANDOM_STR))
         return motion_get_random_y(ctx);
     else {
-        // TODO: Use UTF-16 in engine
-        std::string u8name = utf8::utf16to8(std::u16string(name->data));
         IEngine *engine = ctx->engine();
-        Target *target = engine->targetAt(engine->findTarget(u8name));
+        Target *target = engine->targetAt(engine->findTarget(name));
 
         if (target && !target->isStage()) {
             Sprite *sprite = static_cast<Sprite *>(target);
@@ -601,10 +592,8 @@ BLOCK_EXPORT bool motion_is_target_valid(ExecutionContext *ctx, const StringPtr
     if (strings_equal_case_sensitive(name, &MOUSE_STR) || strings_equal_case_sensitive(name, &RANDOM_STR))
         return true;
     else {
-        // TODO: Use UTF-16 in engine
-        std::string u8name = utf8::utf16to8(std::u16string(name->data));
         IEngine *engine = ctx->engine();
-        Target *target = engine->targetAt(engine->findTarget(u8name));
+        Target *target = engine->targetAt(engine->findTarget(name));
         return (target && !target->isStage());
     }
 }
@@ -15,6 +15,7 @@
 #include <scratchcpp/textbubble.h>
 #include <scratchcpp/variable.h>
 #include <scratchcpp/stringptr.h>
+#include <scratchcpp/keyevent.h>
 #include <scratchcpp/string_functions.h>
 #include <scratchcpp/string_pool.h>
 #include <scratchcpp/itimer.h>
@@ -183,6 +184,17 @@ CompilerValue *SensingBlocks::compileAnswer(Compiler *compiler)
 CompilerValue *SensingBlocks::compileKeyPressed(Compiler *compiler)
 {
     CompilerValue *key = compiler->addInput("KEY_OPTION");
+
+    if (CompilerConstant *constKey = dynamic_cast<CompilerConstant *>(key)) {
+        // Resolve the key code at compile time ("any" is handled by the engine)
+        const std::string name = constKey->value().toString();
+
+        if (name != "any") {
+            CompilerValue *code = compiler->addConstValue(KeyEvent(name).code());
+            return compiler->addFunctionCallWithCtx("sensing_keypressed_by_code", Compiler::StaticType::Bool, { Compiler::StaticType::Number }, { code });
+        }
+    }
+
     return compiler->addFunctionCallWithCtx("sensing_keypressed", Compiler::StaticType::Bool, { Compiler::StaticType::String }, { key });
 }
 
@@ -479,9 +491,7 @@ BLOCK_EXPORT bool sensing_touchingobject(Target *target, const StringPtr *object
         return sensing_touching_edge(target);
     else if (!strings_equal_case_sensitive(object, &STAGE_STR)) {
         IEngine *engine = target->engine();
-        // TODO: Use UTF-16 in engine
-        std::string u8name = utf8::utf16to8(std::u16string(object->data));
-        Target *objTarget = engine->targetAt(engine->findTarget(u8name));
+        Target *objTarget = engine->targetAt(engine->findTarget(object));
 
         if (objTarget)
             return sensing_touching_sprite(target, static_cast<Sprite *>(objTarget));
@@ -525,9 +535,7 @@ BLOCK_EXPORT double sensing_distanceto(Sprite *sprite, const StringPtr *object)
         return sensing_distance_to_mouse(sprite);
     else if (!strings_equal_case_sensitive(object, &STAGE_STR)) {
         IEngine *engine = sprite->engine();
-        // TODO: Use UTF-16 in engine
-        std::string u8name = utf8::utf16to8(std::u16string(object->data));
-        Target *objTarget = engine->targetAt(engine->findTarget(u8name));
+        Target *objTarget = engine->targetAt(engine->findTarget(object));
 
         if (objTarget)
             return sensing_distance_to_sprite(sprite, static_cast<Sprite *>(objTarget));
@@ -554,6 +562,11 @@ BLOCK_EXPORT bool sensing_keypressed(ExecutionContext *ctx, const StringPtr *key
     return ctx->engine()->keyPressed(u8name);
 }
 
+BLOCK_EXPORT bool sensing_keypressed_by_code(ExecutionContext *ctx, double code)
+{
+    return ctx->engine()->keyPressed(static_cast<unsigned int>(code));
+}
+
 BLOCK_EXPORT bool sensing_mousedown(ExecutionContext *ctx)
 {
     return ctx->engine()->mousePressed();
@@ -631,10 +644,8 @@ BLOCK_EXPORT double sensing_volume_of_target(Target *target)
 
 BLOCK_EXPORT Target *sensing_get_target(ExecutionContext *ctx, const StringPtr *name)
 {
-    // TODO: Use UTF-16 in engine
-    std::string u8name = utf8::utf16to8(std::u16string(name->data));
     IEngine *engine = ctx->engine();
-    return engine->targetAt(engine->findTarget(u8name));
+    return engine->targetAt(engine->findTarget(name));
 }
 
 BLOCK_EXPORT double sensing_x_position_of_sprite_with_check(Target *target)
@@ -23,3 +23,18 @@ Target *CompilerContext::target() const
 {
     return impl->target;
 }
+
+/*! Returns true if reporters compiled in this context can be run in a batch using runReporters(). */
+bool CompilerContext::reporterBatchEnabled() const
+{
+    return impl->reporterBatchEnabled;
+}
+
+/*!
+ * Sets whether reporters compiled in this context can be run in a batch using runReporters() (disabled by default).
+ * \note This must be set before compiling the reporters, for example in contexts shared by monitors.
+ */
+void CompilerContext::setReporterBatchEnabled(bool enabled)
+{
+    impl->reporterBatchEnabled = enabled;
+}
@@ -14,6 +14,7 @@ struct CompilerContextPrivate
 
         IEngine *engine = nullptr;
         Target *target = nullptr;
+        bool reporterBatchEnabled = false;
 };
 
 } // namespace libscratchcpp
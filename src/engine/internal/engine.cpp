@@ -8,6 +8,7 @@
 #include <scratchcpp/textbubble.h>
 #include <scratchcpp/broadcast.h>
 #include <scratchcpp/compiler.h>
+#include <scratchcpp/compilercontext.h>
 #include <scratchcpp/promise.h>
 #include <scratchcpp/input.h>
 #include <scratchcpp/inputvalue.h>
@@ -22,15 +23,22 @@
 #include <scratchcpp/monitor.h>
 #include <scratchcpp/rect.h>
 #include <scratchcpp/thread.h>
+#include <scratchcpp/value_functions.h>
+#include <scratchcpp/stringptr.h>
 #include <cassert>
 #include <iostream>
+#include <fstream>
+#include <cstring>
+#include <utf8.h>
 
 #include "engine.h"
 #include "timer.h"
+#include "opcoderegistry.h"
 #include "clock.h"
 #include "audio/iaudioengine.h"
 #include "blocks/blocks.h"
 #include "scratch/monitor_p.h"
+#include "scratch/target_p.h"
 
 using namespace libscratchcpp;
 
@@ -44,6 +52,17 @@ const std::unordered_map<Engine::HatType, bool> Engine::m_hatEdgeActivated = {
     { HatType::CloneInit, false },         { HatType::KeyPressed, false }, { HatType::TargetClicked, false },     { HatType::WhenGreaterThan, true }
 };
 
+// Returns the key of a broadcast name in the broadcast name map (broadcast names are case insensitive)
+static std::u16string broadcastKey(std::u16string name)
+{
+    for (char16_t &ch : name) {
+        if (ch >= u'A' && ch <= u'Z')
+            ch += u'a' - u'A';
+    }
+
+    return name;
+}
+
 Engine::Engine() :
     m_defaultTimer(std::make_unique<Timer>()),
     m_timer(m_defaultTimer.get()),
@@ -78,8 +97,13 @@ void Engine::clear()
             m_threadAboutToStop(thread.get());
     }
 
+    clearMonitorBatches();
     m_targets.clear();
+    m_targetNameIndex.clear();
+    m_targetNames.clear();
     m_broadcasts.clear();
+    m_broadcastIndex.clear();
+    m_broadcastNameMap.clear();
     m_monitors.clear();
     m_extensions.clear();
     m_broadcastMap.clear();
@@ -94,6 +118,8 @@ void Engine::clear()
     m_broadcastHats.clear();
     m_cloneInitHats.clear();
     m_whenKeyPressedHats.clear();
+    m_keyPressHatKeys.reset();
+    m_anyKeyPressHat = false;
     m_whenTargetClickedHats.clear();
     m_whenGreaterThanHats.clear();
 
@@ -109,17 +135,19 @@ void Engine::clear()
 // Resolves ID references and sets pointers of entities.
 void Engine::resolveIds()
 {
+    buildEntityIndex();
+
     for (auto target : m_targets) {
         std::cout << "Processing target " << target->name() << "..." << std::endl;
         const auto &blocks = target->blocks();
         for (auto block : blocks) {
-            IExtension *ext = blockExtension(block->opcode());
+            const OpcodeData *opcodeData = resolveOpcode(block->opcodeId());
             block->setNext(getBlock(block->nextId(), target.get()).get());
             block->setParent(getBlock(block->parentId(), target.get()).get());
 
-            if (ext) {
-                block->setCompileFunction(resolveBlockCompileFunc(ext, block->opcode()));
-                block->setHatPredicateCompileFunction(resolveHatPredicateCompileFunc(ext, block->opcode()));
+            if (opcodeData) {
+                block->setCompileFunction(opcodeData->compileFunction);
+                block->setHatPredicateCompileFunction(opcodeData->hatPredicateCompileFunction);
             }
 
             const auto &inputs = block->inputs();
@@ -185,12 +213,12 @@ void Engine::resolveIds()
 
     for (auto monitor : m_monitors) {
         auto block = monitor->block();
-        auto ext = blockExtension(block->opcode());
+        const OpcodeData *opcodeData = resolveOpcode(block->opcodeId());
 
-        if (ext)
-            block->setCompileFunction(resolveBlockCompileFunc(ext, block->opcode()));
+        if (opcodeData)
+            block->setCompileFunction(opcodeData->compileFunction);
 
-        monitor->setExtension(ext);
+        monitor->setExtension(opcodeData ? opcodeData->extension : nullptr);
 
         const auto &fields = block->fields();
         Target *target;
@@ -237,6 +265,11 @@ void Engine::resolveIds()
             }
         }
     }
+
+    m_blockTargets.clear();
+    m_variableTargets.clear();
+    m_listTargets.clear();
+    m_commentTargets.clear();
 }
 
 void Engine::compile()
@@ -254,8 +287,7 @@ void Engine::compile()
 
         for (auto block : blocks) {
             if (block->topLevel() && !block->isTopLevelReporter() && !block->shadow()) {
-                auto ext = blockExtension(block->opcode());
-                if (ext) {
+                if (resolveOpcode(block->opcodeId())) {
                     auto script = std::make_shared<Script>(target.get(), block.get(), this);
                     m_scripts[block.get()] = script;
                     script->setCode(compiler.compile(block.get()));
@@ -279,11 +311,14 @@ void Engine::compile()
         compiler.preoptimize();
     }
 
-    // Compile monitor blocks to bytecode
+    // Compile monitor blocks (monitors of each target are compiled into one module)
     std::cout << "Compiling stage monitors..." << std::endl;
+    clearMonitorBatches();
 
     for (auto monitor : m_monitors)
-        compileMonitor(monitor);
+        compileMonitor(monitor, true);
+
+    initMonitorBatches();
 }
 
 void Engine::start()
@@ -367,7 +402,10 @@ void Engine::broadcast(int index, Thread *sender, bool wait)
 
 void Engine::broadcastByPtr(Broadcast *broadcast, Thread *sender, bool wait)
 {
-    startHats(HatType::BroadcastReceived, { { HatField::BroadcastOption, broadcast } }, nullptr);
+    // Skip looking for hats if no script receives the broadcast
+    if (m_broadcastMap.find(broadcast) != m_broadcastMap.cend())
+        startHats(HatType::BroadcastReceived, { { HatField::BroadcastOption, broadcast } }, nullptr);
+
     addBroadcastPromise(broadcast, sender, wait);
 }
 
@@ -415,17 +453,17 @@ void Engine::initClone(std::shared_ptr<Sprite> clone)
     startHats(HatType::CloneInit, {}, clone.get());
 
     assert(std::find(m_clones.begin(), m_clones.end(), clone) == m_clones.end());
-    assert(std::find(m_sortedDrawables.begin(), m_sortedDrawables.end(), clone.get()) == m_sortedDrawables.end());
+    assert(!m_sortedDrawables.contains(clone.get()));
     m_clones.insert(clone);
-    m_sortedDrawables.push_back(clone.get()); // execution order needs to be updated after this
-    m_sortedDrawables.push_back(clone->bubble());
+    m_sortedDrawables.append(clone.get()); // execution order needs to be updated after this
+    m_sortedDrawables.append(clone->bubble());
 }
 
 void Engine::deinitClone(std::shared_ptr<Sprite> clone)
 {
     m_clones.erase(clone);
-    m_sortedDrawables.erase(std::remove(m_sortedDrawables.begin(), m_sortedDrawables.end(), clone->bubble()), m_sortedDrawables.end());
-    m_sortedDrawables.erase(std::remove(m_sortedDrawables.begin(), m_sortedDrawables.end(), clone.get()), m_sortedDrawables.end());
+    m_sortedDrawables.remove(clone->bubble());
+    m_sortedDrawables.remove(clone.get());
 }
 
 void Engine::stopSounds()
@@ -448,16 +486,117 @@ void Engine::setGlobalVolume(double volume)
     m_audioEngine->setVolume(volume / 100);
 }
 
+const std::vector<float> &Engine::renderedAudio() const
+{
+    return m_renderedAudio;
+}
+
+unsigned int Engine::renderedAudioSampleRate() const
+{
+    return m_audioEngine->sampleRate();
+}
+
+unsigned int Engine::renderedAudioChannels() const
+{
+    return m_audioEngine->channelCount();
+}
+
+void Engine::clearRenderedAudio()
+{
+    m_renderedAudio.clear();
+    m_audioFrameRemainder = 0;
+}
+
+bool Engine::saveRenderedAudio(const std::string &fileName) const
+{
+    std::ofstream file(fileName, std::ios::binary);
+
+    if (!file.is_open())
+        return false;
+
+    const unsigned int channels = renderedAudioChannels();
+    const unsigned int sampleRate = renderedAudioSampleRate();
+    const uint32_t dataSize = m_renderedAudio.size() * sizeof(float);
+
+    // WAV files are little-endian
+    auto write16 = [&file](uint16_t value) {
+        const char bytes[] = { static_cast<char>(value & 0xFF), static_cast<char>(value >> 8) };
+        file.write(bytes, 2);
+    };
+
+    auto write32 = [&write16](uint32_t value) {
+        write16(value & 0xFFFF);
+        write16(value >> 16);
+    };
+
+    // RIFF header and 32-bit IEEE float format chunk
+    file.write("RIFF", 4);
+    write32(36 + dataSize);
+    file.write("WAVEfmt ", 8);
+    write32(16);
+    write16(3);
+    write16(channels);
+    write32(sampleRate);
+    write32(sampleRate * channels * sizeof(float));
+    write16(channels * sizeof(float));
+    write16(32);
+    file.write("data", 4);
+    write32(dataSize);
+
+    for (float sample : m_renderedAudio) {
+        uint32_t bits;
+        std::memcpy(&bits, &sample, sizeof(bits));
+        write32(bits);
+    }
+
+    return file.good();
+}
+
 void Engine::updateMonitors()
 {
     // Execute the "script" of each visible monitor
+    // Monitors compiled along with the project are evaluated using one call per target
+    for (MonitorBatch &batch : m_monitorBatches) {
+        const size_t count = batch.monitors.size();
+        bool changed = false;
+
+        for (size_t i = 0; i < count; i++) {
+            Monitor *monitor = batch.monitors[i];
+
+            // Variable and list monitors are updated only if the variable or list has changed
+            batch.mask[i] = monitor->visible() && monitor->script() && monitor->impl->sourceChanged();
+            changed |= batch.mask[i];
+        }
+
+        if (!changed)
+            continue;
+
+        if (!batch.thread)
+            batch.thread = std::make_shared<Thread>(batch.target, this, nullptr);
+
+        if (!batch.ctx->runReporters(batch.thread.get(), batch.mask.get(), batch.results.data())) {
+            // The compiler context doesn't support batches, run the reporters one by one
+            for (size_t i = 0; i < count; i++) {
+                if (batch.mask[i])
+                    batch.results[i] = runMonitorReporter(batch.monitors[i]);
+            }
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            if (batch.mask[i]) {
+                batch.monitors[i]->updateValue(Value(batch.results[i]));
+                value_free(&batch.results[i]);
+            }
+        }
+    }
+
     for (auto monitor : m_monitors) {
         if (monitor->visible()) {
-            auto script = monitor->script();
+            MonitorPrivate *monitorImpl = monitor->impl.get();
 
-            if (script) {
-                auto thread = script->start();
-                ValueData value = thread->runReporter();
+            // Variable and list monitors are updated only if the variable or list has changed
+            if (!monitorImpl->batched && monitorImpl->script && monitorImpl->sourceChanged()) {
+                ValueData value = runMonitorReporter(monitor.get());
                 monitor->updateValue(Value(value));
                 value_free(&value);
             }
@@ -469,6 +608,7 @@ void Engine::step()
 {
     // https://github.com/scratchfoundation/scratch-vm/blob/f1aa92fad79af17d9dd1c41eeeadca099339a9f1/src/engine/runtime.js#L2087C6-L2155
     updateFrameDuration();
+    m_frameCount++;
 
     // Clean up threads that were told to stop during or since the last step
     m_threads.erase(std::remove_if(m_threads.begin(), m_threads.end(), [](std::shared_ptr<Thread> thread) { return thread->isFinished(); }), m_threads.end());
@@ -569,6 +709,12 @@ void Engine::step()
     // Step threads
     stepThreads();
 
+    // Mix the sounds of this frame
+    renderAudio();
+
+    // Notify about layer order changes made during this frame
+    m_sortedDrawables.updateLayerOrders();
+
     // Render
     m_aboutToRedraw();
 }
@@ -755,25 +901,18 @@ void Engine::setTurboModeEnabled(bool turboMode)
 
 bool Engine::keyPressed(const std::string &name) const
 {
-    if (name == "any") {
-        if (m_anyKeyPressed)
-            return true;
+    if (name == "any")
+        return m_anyKeyPressed || m_keyStates.any();
 
-        for (const auto &[key, value] : m_keyMap) {
-            if (value)
-                return true;
-        }
+    return m_keyStates[KeyEvent(name).code()];
+}
 
+bool Engine::keyPressed(unsigned int keyCode) const
+{
+    if (keyCode >= KeyEvent::CODE_COUNT)
         return false;
-    }
 
-    KeyEvent event(name);
-    auto it = m_keyMap.find(event.name());
-
-    if (it == m_keyMap.cend())
-        return false;
-    else
-        return it->second;
+    return m_keyStates[keyCode];
 }
 
 void Engine::setKeyState(const std::string &name, bool pressed)
@@ -784,12 +923,16 @@ void Engine::setKeyState(const std::string &name, bool pressed)
 
 void Engine::setKeyState(const KeyEvent &event, bool pressed)
 {
-    m_keyMap[event.name()] = pressed;
+    const unsigned int code = event.code();
+    m_keyStates[code] = pressed;
 
-    // Start "when key pressed" scripts
+    // Start "when key pressed" scripts (skip keys without any hats)
     if (pressed) {
-        startHats(HatType::KeyPressed, { { HatField::KeyOption, event.name() } }, nullptr);
-        startHats(HatType::KeyPressed, { { HatField::KeyOption, "any" } }, nullptr);
+        if (m_keyPressHatKeys[code])
+            startHats(HatType::KeyPressed, { { HatField::KeyOption, event.name() } }, nullptr);
+
+        if (m_anyKeyPressHat)
+            startHats(HatType::KeyPressed, { { HatField::KeyOption, "any" } }, nullptr);
     }
 }
 
@@ -798,20 +941,26 @@ void Engine::setAnyKeyPressed(bool pressed)
     m_anyKeyPressed = pressed;
 
     // Start "when key pressed" scripts
-    if (pressed)
+    if (pressed && m_anyKeyPressHat)
         startHats(HatType::KeyPressed, { { HatField::KeyOption, "any" } }, nullptr);
 }
 
 void Engine::mouseWheelUp()
 {
     // Start "when up arrow pressed" scripts
-    startHats(HatType::KeyPressed, { { HatField::KeyOption, "up arrow" } }, nullptr);
+    static const unsigned int code = KeyEvent(KeyEvent::Type::Up).code();
+
+    if (m_keyPressHatKeys[code])
+        startHats(HatType::KeyPressed, { { HatField::KeyOption, "up arrow" } }, nullptr);
 }
 
 void Engine::mouseWheelDown()
 {
     // Start "when down arrow pressed" scripts
-    startHats(HatType::KeyPressed, { { HatField::KeyOption, "down arrow" } }, nullptr);
+    static const unsigned int code = KeyEvent(KeyEvent::Type::Down).code();
+
+    if (m_keyPressHatKeys[code])
+        startHats(HatType::KeyPressed, { { HatField::KeyOption, "down arrow" } }, nullptr);
 }
 
 double Engine::mouseX() const
@@ -906,6 +1055,21 @@ void Engine::setSpriteFencingEnabled(bool enable)
     m_spriteFencingEnabled = enable;
 }
 
+bool Engine::collisionCacheEnabled() const
+{
+    return m_collisionCacheEnabled;
+}
+
+void Engine::setCollisionCacheEnabled(bool enable)
+{
+    m_collisionCacheEnabled = enable;
+}
+
+unsigned int Engine::frameCount() const
+{
+    return m_frameCount;
+}
+
 void Engine::requestRedraw()
 {
     m_redrawRequested = true;
@@ -923,42 +1087,31 @@ void Engine::setTimer(ITimer *timer)
 
 void Engine::addCompileFunction(IExtension *extension, const std::string &opcode, BlockComp f)
 {
-    if (m_compileFunctions.find(extension) == m_compileFunctions.cend())
-        m_compileFunctions[extension] = {};
-
-    m_compileFunctions[extension][opcode] = f;
+    OpcodeData &data = opcodeEntry(opcode);
+    data.extension = extension;
+    data.compileFunction = f;
 }
 
 void Engine::addHatPredicateCompileFunction(IExtension *extension, const std::string &opcode, HatPredicateCompileFunc f)
 {
-    if (m_hatPredicateCompileFunctions.find(extension) == m_hatPredicateCompileFunctions.cend())
-        m_hatPredicateCompileFunctions[extension] = {};
-
-    m_hatPredicateCompileFunctions[extension][opcode] = f;
+    opcodeEntry(opcode).hatPredicateCompileFunction = f;
 }
 
 void Engine::addMonitorNameFunction(IExtension *extension, const std::string &opcode, MonitorNameFunc f)
 {
-    if (m_monitorNameFunctions.find(extension) == m_monitorNameFunctions.cend())
-        m_monitorNameFunctions[extension] = {};
-
-    m_monitorNameFunctions[extension][opcode] = f;
+    opcodeEntry(opcode).monitorNameFunction = f;
 }
 
 void Engine::addMonitorChangeFunction(IExtension *extension, const std::string &opcode, MonitorChangeFunc f)
 {
-    if (m_monitorChangeFunctions.find(extension) == m_monitorChangeFunctions.cend())
-        m_monitorChangeFunctions[extension] = {};
-
-    m_monitorChangeFunctions[extension][opcode] = f;
+    opcodeEntry(opcode).monitorChangeFunction = f;
 }
 
 void Engine::addHatBlock(IExtension *extension, const std::string &opcode)
 {
-    if (m_compileFunctions.find(extension) == m_compileFunctions.cend())
-        m_compileFunctions[extension] = {};
-
-    m_compileFunctions[extension][opcode] = [](Compiler *compiler) -> CompilerValue * { return nullptr; };
+    OpcodeData &data = opcodeEntry(opcode);
+    data.extension = extension;
+    data.compileFunction = [](Compiler *compiler) -> CompilerValue * { return nullptr; };
 }
 
 const std::vector<std::shared_ptr<Broadcast>> &Engine::broadcasts() const
@@ -969,6 +1122,14 @@ const std::vector<std::shared_ptr<Broadcast>> &Engine::broadcasts() const
 void Engine::setBroadcasts(const std::vector<std::shared_ptr<Broadcast>> &broadcasts)
 {
     m_broadcasts = broadcasts;
+    m_broadcastIndex.clear();
+
+    m_broadcastNameMap.clear();
+
+    for (size_t i = 0; i < m_broadcasts.size(); i++) {
+        m_broadcastIndex.try_emplace(m_broadcasts[i]->id(), i);
+        m_broadcastNameMap[broadcastKey(utf8::utf8to16(m_broadcasts[i]->name()))].push_back(i);
+    }
 }
 
 std::shared_ptr<Broadcast> Engine::broadcastAt(int index) const
@@ -981,23 +1142,33 @@ std::shared_ptr<Broadcast> Engine::broadcastAt(int index) const
 
 std::vector<int> Engine::findBroadcasts(const std::string &broadcastName) const
 {
-    std::vector<int> ret;
-    std::string lowercaseName = broadcastName;
-    std::transform(lowercaseName.begin(), lowercaseName.end(), lowercaseName.begin(), ::tolower);
+    auto it = m_broadcastNameMap.find(broadcastKey(utf8::utf8to16(broadcastName)));
 
-    for (unsigned int i = 0; i < m_broadcasts.size(); i++) {
-        std::string name = m_broadcasts[i]->name();
-        std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+    if (it == m_broadcastNameMap.cend())
+        return {};
+    else
+        return it->second;
+}
 
-        if (name == lowercaseName)
-            ret.push_back(i);
-    }
+const std::vector<int> &Engine::findBroadcasts(const StringPtr *broadcastName) const
+{
+    static const std::vector<int> empty;
+    auto it = m_broadcastNameMap.find(broadcastKey(std::u16string(broadcastName->data, broadcastName->size)));
 
-    return ret;
+    if (it == m_broadcastNameMap.cend())
+        return empty;
+    else
+        return it->second;
 }
 
 int Engine::findBroadcastById(const std::string &broadcastId) const
 {
+    auto indexIt = m_broadcastIndex.find(broadcastId);
+
+    if (indexIt != m_broadcastIndex.cend() && m_broadcasts[indexIt->second]->id() == broadcastId)
+        return indexIt->second;
+
+    // The index is keyed by the IDs the broadcasts had when they were added, so fall back to a linear search if an ID has changed since then
     auto it = std::find_if(m_broadcasts.begin(), m_broadcasts.end(), [broadcastId](std::shared_ptr<Broadcast> broadcast) { return broadcast->id() == broadcastId; });
 
     if (it == m_broadcasts.end())
@@ -1083,6 +1254,14 @@ void Engine::addKeyPressScript(Block *hatBlock, Field *field)
     Script *script = m_scripts[hatBlock].get();
     addHatToMap(m_whenKeyPressedHats, script);
     addHatField(script, HatField::KeyOption, field);
+
+    // Index the key so that key events without any hats can skip startHats()
+    const std::string key = field ? field->value().toString() : std::string();
+
+    if (key == "any")
+        m_anyKeyPressHat = true;
+    else
+        m_keyPressHatKeys[KeyEvent(key).code()] = true;
 }
 
 void Engine::addTargetClickScript(Block *hatBlock)
@@ -1104,10 +1283,10 @@ const std::vector<std::shared_ptr<Target>> &Engine::targets() const
 void Engine::setTargets(const std::vector<std::shared_ptr<Target>> &newTargets)
 {
     m_targets = newTargets;
-    m_sortedDrawables.clear();
+    std::vector<Drawable *> sortedDrawables;
 
     for (auto target : m_targets) {
-        m_sortedDrawables.push_back(target.get());
+        sortedDrawables.push_back(target.get());
 
         // Set engine in the target
         target->setEngine(this);
@@ -1120,14 +1299,19 @@ void Engine::setTargets(const std::vector<std::shared_ptr<Target>> &newTargets)
         }
     }
 
+    updateTargetNameIndex();
+
     // Sort the targets by layer order
-    std::sort(m_sortedDrawables.begin(), m_sortedDrawables.end(), [](Drawable *d1, Drawable *d2) { return d1->layerOrder() < d2->layerOrder(); });
+    m_sortedDrawables.clear();
+    std::sort(sortedDrawables.begin(), sortedDrawables.end(), [](Drawable *d1, Drawable *d2) { return d1->layerOrder() < d2->layerOrder(); });
 
     // Add text bubbles (layers are irrelevant until text is displayed)
     for (auto target : m_targets) {
-        target->bubble()->setLayerOrder(m_sortedDrawables.size());
-        m_sortedDrawables.push_back(target->bubble());
+        target->bubble()->setLayerOrder(sortedDrawables.size());
+        sortedDrawables.push_back(target->bubble());
     }
+
+    m_sortedDrawables.assign(sortedDrawables);
 }
 
 Target *Engine::targetAt(int index) const
@@ -1177,6 +1361,34 @@ int Engine::findTarget(const std::string &targetName) const
         return it - m_targets.begin();
 }
 
+int Engine::findTarget(const StringPtr *targetName) const
+{
+    if (m_targetNameGeneration != TargetPrivate::nameGeneration)
+        updateTargetNameIndex();
+
+    auto it = m_targetNameIndex.find(std::u16string_view(targetName->data, targetName->size));
+
+    if (it == m_targetNameIndex.cend())
+        return -1;
+    else
+        return it->second;
+}
+
+void Engine::updateTargetNameIndex() const
+{
+    // The first target with the name wins, like in findTarget()
+    m_targetNameGeneration = TargetPrivate::nameGeneration;
+    m_targetNameIndex.clear();
+    m_targetNames.clear();
+    m_targetNames.reserve(m_targets.size());
+
+    for (auto target : m_targets)
+        m_targetNames.push_back(utf8::utf8to16(target->isStage() ? "_stage_" : target->name()));
+
+    for (size_t i = 0; i < m_targetNames.size(); i++)
+        m_targetNameIndex.try_emplace(m_targetNames[i], i);
+}
+
 void Engine::moveDrawableToFront(Drawable *drawable)
 {
     if (!drawable || m_sortedDrawables.size() <= 2)
@@ -1188,12 +1400,8 @@ void Engine::moveDrawableToFront(Drawable *drawable)
         return;
     }
 
-    auto it = std::find(m_sortedDrawables.begin(), m_sortedDrawables.end(), drawable);
-
-    if (it != m_sortedDrawables.end()) {
-        std::rotate(it, it + 1, m_sortedDrawables.end());
-        updateDrawableLayerOrder();
-    }
+    if (m_sortedDrawables.contains(drawable))
+        m_sortedDrawables.move(drawable, m_sortedDrawables.size() - 1);
 }
 
 void Engine::moveDrawableToBack(Drawable *drawable)
@@ -1201,12 +1409,8 @@ void Engine::moveDrawableToBack(Drawable *drawable)
     if (!drawable || m_sortedDrawables.size() <= 2)
         return;
 
-    auto it = std::find(m_sortedDrawables.begin(), m_sortedDrawables.end(), drawable);
-
-    if (it != m_sortedDrawables.end()) {
-        std::rotate(m_sortedDrawables.begin() + 1, it, it + 1); // stage is always the first
-        updateDrawableLayerOrder();
-    }
+    if (m_sortedDrawables.contains(drawable) && m_sortedDrawables.indexOf(drawable) > 0)
+        m_sortedDrawables.move(drawable, 1); // stage is always the first
 }
 
 void Engine::moveDrawableForwardLayers(Drawable *drawable, int layers)
@@ -1220,21 +1424,20 @@ void Engine::moveDrawableForwardLayers(Drawable *drawable, int layers)
         return;
     }
 
-    auto it = std::find(m_sortedDrawables.begin(), m_sortedDrawables.end(), drawable);
-
-    if (it == m_sortedDrawables.end())
+    if (!m_sortedDrawables.contains(drawable))
         return;
 
-    auto target = it;
+    const long size = m_sortedDrawables.size();
+    long target = m_sortedDrawables.indexOf(drawable);
     int layersAbs = std::abs(layers);
 
     for (int i = 0; i < layersAbs; i++) {
-        if (target <= m_sortedDrawables.begin()) {
+        if (target <= 0) {
             moveDrawableToBack(drawable);
             return;
         }
 
-        if (target >= m_sortedDrawables.end()) {
+        if (target >= size) {
             moveDrawableToFront(drawable);
             return;
         }
@@ -1242,17 +1445,17 @@ void Engine::moveDrawableForwardLayers(Drawable *drawable, int layers)
         Drawable *currentDrawable;
 
         do {
-            currentDrawable = *target;
+            currentDrawable = m_sortedDrawables.at(target);
             target += layers / layersAbs;
-        } while (currentDrawable->isTextBubble() && static_cast<TextBubble *>(currentDrawable)->text().empty());
+        } while (target > 0 && target < size && currentDrawable->isTextBubble() && static_cast<TextBubble *>(currentDrawable)->text().empty());
     }
 
-    if (layers > 0)
-        std::rotate(it, it + 1, target + 1);
+    if (target <= 0)
+        moveDrawableToBack(drawable);
+    else if (target >= size)
+        moveDrawableToFront(drawable);
     else
-        std::rotate(target, it, it + 1);
-
-    updateDrawableLayerOrder();
+        m_sortedDrawables.move(drawable, target);
 }
 
 void Engine::moveDrawableBackwardLayers(Drawable *drawable, int layers)
@@ -1271,33 +1474,26 @@ void Engine::moveDrawableBehindOther(Drawable *drawable, Drawable *other)
         return;
     }
 
-    auto itSprite = std::find(m_sortedDrawables.begin(), m_sortedDrawables.end(), drawable);
-    auto itOther = std::find(m_sortedDrawables.begin(), m_sortedDrawables.end(), other);
-
-    if ((itSprite == m_sortedDrawables.end()) || (itOther == m_sortedDrawables.end()))
+    if (!m_sortedDrawables.contains(drawable) || !m_sortedDrawables.contains(other))
         return;
 
-    auto target = itOther - 1; // behind
+    const long index = m_sortedDrawables.indexOf(drawable);
+    long target = (long)m_sortedDrawables.indexOf(other) - 1; // behind
 
-    if (target < itSprite)
+    if (target < index)
         target++;
 
-    if (target <= m_sortedDrawables.begin()) {
+    if (target <= 0) {
         moveDrawableToBack(drawable);
         return;
     }
 
-    if (target >= m_sortedDrawables.end()) {
+    if (target >= (long)m_sortedDrawables.size()) {
         moveDrawableToFront(drawable);
         return;
     }
 
-    if (target > itSprite)
-        std::rotate(itSprite, itSprite + 1, target + 1);
-    else
-        std::rotate(target, itSprite, itSprite + 1);
-
-    updateDrawableLayerOrder();
+    m_sortedDrawables.move(drawable, target);
 }
 
 Stage *Engine::stage() const
@@ -1317,6 +1513,7 @@ const std::vector<std::shared_ptr<Monitor>> &Engine::monitors() const
 
 void Engine::setMonitors(const std::vector<std::shared_ptr<Monitor>> &newMonitors)
 {
+    clearMonitorBatches();
     m_monitors.clear();
 
     for (auto monitor : newMonitors) {
@@ -1330,8 +1527,8 @@ Monitor *Engine::createVariableMonitor(std::shared_ptr<Variable> var, const std:
     if (var->monitor())
         return var->monitor();
     else {
-        IExtension *ext = blockExtension(opcode);
-        BlockComp compileFunction = resolveBlockCompileFunc(ext, opcode);
+        const OpcodeData *opcodeData = resolveOpcode(OpcodeRegistry::id(opcode));
+        BlockComp compileFunction = opcodeData ? opcodeData->compileFunction : nullptr;
 
         auto monitor = std::make_shared<Monitor>(var->id(), opcode);
         auto field = std::make_shared<Field>(varFieldName, var->name(), var);
@@ -1350,8 +1547,8 @@ Monitor *Engine::createListMonitor(std::shared_ptr<List> list, const std::string
     if (list->monitor())
         return list->monitor();
     else {
-        IExtension *ext = blockExtension(opcode);
-        BlockComp compileFunction = resolveBlockCompileFunc(ext, opcode);
+        const OpcodeData *opcodeData = resolveOpcode(OpcodeRegistry::id(opcode));
+        BlockComp compileFunction = opcodeData ? opcodeData->compileFunction : nullptr;
 
         auto monitor = std::make_shared<Monitor>(list->id(), opcode);
         auto field = std::make_shared<Field>(listFieldName, list->name(), list);
@@ -1425,6 +1622,30 @@ const std::unordered_map<Block *, std::shared_ptr<Script>> &Engine::scripts() co
     return m_scripts;
 }
 
+// Maps IDs of blocks, variables, lists and comments to their targets (for the cross-target lookups in resolveIds()).
+void Engine::buildEntityIndex()
+{
+    m_blockTargets.clear();
+    m_variableTargets.clear();
+    m_listTargets.clear();
+    m_commentTargets.clear();
+
+    // The first target wins (like in a linear search)
+    for (auto target : m_targets) {
+        for (auto block : target->blocks())
+            m_blockTargets.try_emplace(block->id(), target.get());
+
+        for (auto variable : target->variables())
+            m_variableTargets.try_emplace(variable->id(), target.get());
+
+        for (auto list : target->lists())
+            m_listTargets.try_emplace(list->id(), target.get());
+
+        for (auto comment : target->comments())
+            m_commentTargets.try_emplace(comment->id(), target.get());
+    }
+}
+
 // Returns the block with the given ID.
 std::shared_ptr<Block> Engine::getBlock(const std::string &id, Target *target)
 {
@@ -1440,7 +1661,10 @@ std::shared_ptr<Block> Engine::getBlock(const std::string &id, Target *target)
             return target->blockAt(index);
     }
 
-    for (auto t : m_targets) {
+    auto it = m_blockTargets.find(id);
+
+    if (it != m_blockTargets.cend()) {
+        Target *t = it->second;
         index = t->findBlock(id);
 
         if (index != -1)
@@ -1476,13 +1700,14 @@ std::shared_ptr<Variable> Engine::getVariable(const std::string &id, Target *tar
     }
 
     // Fall back to checking all the other targets
-    for (auto t : m_targets) {
-        if (t.get() != stage && t.get() != target) {
-            int index = t->findVariableById(id);
+    auto it = m_variableTargets.find(id);
 
-            if (index != -1)
-                return t->variableAt(index);
-        }
+    if (it != m_variableTargets.cend()) {
+        Target *t = it->second;
+        index = t->findVariableById(id);
+
+        if (index != -1)
+            return t->variableAt(index);
     }
 
     return nullptr;
@@ -1514,13 +1739,14 @@ std::shared_ptr<List> Engine::getList(const std::string &id, Target *target)
     }
 
     // Fall back to checking all the other targets
-    for (auto t : m_targets) {
-        if (t.get() != stage && t.get() != target) {
-            int index = t->findListById(id);
+    auto it = m_listTargets.find(id);
 
-            if (index != -1)
-                return t->listAt(index);
-        }
+    if (it != m_listTargets.cend()) {
+        Target *t = it->second;
+        index = t->findListById(id);
+
+        if (index != -1)
+            return t->listAt(index);
     }
 
     return nullptr;
@@ -1554,7 +1780,10 @@ std::shared_ptr<Comment> Engine::getComment(const std::string &id, Target *targe
             return target->commentAt(index);
     }
 
-    for (auto t : m_targets) {
+    auto it = m_commentTargets.find(id);
+
+    if (it != m_commentTargets.cend()) {
+        Target *t = it->second;
         index = t->findComment(id);
 
         if (index != -1)
@@ -1670,14 +1899,6 @@ const std::vector<Script *> &Engine::getHats(Target *target, HatType type)
     }
 }
 
-void Engine::updateDrawableLayerOrder()
-{
-    assert(m_sortedDrawables.empty() || (m_sortedDrawables[0]->isTarget() && static_cast<Target *>(m_sortedDrawables[0])->isStage()));
-
-    for (size_t i = 1; i < m_sortedDrawables.size(); i++) // i = 1 to skip the stage
-        m_sortedDrawables[i]->setLayerOrder(i);
-}
-
 const std::string &Engine::userAgent() const
 {
     return m_userAgent;
@@ -1695,108 +1916,63 @@ const std::unordered_set<std::string> &Engine::unsupportedBlocks() const
 
 void Engine::clearExtensionData()
 {
-    m_compileFunctions.clear();
-    m_hatPredicateCompileFunctions.clear();
-    m_monitorNameFunctions.clear();
-    m_monitorChangeFunctions.clear();
+    m_opcodeTable.clear();
 }
 
-IExtension *Engine::blockExtension(const std::string &opcode) const
+Engine::OpcodeData &Engine::opcodeEntry(const std::string &opcode)
 {
-    for (const auto &[ext, data] : m_compileFunctions) {
-        auto it = data.find(opcode);
+    const unsigned int id = OpcodeRegistry::id(opcode);
 
-        if (it != data.cend())
-            return ext;
-    }
+    if (id >= m_opcodeTable.size())
+        m_opcodeTable.resize(id + 1);
 
-    return nullptr;
+    return m_opcodeTable[id];
 }
 
-BlockComp Engine::resolveBlockCompileFunc(IExtension *extension, const std::string &opcode) const
+// Returns the registered functions of the given opcode, or nullptr if no extension provides it.
+const Engine::OpcodeData *Engine::resolveOpcode(unsigned int opcodeId) const
 {
-    if (!extension)
+    if (opcodeId >= m_opcodeTable.size())
         return nullptr;
 
-    auto it = m_compileFunctions.find(extension);
-
-    if (it != m_compileFunctions.cend()) {
-        auto dataIt = it->second.find(opcode);
-
-        if (dataIt != it->second.cend())
-            return dataIt->second;
-    }
-
-    return nullptr;
+    const OpcodeData &data = m_opcodeTable[opcodeId];
+    return data.compileFunction ? &data : nullptr;
 }
 
-HatPredicateCompileFunc Engine::resolveHatPredicateCompileFunc(IExtension *extension, const std::string &opcode) const
-{
-    if (!extension)
-        return nullptr;
-
-    auto it = m_hatPredicateCompileFunctions.find(extension);
-
-    if (it != m_hatPredicateCompileFunctions.cend()) {
-        auto dataIt = it->second.find(opcode);
-
-        if (dataIt != it->second.cend())
-            return dataIt->second;
-    }
-
-    return nullptr;
-}
-
-MonitorNameFunc Engine::resolveMonitorNameFunc(IExtension *extension, const std::string &opcode) const
-{
-    if (!extension)
-        return nullptr;
-
-    auto it = m_monitorNameFunctions.find(extension);
-
-    if (it != m_monitorNameFunctions.cend()) {
-        auto dataIt = it->second.find(opcode);
-
-        if (dataIt != it->second.cend())
-            return dataIt->second;
-    }
-
-    return nullptr;
-}
-
-MonitorChangeFunc Engine::resolveMonitorChangeFunc(IExtension *extension, const std::string &opcode) const
-{
-    if (!extension)
-        return nullptr;
-
-    auto it = m_monitorChangeFunctions.find(extension);
-
-    if (it != m_monitorChangeFunctions.cend()) {
-        auto dataIt = it->second.find(opcode);
-
-        if (dataIt != it->second.cend())
-            return dataIt->second;
-    }
-
-    return nullptr;
-}
-
-void Engine::compileMonitor(std::shared_ptr<Monitor> monitor)
+void Engine::compileMonitor(std::shared_ptr<Monitor> monitor, bool batch)
 {
     Target *target = monitor->sprite() ? static_cast<Target *>(monitor->sprite()) : stage();
     auto block = monitor->block();
-    auto ext = blockExtension(block->opcode());
+    const OpcodeData *opcodeData = resolveOpcode(block->opcodeId());
+
+    if (opcodeData) {
+        std::shared_ptr<CompilerContext> ctx;
+        MonitorBatch *monitorBatch = nullptr;
+
+        if (batch) {
+            // Use the context shared by all monitors of the target
+            auto it = std::find_if(m_monitorBatches.begin(), m_monitorBatches.end(), [target](const MonitorBatch &b) { return b.target == target; });
+
+            if (it == m_monitorBatches.end()) {
+                MonitorBatch newBatch;
+                newBatch.target = target;
+                newBatch.ctx = Compiler::createContext(this, target);
+                newBatch.ctx->setReporterBatchEnabled(true);
+                m_monitorBatches.push_back(std::move(newBatch));
+                monitorBatch = &m_monitorBatches.back();
+            } else
+                monitorBatch = &*it;
+
+            ctx = monitorBatch->ctx;
+        } else
+            ctx = Compiler::createContext(this, target);
 
-    if (ext) {
-        auto ctx = Compiler::createContext(this, target);
         Compiler compiler(ctx.get());
-        MonitorNameFunc nameFunc = resolveMonitorNameFunc(ext, block->opcode());
 
-        if (nameFunc)
-            monitor->setName(nameFunc(block.get()));
+        if (opcodeData->monitorNameFunction)
+            monitor->setName(opcodeData->monitorNameFunction(block.get()));
 
-        MonitorChangeFunc changeFunc = resolveMonitorChangeFunc(ext, block->opcode());
-        monitor->setValueChangeFunction(changeFunc);
+        monitor->setValueChangeFunction(opcodeData->monitorChangeFunction);
 
         auto script = std::make_shared<Script>(target, block.get(), this);
         monitor->setScript(script);
@@ -1804,19 +1980,76 @@ void Engine::compileMonitor(std::shared_ptr<Monitor> monitor)
         script->setCode(code);
         m_monitorCompilerContexts[monitor.get()] = ctx;
 
+        // Track changes of the monitored variable or list
+        MonitorPrivate *monitorImpl = monitor->impl.get();
+        monitorImpl->variable = nullptr;
+        monitorImpl->list = nullptr;
+        const auto &fields = block->fields();
+
+        for (auto field : fields) {
+            if (field->name() == "VARIABLE")
+                monitorImpl->variable = static_cast<Variable *>(field->valuePtr().get());
+            else if (field->name() == "LIST")
+                monitorImpl->list = static_cast<List *>(field->valuePtr().get());
+        }
+
+        // The reporter index in the batch matches the compilation order
+        monitorImpl->batched = monitorBatch;
+
+        if (monitorBatch)
+            monitorBatch->monitors.push_back(monitor.get());
+
         const auto &unsupportedBlocks = compiler.unsupportedBlocks();
 
         for (const std::string &opcode : unsupportedBlocks)
             m_unsupportedBlocks.insert(opcode);
 
         // Preoptimize to avoid lag when updating monitors for the first time
-        compiler.preoptimize();
+        // NOTE: Batches are optimized after all monitors are compiled (see initMonitorBatches())
+        if (!monitorBatch)
+            compiler.preoptimize();
     } else {
         std::cout << "warning: unsupported monitor block: " << block->opcode() << std::endl;
         m_unsupportedBlocks.insert(block->opcode());
     }
 }
 
+void Engine::initMonitorBatches()
+{
+    for (MonitorBatch &batch : m_monitorBatches) {
+        const size_t count = batch.monitors.size();
+        batch.mask = std::make_unique<bool[]>(count);
+        batch.results.resize(count);
+
+        for (ValueData &value : batch.results)
+            value_init(&value);
+
+        // Preoptimize to avoid lag when updating monitors for the first time
+        batch.ctx->preoptimize();
+    }
+}
+
+void Engine::clearMonitorBatches()
+{
+    for (const MonitorBatch &batch : m_monitorBatches) {
+        for (Monitor *monitor : batch.monitors)
+            monitor->impl->batched = false;
+    }
+
+    m_monitorBatches.clear();
+}
+
+ValueData Engine::runMonitorReporter(Monitor *monitor)
+{
+    MonitorPrivate *monitorImpl = monitor->impl.get();
+
+    // Keep the thread between frames (reporters don't need a fresh execution context)
+    if (!monitorImpl->thread)
+        monitorImpl->thread = monitorImpl->script->start();
+
+    return monitorImpl->thread->runReporter();
+}
+
 void Engine::deleteClones()
 {
     m_eventLoopMutex.lock();
@@ -1841,8 +2074,7 @@ void Engine::deleteClones()
 void Engine::removeExecutableClones()
 {
     // Remove clones from sorted drawables
-    for (std::shared_ptr<Sprite> clone : m_clones)
-        m_sortedDrawables.erase(std::remove(m_sortedDrawables.begin(), m_sortedDrawables.end(), clone.get()), m_sortedDrawables.end());
+    m_sortedDrawables.removeIf([](Drawable *drawable) { return drawable->isTarget() && !static_cast<Target *>(drawable)->isStage() && static_cast<Sprite *>(drawable)->isClone(); });
 }
 
 void Engine::addVarOrListMonitor(std::shared_ptr<Monitor> monitor, Target *target)
@@ -1850,17 +2082,14 @@ void Engine::addVarOrListMonitor(std::shared_ptr<Monitor> monitor, Target *targe
     if (!target->isStage())
         monitor->setSprite(static_cast<Sprite *>(target));
 
-    IExtension *ext = blockExtension(monitor->opcode());
-    monitor->setExtension(ext);
+    const OpcodeData *opcodeData = resolveOpcode(monitor->block()->opcodeId());
+    monitor->setExtension(opcodeData ? opcodeData->extension : nullptr);
 
-    if (ext) {
-        MonitorNameFunc nameFunc = resolveMonitorNameFunc(ext, monitor->opcode());
+    if (opcodeData) {
+        if (opcodeData->monitorNameFunction)
+            monitor->setName(opcodeData->monitorNameFunction(monitor->block().get()));
 
-        if (nameFunc)
-            monitor->setName(nameFunc(monitor->block().get()));
-
-        MonitorChangeFunc changeFunc = resolveMonitorChangeFunc(ext, monitor->opcode());
-        monitor->setValueChangeFunction(changeFunc);
+        monitor->setValueChangeFunction(opcodeData->monitorChangeFunction);
     }
 
     m_monitors.push_back(monitor);
@@ -1874,6 +2103,26 @@ void Engine::updateFrameDuration()
     m_frameDuration = std::chrono::milliseconds(static_cast<long>(1000 / m_fps));
 }
 
+void Engine::renderAudio()
+{
+    if (!m_audioEngine->isOffline())
+        return;
+
+    // Advance the mixer by exactly one frame (keep the fraction for the next frame)
+    const double frames = m_audioEngine->sampleRate() / m_fps + m_audioFrameRemainder;
+    const size_t frameCount = frames;
+    m_audioFrameRemainder = frames - frameCount;
+
+    if (frameCount == 0)
+        return;
+
+    const unsigned int channels = m_audioEngine->channelCount();
+    const size_t oldSize = m_renderedAudio.size();
+    m_renderedAudio.resize(oldSize + frameCount * channels);
+    size_t rendered = m_audioEngine->render(m_renderedAudio.data() + oldSize, frameCount);
+    m_renderedAudio.resize(oldSize + rendered * channels);
+}
+
 void Engine::addRunningScript(std::shared_ptr<Thread> thread)
 {
     m_threads.push_back(thread);
@@ -1953,7 +2202,7 @@ template<typename F>
 void Engine::allScriptsByOpcodeDo(HatType hatType, F &&f, Target *optTarget)
 {
     // https://github.com/scratchfoundation/scratch-vm/blob/f1aa92fad79af17d9dd1c41eeeadca099339a9f1/src/engine/runtime.js#L1797-L1809
-    std::vector<Drawable *> *drawablesPtr = &m_sortedDrawables;
+    const std::vector<Drawable *> *drawablesPtr = &m_sortedDrawables.items();
 
     if (optTarget)
         drawablesPtr = new std::vector<Drawable *>({ optTarget });
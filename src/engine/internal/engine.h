@@ -5,14 +5,19 @@
 #include <scratchcpp/iengine.h>
 #include <scratchcpp/target.h>
 #include <scratchcpp/itimer.h>
+#include <scratchcpp/valuedata.h>
+#include <scratchcpp/keyevent.h>
 #include <unordered_map>
 #include <memory>
 #include <chrono>
 #include <mutex>
 #include <set>
 #include <variant>
+#include <string_view>
+#include <bitset>
 
 #include "test_export.h"
+#include "layerlist.h"
 
 namespace libscratchcpp
 {
@@ -49,6 +54,12 @@ class LIBSCRATCHCPP_TEST_EXPORT Engine : public IEngine
         virtual double globalVolume() const override;
         virtual void setGlobalVolume(double volume) override;
 
+        const std::vector<float> &renderedAudio() const override;
+        unsigned int renderedAudioSampleRate() const override;
+        unsigned int renderedAudioChannels() const override;
+        void clearRenderedAudio() override;
+        bool saveRenderedAudio(const std::string &fileName) const override;
+
         void updateMonitors() override;
         void step() override;
         void run() override;
@@ -68,6 +79,7 @@ class LIBSCRATCHCPP_TEST_EXPORT Engine : public IEngine
         void setTurboModeEnabled(bool turboMode) override;
 
         bool keyPressed(const std::string &name) const override;
+        bool keyPressed(unsigned int keyCode) const override;
         void setKeyState(const std::string &name, bool pressed) override;
         void setKeyState(const KeyEvent &event, bool pressed) override;
         void setAnyKeyPressed(bool pressed) override;
@@ -102,6 +114,11 @@ class LIBSCRATCHCPP_TEST_EXPORT Engine : public IEngine
         bool spriteFencingEnabled() const override;
         void setSpriteFencingEnabled(bool enable) override;
 
+        bool collisionCacheEnabled() const override;
+        void setCollisionCacheEnabled(bool enable) override;
+
+        unsigned int frameCount() const override;
+
         void requestRedraw() override;
 
         ITimer *timer() const override;
@@ -117,6 +134,7 @@ class LIBSCRATCHCPP_TEST_EXPORT Engine : public IEngine
         void setBroadcasts(const std::vector<std::shared_ptr<Broadcast>> &broadcasts) override;
         std::shared_ptr<Broadcast> broadcastAt(int index) const override;
         std::vector<int> findBroadcasts(const std::string &broadcastName) const override;
+        const std::vector<int> &findBroadcasts(const StringPtr *broadcastName) const override;
         int findBroadcastById(const std::string &broadcastId) const override;
 
         void addWhenTouchingObjectScript(Block *hatBlock) override;
@@ -133,6 +151,7 @@ class LIBSCRATCHCPP_TEST_EXPORT Engine : public IEngine
         Target *targetAt(int index) const override;
         void getVisibleTargets(std::vector<Target *> &dst) const override;
         int findTarget(const std::string &targetName) const override;
+        int findTarget(const StringPtr *targetName) const override;
 
         void moveDrawableToFront(Drawable *drawable) override;
         void moveDrawableToBack(Drawable *drawable) override;
@@ -187,14 +206,34 @@ class LIBSCRATCHCPP_TEST_EXPORT Engine : public IEngine
             WhenGreaterThanMenu
         };
 
+        // Monitors of a target which are compiled into one module and evaluated using a single call
+        struct MonitorBatch
+        {
+                Target *target = nullptr;
+                std::shared_ptr<CompilerContext> ctx;
+                std::shared_ptr<Thread> thread;
+                std::vector<Monitor *> monitors;
+                std::unique_ptr<bool[]> mask;
+                std::vector<ValueData> results;
+        };
+
+        struct OpcodeData
+        {
+                IExtension *extension = nullptr; // the extension which registered the compile function
+                BlockComp compileFunction = nullptr;
+                HatPredicateCompileFunc hatPredicateCompileFunction = nullptr;
+                MonitorNameFunc monitorNameFunction = nullptr;
+                MonitorChangeFunc monitorChangeFunction = nullptr;
+        };
+
         void clearExtensionData();
-        IExtension *blockExtension(const std::string &opcode) const;
-        BlockComp resolveBlockCompileFunc(IExtension *extension, const std::string &opcode) const;
-        HatPredicateCompileFunc resolveHatPredicateCompileFunc(IExtension *extension, const std::string &opcode) const;
-        MonitorNameFunc resolveMonitorNameFunc(IExtension *extension, const std::string &opcode) const;
-        MonitorChangeFunc resolveMonitorChangeFunc(IExtension *extension, const std::string &opcode) const;
+        OpcodeData &opcodeEntry(const std::string &opcode);
+        const OpcodeData *resolveOpcode(unsigned int opcodeId) const;
 
-        void compileMonitor(std::shared_ptr<Monitor> monitor);
+        void compileMonitor(std::shared_ptr<Monitor> monitor, bool batch = false);
+        void initMonitorBatches();
+        void clearMonitorBatches();
+        ValueData runMonitorReporter(Monitor *monitor);
 
         std::vector<std::shared_ptr<Thread>> stepThreads();
         void stepThread(std::shared_ptr<Thread> thread);
@@ -202,6 +241,7 @@ class LIBSCRATCHCPP_TEST_EXPORT Engine : public IEngine
         void deleteClones();
         void removeExecutableClones();
         void addVarOrListMonitor(std::shared_ptr<Monitor> monitor, Target *target);
+        void buildEntityIndex();
         std::shared_ptr<Block> getBlock(const std::string &id, Target *target);
         std::shared_ptr<Variable> getVariable(const std::string &id, Target *target);
         std::shared_ptr<List> getList(const std::string &id, Target *target);
@@ -212,10 +252,10 @@ class LIBSCRATCHCPP_TEST_EXPORT Engine : public IEngine
         void addHatToMap(std::unordered_map<Target *, std::vector<Script *>> &map, Script *script);
         void addHatField(Script *script, HatField hatField, Field *targetField);
         const std::vector<libscratchcpp::Script *> &getHats(Target *target, HatType type);
-
-        void updateDrawableLayerOrder();
+        void updateTargetNameIndex() const;
 
         void updateFrameDuration();
+        void renderAudio();
         void addRunningScript(std::shared_ptr<Thread> thread);
 
         void addBroadcastPromise(Broadcast *broadcast, Thread *sender, bool wait);
@@ -233,15 +273,25 @@ class LIBSCRATCHCPP_TEST_EXPORT Engine : public IEngine
         static const std::unordered_map<HatType, bool> m_hatEdgeActivated;          // used to check whether a hat is edge-activated (runs when a predicate becomes true)
 
         std::vector<std::shared_ptr<Target>> m_targets;
+        mutable std::vector<std::u16string> m_targetNames;
+        mutable std::unordered_map<std::u16string_view, int> m_targetNameIndex; // UTF-16 name -> index (views of m_targetNames)
+        mutable unsigned int m_targetNameGeneration = 0;                        // rebuild the index when a target is renamed
         std::unordered_map<Target *, std::shared_ptr<CompilerContext>> m_compilerContexts;
         std::unordered_map<Monitor *, std::shared_ptr<CompilerContext>> m_monitorCompilerContexts; // TODO: Use shared_ptr in (LLVM)ExecutableCode and remove these maps (might not be a good idea)
+        std::vector<MonitorBatch> m_monitorBatches;
         std::vector<std::shared_ptr<Broadcast>> m_broadcasts;
+        std::unordered_map<std::string, int> m_broadcastIndex;                 // ID -> index
+        std::unordered_map<std::u16string, std::vector<int>> m_broadcastNameMap; // lowercase name -> indices
+        std::unordered_map<std::string, Target *> m_blockTargets; // ID -> target (used while resolving IDs)
+        std::unordered_map<std::string, Target *> m_variableTargets;
+        std::unordered_map<std::string, Target *> m_listTargets;
+        std::unordered_map<std::string, Target *> m_commentTargets;
         std::unordered_map<Broadcast *, std::vector<Script *>> m_broadcastMap;
         std::unordered_map<Broadcast *, std::vector<Script *>> m_backdropBroadcastMap;
         std::unordered_map<Broadcast *, Thread *> m_broadcastSenders; // used for resolving broadcast promises
         std::vector<std::shared_ptr<Monitor>> m_monitors;
         std::vector<std::string> m_extensions;
-        std::vector<Drawable *> m_sortedDrawables; // sorted by layer (reverse order of execution)
+        LayerList m_sortedDrawables; // sorted by layer (reverse order of execution)
         std::vector<std::shared_ptr<Thread>> m_threads;
         std::vector<std::shared_ptr<Thread>> m_threadsToStop;
         std::shared_ptr<Thread> m_activeThread;
@@ -249,10 +299,7 @@ class LIBSCRATCHCPP_TEST_EXPORT Engine : public IEngine
         std::recursive_mutex m_eventLoopMutex;
         std::string m_userAgent;
 
-        std::unordered_map<IExtension *, std::unordered_map<std::string, BlockComp>> m_compileFunctions;
-        std::unordered_map<IExtension *, std::unordered_map<std::string, HatPredicateCompileFunc>> m_hatPredicateCompileFunctions;
-        std::unordered_map<IExtension *, std::unordered_map<std::string, MonitorNameFunc>> m_monitorNameFunctions;
-        std::unordered_map<IExtension *, std::unordered_map<std::string, MonitorChangeFunc>> m_monitorChangeFunctions;
+        std::vector<OpcodeData> m_opcodeTable; // indexed by opcode ID (see OpcodeRegistry)
 
         std::unordered_map<Target *, std::vector<Script *>> m_whenTouchingObjectHats;
         std::unordered_map<Target *, std::vector<Script *>> m_greenFlagHats;
@@ -260,6 +307,8 @@ class LIBSCRATCHCPP_TEST_EXPORT Engine : public IEngine
         std::unordered_map<Target *, std::vector<Script *>> m_broadcastHats;
         std::unordered_map<Target *, std::vector<Script *>> m_cloneInitHats;
         std::unordered_map<Target *, std::vector<Script *>> m_whenKeyPressedHats;
+        std::bitset<KeyEvent::CODE_COUNT> m_keyPressHatKeys; // key codes with at least one "when key pressed" hat
+        bool m_anyKeyPressHat = false;
         std::unordered_map<Target *, std::vector<Script *>> m_whenTargetClickedHats;
         std::unordered_map<Target *, std::vector<Script *>> m_whenGreaterThanHats;
 
@@ -271,8 +320,10 @@ class LIBSCRATCHCPP_TEST_EXPORT Engine : public IEngine
         ITimer *m_timer = nullptr;
         double m_fps = 30;                         // default FPS
         std::chrono::milliseconds m_frameDuration; // will be computed in step()
+        std::vector<float> m_renderedAudio;        // offline audio mixed in step()
+        double m_audioFrameRemainder = 0;          // fraction of an audio frame which didn't fit into the last step
         bool m_turboModeEnabled = false;
-        std::unordered_map<std::string, bool> m_keyMap; // holds key states
+        std::bitset<KeyEvent::CODE_COUNT> m_keyStates; // holds key states (indexed by key code)
         bool m_anyKeyPressed = false;
         double m_mouseX = 0;
         double m_mouseY = 0;
@@ -283,6 +334,8 @@ class LIBSCRATCHCPP_TEST_EXPORT Engine : public IEngine
         int m_cloneLimit = 300;
         std::set<std::shared_ptr<Sprite>> m_clones;
         bool m_spriteFencingEnabled = true;
+        bool m_collisionCacheEnabled = false;
+        unsigned int m_frameCount = 0;
 
         bool m_running = false;
         bool m_frameActivity = false;
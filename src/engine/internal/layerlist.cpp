@@ -0,0 +1,313 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include <scratchcpp/drawable.h>
+#include <cassert>
+
+#include "layerlist.h"
+#include "scratch/drawable_p.h"
+
+using namespace libscratchcpp;
+
+/*! Constructs LayerList. */
+LayerList::LayerList()
+{
+}
+
+LayerList::~LayerList()
+{
+    clear();
+}
+
+/*! Replaces the drawables in the list (sorted from back to front). */
+void LayerList::assign(const std::vector<Drawable *> &drawables)
+{
+    clear();
+
+    for (Drawable *drawable : drawables)
+        append(drawable);
+}
+
+/*! Removes all drawables from the list. */
+void LayerList::clear()
+{
+    for (auto &[drawable, node] : m_nodes)
+        drawable->impl->layerList = nullptr;
+
+    m_nodes.clear();
+    m_root = nullptr;
+    invalidate();
+}
+
+/*! Returns the number of drawables. */
+size_t LayerList::size() const
+{
+    return nodeSize(m_root);
+}
+
+/*! Returns true if there aren't any drawables. */
+bool LayerList::empty() const
+{
+    return !m_root;
+}
+
+/*! Returns true if the given drawable is in the list. */
+bool LayerList::contains(Drawable *drawable) const
+{
+    return m_nodes.find(drawable) != m_nodes.cend();
+}
+
+/*! Adds the drawable to the front (if it isn't in the list yet). */
+void LayerList::append(Drawable *drawable)
+{
+    assert(drawable);
+    auto [it, inserted] = m_nodes.try_emplace(drawable);
+
+    if (!inserted)
+        return;
+
+    // xorshift
+    m_seed ^= m_seed << 13;
+    m_seed ^= m_seed >> 17;
+    m_seed ^= m_seed << 5;
+
+    Node *node = &it->second;
+    node->drawable = drawable;
+    node->priority = m_seed;
+    m_root = merge(m_root, node);
+    m_root->parent = nullptr;
+
+    assert(!drawable->impl->layerList || drawable->impl->layerList == this);
+    drawable->impl->layerList = this;
+    invalidate();
+}
+
+/*! Removes the drawable from the list. */
+void LayerList::remove(Drawable *drawable)
+{
+    auto it = m_nodes.find(drawable);
+
+    if (it == m_nodes.end())
+        return;
+
+    detach(&it->second);
+    drawable->impl->layerList = nullptr;
+    m_nodes.erase(it);
+    invalidate();
+}
+
+/*! Removes all drawables for which the predicate returns true. */
+void LayerList::removeIf(const std::function<bool(Drawable *)> &pred)
+{
+    std::vector<Drawable *> drawables = items();
+    std::vector<Drawable *> kept;
+    kept.reserve(drawables.size());
+
+    for (Drawable *drawable : drawables) {
+        if (!pred(drawable))
+            kept.push_back(drawable);
+    }
+
+    if (kept.size() != drawables.size())
+        assign(kept);
+}
+
+/*! Moves the drawable to the given index. */
+void LayerList::move(Drawable *drawable, size_t index)
+{
+    auto it = m_nodes.find(drawable);
+
+    if (it == m_nodes.end())
+        return;
+
+    Node *node = &it->second;
+    assert(index < size());
+
+    if (indexOf(drawable) == index)
+        return;
+
+    insert(detach(node), index);
+    invalidate();
+}
+
+/*! Returns the index of the drawable (the drawable must be in the list). */
+size_t LayerList::indexOf(Drawable *drawable) const
+{
+    auto it = m_nodes.find(drawable);
+    assert(it != m_nodes.cend());
+
+    if (it == m_nodes.cend())
+        return size();
+
+    const Node *node = &it->second;
+    size_t index = nodeSize(node->left);
+
+    while (node->parent) {
+        if (node == node->parent->right)
+            index += nodeSize(node->parent->left) + 1;
+
+        node = node->parent;
+    }
+
+    return index;
+}
+
+/*! Returns the drawable at the given index. */
+Drawable *LayerList::at(size_t index) const
+{
+    Node *node = m_root;
+
+    while (node) {
+        const size_t leftSize = nodeSize(node->left);
+
+        if (index < leftSize)
+            node = node->left;
+        else if (index == leftSize)
+            return node->drawable;
+        else {
+            index -= leftSize + 1;
+            node = node->right;
+        }
+    }
+
+    return nullptr;
+}
+
+/*! Returns the drawables sorted from back to front. */
+const std::vector<Drawable *> &LayerList::items() const
+{
+    if (!m_itemsDirty)
+        return m_items;
+
+    // In-order traversal
+    m_items.clear();
+    m_items.reserve(m_nodes.size());
+    std::vector<Node *> stack;
+    Node *node = m_root;
+
+    while (node || !stack.empty()) {
+        while (node) {
+            stack.push_back(node);
+            node = node->left;
+        }
+
+        node = stack.back();
+        stack.pop_back();
+        m_items.push_back(node->drawable);
+        node = node->right;
+    }
+
+    m_itemsDirty = false;
+    return m_items;
+}
+
+/*! Sets the layer order of each drawable to its index if the list has changed since the last update. */
+void LayerList::updateLayerOrders()
+{
+    if (!m_layerOrdersDirty)
+        return;
+
+    m_layerOrdersDirty = false;
+    const auto &drawables = items();
+    std::vector<Drawable *> changed;
+
+    // Store all layer orders before notifying about the changes, so that the handlers read the new ones
+    // The first drawable (the stage) keeps its layer order
+    for (size_t i = 1; i < drawables.size(); i++) {
+        DrawablePrivate *impl = drawables[i]->impl.get();
+
+        if (impl->layerOrder != i) {
+            impl->layerOrder = i;
+            changed.push_back(drawables[i]);
+        }
+    }
+
+    for (Drawable *drawable : changed)
+        drawable->setLayerOrder(drawable->impl->layerOrder);
+}
+
+size_t LayerList::nodeSize(Node *node)
+{
+    return node ? node->size : 0;
+}
+
+void LayerList::update(Node *node)
+{
+    node->size = 1 + nodeSize(node->left) + nodeSize(node->right);
+
+    if (node->left)
+        node->left->parent = node;
+
+    if (node->right)
+        node->right->parent = node;
+}
+
+// Splits the tree into the first count nodes and the rest
+void LayerList::split(Node *node, size_t count, Node *&left, Node *&right)
+{
+    if (!node) {
+        left = right = nullptr;
+        return;
+    }
+
+    if (nodeSize(node->left) < count) {
+        split(node->right, count - nodeSize(node->left) - 1, node->right, right);
+        left = node;
+    } else {
+        split(node->left, count, left, node->left);
+        right = node;
+    }
+
+    update(node);
+}
+
+LayerList::Node *LayerList::merge(Node *left, Node *right)
+{
+    if (!left)
+        return right;
+
+    if (!right)
+        return left;
+
+    if (left->priority > right->priority) {
+        left->right = merge(left->right, right);
+        update(left);
+        return left;
+    } else {
+        right->left = merge(left, right->left);
+        update(right);
+        return right;
+    }
+}
+
+// Removes the node from the tree and returns it
+LayerList::Node *LayerList::detach(Node *node)
+{
+    const size_t index = indexOf(node->drawable);
+    Node *left, *mid, *right;
+    split(m_root, index, left, mid);
+    split(mid, 1, mid, right);
+    assert(mid == node);
+
+    m_root = merge(left, right);
+
+    if (m_root)
+        m_root->parent = nullptr;
+
+    node->left = node->right = node->parent = nullptr;
+    node->size = 1;
+    return node;
+}
+
+void LayerList::insert(Node *node, size_t index)
+{
+    Node *left, *right;
+    split(m_root, index, left, right);
+    m_root = merge(merge(left, node), right);
+    m_root->parent = nullptr;
+}
+
+void LayerList::invalidate()
+{
+    m_itemsDirty = true;
+    m_layerOrdersDirty = true;
+}
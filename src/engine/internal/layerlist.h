@@ -0,0 +1,75 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <functional>
+
+#include "test_export.h"
+
+namespace libscratchcpp
+{
+
+class Drawable;
+
+/*!
+ * \brief The LayerList class holds drawables sorted by layer (the first one is at the back).
+ *
+ * It's an order-statistic tree, so moving a drawable to another layer takes O(log n) time.
+ * Layer orders of the drawables are updated lazily, when any of them is read or when updateLayerOrders() is called.
+ */
+class LIBSCRATCHCPP_TEST_EXPORT LayerList
+{
+    public:
+        LayerList();
+        LayerList(const LayerList &) = delete;
+        ~LayerList();
+
+        void assign(const std::vector<Drawable *> &drawables);
+        void clear();
+
+        size_t size() const;
+        bool empty() const;
+        bool contains(Drawable *drawable) const;
+
+        void append(Drawable *drawable);
+        void remove(Drawable *drawable);
+        void removeIf(const std::function<bool(Drawable *)> &pred);
+        void move(Drawable *drawable, size_t index);
+
+        size_t indexOf(Drawable *drawable) const;
+        Drawable *at(size_t index) const;
+        const std::vector<Drawable *> &items() const;
+
+        void updateLayerOrders();
+
+    private:
+        struct Node
+        {
+                Drawable *drawable = nullptr;
+                Node *left = nullptr;
+                Node *right = nullptr;
+                Node *parent = nullptr;
+                unsigned int priority = 0;
+                size_t size = 1;
+        };
+
+        static size_t nodeSize(Node *node);
+        static void update(Node *node);
+        static void split(Node *node, size_t count, Node *&left, Node *&right);
+        static Node *merge(Node *left, Node *right);
+
+        Node *detach(Node *node);
+        void insert(Node *node, size_t index);
+        void invalidate();
+
+        std::unordered_map<Drawable *, Node> m_nodes;
+        Node *m_root = nullptr;
+        unsigned int m_seed = 0x9e3779b9;
+        mutable std::vector<Drawable *> m_items;
+        mutable bool m_itemsDirty = false;
+        bool m_layerOrdersDirty = false;
+};
+
+} // namespace libscratchcpp
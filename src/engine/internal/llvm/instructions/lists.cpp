@@ -152,6 +152,7 @@ LLVMInstruction *Lists::buildAppendToList(LLVMInstruction *ins)
     llvm::Value *itemPtr = m_utils.getListItem(listPtr, size);
     m_utils.createValueStore(itemPtr, m_utils.getValueTypePtr(itemPtr), isIntVar, intVar, arg.second, type);
     m_builder.CreateStore(m_builder.CreateAdd(size, m_builder.getInt64(1)), listPtr.sizePtr); // update size stored in *sizePtr
+    createListVersionUpdate(listPtr); // appendEmpty() takes care of this in the other branch
     m_builder.CreateBr(nextBlock);
 
     // Otherwise call appendEmpty()
@@ -258,6 +259,7 @@ LLVMInstruction *Lists::buildListReplace(LLVMInstruction *ins)
     // Value store may change type, make sure to update it
     loadedType = m_builder.CreateLoad(m_builder.getInt32Ty(), typeVar);
     m_builder.CreateStore(loadedType, typePtr);
+    createListVersionUpdate(listPtr);
 
     createListTypeUpdate(listPtr, valueArg.second, type);
     m_builder.CreateBr(nextBlock);
@@ -385,6 +387,13 @@ llvm::Value *Lists::createIndexRangeCheck(const LLVMListPtr &listPtr, llvm::Valu
     return m_builder.CreateCall(expectIntrinsic, { inRange, m_builder.getInt1(true) });
 }
 
+void Lists::createListVersionUpdate(const LLVMListPtr &listPtr)
+{
+    // Bump the version so that monitors know the list has changed
+    llvm::Value *version = m_builder.CreateLoad(m_builder.getInt32Ty(), listPtr.versionPtr);
+    m_builder.CreateStore(m_builder.CreateAdd(version, m_builder.getInt32(1)), listPtr.versionPtr);
+}
+
 void Lists::createListTypeUpdate(const LLVMListPtr &listPtr, const LLVMRegister *newValue, Compiler::StaticType newValueType)
 {
     if (listPtr.hasNumber && listPtr.hasBool && listPtr.hasString) {
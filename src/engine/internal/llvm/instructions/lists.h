@@ -36,6 +36,7 @@ class Lists : public InstructionGroup
 
         llvm::Value *createIndexRangeCheck(const LLVMListPtr &listPtr, llvm::Value *index, const std::string &name, bool includeSize = false);
 
+        void createListVersionUpdate(const LLVMListPtr &listPtr);
         void createListTypeUpdate(const LLVMListPtr &listPtr, const LLVMRegister *newValue, Compiler::StaticType newValueType);
         llvm::Value *createListTypeVar(const LLVMListPtr &listPtr, llvm::Value *type);
         void createListTypeAssumption(const LLVMListPtr &listPtr, llvm::Value *typeVar, Compiler::StaticType staticType, llvm::Value *inRange = nullptr);
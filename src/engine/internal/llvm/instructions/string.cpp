@@ -4,6 +4,7 @@
 #include "../llvminstruction.h"
 #include "../llvmbuildutils.h"
 #include "../llvmcompilercontext.h"
+#include "../llvmvariableptr.h"
 
 using namespace libscratchcpp;
 using namespace libscratchcpp::llvmins;
@@ -36,10 +37,99 @@ ProcessResult String::process(LLVMInstruction *ins)
 LLVMInstruction *String::buildStringConcat(LLVMInstruction *ins)
 {
     assert(ins->args.size() == 2);
+
+    if (isSelfAppend(ins))
+        return buildSelfAppend(ins);
+
     const auto &arg1 = ins->args[0];
     const auto &arg2 = ins->args[1];
     llvm::Value *str1 = m_utils.castValue(arg1.second, arg1.first);
     llvm::Value *str2 = m_utils.castValue(arg2.second, arg2.first);
+    ins->functionReturnReg->value = createConcat(str1, str2);
+
+    return ins->next;
+}
+
+LLVMInstruction *String::buildSelfAppend(LLVMInstruction *ins)
+{
+    // set var to (join var str) => append str to the string of var in place
+    // This avoids copying the whole accumulated string in every iteration of a loop
+    LLVMInstruction *writeIns = ins->next;
+    const auto &arg1 = ins->args[0];
+    const auto &arg2 = ins->args[1];
+    const auto &writeArg = writeIns->args[0];
+    LLVMVariablePtr &varPtr = m_utils.variablePtr(writeIns->targetVariable);
+    llvm::Value *typePtr = m_utils.getValueTypePtr(varPtr.stackPtr);
+    llvm::Value *str2 = m_utils.castValue(arg2.second, arg2.first);
+
+    llvm::LLVMContext &llvmCtx = m_utils.llvmCtx();
+    llvm::Function *function = m_utils.function();
+    llvm::BasicBlock *appendBlock = llvm::BasicBlock::Create(llvmCtx, "", function);
+    llvm::BasicBlock *concatBlock = nullptr;
+    llvm::BasicBlock *nextBlock = llvm::BasicBlock::Create(llvmCtx, "", function);
+
+    if (writeIns->targetType == Compiler::StaticType::String)
+        m_builder.CreateBr(appendBlock);
+    else {
+        // The variable doesn't have to contain a string at this point
+        concatBlock = llvm::BasicBlock::Create(llvmCtx, "", function);
+        llvm::Value *type = m_builder.CreateLoad(m_builder.getInt32Ty(), typePtr);
+        llvm::Value *isString = m_builder.CreateICmpEQ(type, m_builder.getInt32(static_cast<uint32_t>(ValueType::String)));
+        m_builder.CreateCondBr(isString, appendBlock, concatBlock);
+    }
+
+    // string_append(var->stringValue, str)
+    m_builder.SetInsertPoint(appendBlock);
+    llvm::Value *ptr = m_builder.CreateStructGEP(m_utils.compilerCtx()->valueDataType(), varPtr.stackPtr, 0);
+    llvm::Value *varString = m_builder.CreateLoad(m_utils.compilerCtx()->stringPtrType()->getPointerTo(), ptr);
+    m_builder.CreateCall(m_utils.functions().resolve_string_append(), { varString, str2 });
+    m_builder.CreateBr(nextBlock);
+
+    if (concatBlock) {
+        // Regular concatenation and variable write
+        m_builder.SetInsertPoint(concatBlock);
+        llvm::Value *str1 = m_utils.castValue(arg1.second, arg1.first);
+        ins->functionReturnReg->value = createConcat(str1, str2);
+        Compiler::StaticType argType = m_utils.optimizeRegisterType(writeArg.second);
+        m_utils.createValueStore(varPtr.stackPtr, typePtr, varPtr.isInt, varPtr.intValue, writeArg.second, writeIns->targetType, argType);
+        m_builder.CreateBr(nextBlock);
+    }
+
+    m_builder.SetInsertPoint(nextBlock);
+    m_builder.CreateStore(m_builder.getInt1(true), varPtr.changed);
+
+    return writeIns->next;
+}
+
+bool String::isSelfAppend(LLVMInstruction *ins) const
+{
+    // Matches: ReadVariable(var) ... StringConcat(read, str) -> WriteVariable(var, concat)
+    LLVMInstruction *writeIns = ins->next;
+
+    if (!writeIns || writeIns->type != LLVMInstruction::Type::WriteVariable || writeIns->args.size() != 1 || writeIns->args[0].second != ins->functionReturnReg)
+        return false;
+
+    if ((writeIns->targetType & Compiler::StaticType::String) != Compiler::StaticType::String)
+        return false;
+
+    const LLVMRegister *reg = ins->args[0].second;
+
+    if (!reg->instruction || reg->instruction->type != LLVMInstruction::Type::ReadVariable || reg->instruction->targetVariable != writeIns->targetVariable)
+        return false;
+
+    // The result of the concatenation must not be used anywhere else
+    for (LLVMInstruction *next = writeIns->next; next; next = next->next) {
+        for (const auto &arg : next->args) {
+            if (arg.second == ins->functionReturnReg)
+                return false;
+        }
+    }
+
+    return true;
+}
+
+llvm::Value *String::createConcat(llvm::Value *str1, llvm::Value *str2)
+{
     llvm::PointerType *charPointerType = m_builder.getInt16Ty()->getPointerTo();
     llvm::StructType *stringPtrType = m_utils.compilerCtx()->stringPtrType();
     llvm::Function *memcpyFunc = llvm::Intrinsic::getDeclaration(m_utils.module(), llvm::Intrinsic::memcpy_inline, { charPointerType, charPointerType, m_builder.getInt64Ty() });
@@ -73,9 +163,7 @@ LLVMInstruction *String::buildStringConcat(LLVMInstruction *ins)
     writePtr = m_builder.CreateGEP(m_builder.getInt16Ty(), writePtr, size1);
     m_builder.CreateCall(memcpyFunc, { writePtr, data2, m_builder.CreateMul(m_builder.CreateAdd(size2, m_builder.getInt64(1)), m_builder.getInt64(2)), m_builder.getInt1(false) });
 
-    ins->functionReturnReg->value = result;
-
-    return ins->next;
+    return result;
 }
 
 LLVMInstruction *String::buildStringChar(LLVMInstruction *ins)
@@ -18,6 +18,10 @@ class String : public InstructionGroup
         LLVMInstruction *buildStringConcat(LLVMInstruction *ins);
         LLVMInstruction *buildStringChar(LLVMInstruction *ins);
         LLVMInstruction *buildStringLength(LLVMInstruction *ins);
+
+        LLVMInstruction *buildSelfAppend(LLVMInstruction *ins);
+        bool isSelfAppend(LLVMInstruction *ins) const;
+        llvm::Value *createConcat(llvm::Value *str1, llvm::Value *str2);
 };
 
 } // namespace libscratchcpp::llvmins
@@ -118,10 +118,15 @@ void LLVMBuildUtils::init(llvm::Function *function, BlockPrototype *procedurePro
     m_stringAllocaNextBlock = llvm::BasicBlock::Create(m_llvmCtx, "entry.next", m_function);
     m_builder.SetInsertPoint(m_stringAllocaNextBlock);
 
+    // Get variable versions (used to track changes of local sprite variables, including clones)
+    if (!m_variablePtrs.empty() && !m_target->isStage())
+        m_targetVariableVersions = m_builder.CreateCall(m_functions.resolve_llvm_get_variable_versions(), m_targetPtr);
+
     // Create variable pointers
     for (auto &[var, varPtr] : m_variablePtrs) {
         llvm::Value *ptr = getVariablePtr(m_targetVariables, var);
         varPtr.heapPtr = ptr;
+        varPtr.versionPtr = getVariableVersionPtr(m_targetVariableVersions, var);
 
         // Store variables locally to enable optimizations
         varPtr.stackPtr = m_builder.CreateAlloca(m_valueDataType);
@@ -143,6 +148,7 @@ void LLVMBuildUtils::init(llvm::Function *function, BlockPrototype *procedurePro
 
         listPtr.sizePtr = m_builder.CreateCall(m_functions.resolve_list_size_ptr(), listPtr.ptr);
         listPtr.allocatedSizePtr = m_builder.CreateCall(m_functions.resolve_list_alloc_size_ptr(), listPtr.ptr);
+        listPtr.versionPtr = m_builder.CreateCall(m_functions.resolve_list_version_ptr(), listPtr.ptr);
 
         if (m_warp) {
             // Store list size locally to allow some optimizations
@@ -459,6 +465,10 @@ void LLVMBuildUtils::syncVariables()
         m_builder.SetInsertPoint(copyBlock);
         createValueCopy(varPtr.stackPtr, getVariablePtr(m_targetVariables, var));
         m_builder.CreateStore(m_builder.getInt1(false), varPtr.changed);
+
+        // Bump the version so that monitors know the value has changed
+        llvm::Value *version = m_builder.CreateLoad(m_builder.getInt32Ty(), varPtr.versionPtr);
+        m_builder.CreateStore(m_builder.CreateAdd(version, m_builder.getInt32(1)), varPtr.versionPtr);
         m_builder.CreateBr(nextBlock);
 
         m_builder.SetInsertPoint(nextBlock);
@@ -1686,7 +1696,16 @@ llvm::Constant *LLVMBuildUtils::castConstValue(const Value &value, Compiler::Sta
             llvm::Module &module = *m_ctx->module();
 
             llvm::Constant *globalStr = new llvm::GlobalVariable(module, arrayType, true, llvm::GlobalValue::PrivateLinkage, constArray, "string");
-            llvm::Constant *stringStruct = llvm::ConstantStruct::get(m_stringPtrType, { globalStr, m_builder.getInt64(str.size()), m_builder.getInt64(str.size() + 1) });
+            llvm::Constant *inlineData = llvm::ConstantAggregateZero::get(m_stringPtrType->getElementType(3)); // unused (the data is in globalStr)
+
+            // Convert to number at compile time (the string is read-only, so the cache can't be filled later)
+            StringPtr stringPtr(value.toString());
+            bool ok;
+            value_stringToDoubleWithCheck(&stringPtr, &ok);
+            llvm::Constant *numberValue = llvm::ConstantFP::get(m_builder.getDoubleTy(), stringPtr.numberValue);
+            llvm::Constant *numberState = m_builder.getInt32(static_cast<int>(stringPtr.numberState));
+
+            llvm::Constant *stringStruct = llvm::ConstantStruct::get(m_stringPtrType, { globalStr, m_builder.getInt64(str.size()), m_builder.getInt64(str.size() + 1), inlineData, numberValue, numberState });
             return new llvm::GlobalVariable(module, m_stringPtrType, true, llvm::GlobalValue::PrivateLinkage, stringStruct, "stringPtr");
         }
 
@@ -1708,9 +1727,39 @@ std::pair<llvm::Value *, llvm::Value *> LLVMBuildUtils::callStringToDoubleWithCh
         double ret = value_stringToDoubleWithCheck(reg->constValue().data().stringValue, &ok);
         return { llvm::ConstantFP::get(m_builder.getDoubleTy(), ret), m_builder.getInt1(ok) };
     } else {
+        llvm::BasicBlock *cachedBlock = llvm::BasicBlock::Create(m_llvmCtx, "", m_function);
+        llvm::BasicBlock *convertBlock = llvm::BasicBlock::Create(m_llvmCtx, "", m_function);
+        llvm::BasicBlock *nextBlock = llvm::BasicBlock::Create(m_llvmCtx, "", m_function);
         llvm::Value *okPtr = addAlloca(m_builder.getInt1Ty());
-        llvm::Value *ret = m_builder.CreateCall(m_functions.resolve_value_stringToDoubleWithCheck(), { stringPtr, okPtr });
-        llvm::Value *ok = m_builder.CreateLoad(m_builder.getInt1Ty(), okPtr);
+
+        // if (string->numberState != Unknown)
+        llvm::Value *numberStatePtr = m_builder.CreateStructGEP(m_stringPtrType, stringPtr, 5);
+        llvm::Value *numberState = m_builder.CreateLoad(m_builder.getInt32Ty(), numberStatePtr);
+        llvm::Value *isCached = m_builder.CreateICmpNE(numberState, m_builder.getInt32(static_cast<int>(StringPtr::NumberState::Unknown)));
+        m_builder.CreateCondBr(isCached, cachedBlock, convertBlock);
+
+        // The string has already been converted to a number
+        m_builder.SetInsertPoint(cachedBlock);
+        llvm::Value *numberValuePtr = m_builder.CreateStructGEP(m_stringPtrType, stringPtr, 4);
+        llvm::Value *cachedRet = m_builder.CreateLoad(m_builder.getDoubleTy(), numberValuePtr);
+        llvm::Value *cachedOk = m_builder.CreateICmpEQ(numberState, m_builder.getInt32(static_cast<int>(StringPtr::NumberState::Valid)));
+        m_builder.CreateBr(nextBlock);
+
+        // Convert (this caches the result in the string)
+        m_builder.SetInsertPoint(convertBlock);
+        llvm::Value *convertedRet = m_builder.CreateCall(m_functions.resolve_value_stringToDoubleWithCheck(), { stringPtr, okPtr });
+        llvm::Value *convertedOk = m_builder.CreateLoad(m_builder.getInt1Ty(), okPtr);
+        m_builder.CreateBr(nextBlock);
+
+        m_builder.SetInsertPoint(nextBlock);
+        llvm::PHINode *ret = m_builder.CreatePHI(m_builder.getDoubleTy(), 2);
+        ret->addIncoming(cachedRet, cachedBlock);
+        ret->addIncoming(convertedRet, convertBlock);
+
+        llvm::PHINode *ok = m_builder.CreatePHI(m_builder.getInt1Ty(), 2);
+        ok->addIncoming(cachedOk, cachedBlock);
+        ok->addIncoming(convertedOk, convertBlock);
+
         return { ret, ok };
     }
 }
@@ -2232,6 +2281,22 @@ llvm::Value *LLVMBuildUtils::getVariablePtr(llvm::Value *targetVariables, Variab
     return m_builder.CreateIntToPtr(addr, m_valueDataType->getPointerTo());
 }
 
+llvm::Value *LLVMBuildUtils::getVariableVersionPtr(llvm::Value *targetVariableVersions, Variable *variable)
+{
+    if (!m_target->isStage() && variable->target() == m_target) {
+        // If this is a local sprite variable, use the version array at runtime (for clones)
+        assert(targetVariableVersions);
+        assert(m_targetVariableMap.find(variable) != m_targetVariableMap.cend());
+        const size_t index = m_targetVariableMap[variable];
+        llvm::Value *ptr = m_builder.CreateGEP(m_builder.getInt32Ty()->getPointerTo(), targetVariableVersions, m_builder.getInt64(index));
+        return m_builder.CreateLoad(m_builder.getInt32Ty()->getPointerTo(), ptr);
+    }
+
+    // Otherwise create a raw pointer at compile time
+    llvm::Value *addr = m_builder.getInt64((uintptr_t)variable->versionPtr());
+    return m_builder.CreateIntToPtr(addr, m_builder.getInt32Ty()->getPointerTo());
+}
+
 llvm::Value *LLVMBuildUtils::getListPtr(llvm::Value *targetLists, List *list)
 {
     if (!m_target->isStage() && list->target() == m_target) {
@@ -157,6 +157,7 @@ class LIBSCRATCHCPP_TEST_EXPORT LLVMBuildUtils
         llvm::Value *createStringsEqualComparison(llvm::Value *stringPtr1, llvm::Value *stringPtr2, bool caseSensitive);
 
         llvm::Value *getVariablePtr(llvm::Value *targetVariables, Variable *variable);
+        llvm::Value *getVariableVersionPtr(llvm::Value *targetVariableVersions, Variable *variable);
         llvm::Value *getListPtr(llvm::Value *targetLists, List *list);
         llvm::Value *getListDataPtr(const LLVMListPtr &listPtr);
 
@@ -186,6 +187,7 @@ class LIBSCRATCHCPP_TEST_EXPORT LLVMBuildUtils
         llvm::Value *m_targetPtr = nullptr;
         llvm::Value *m_targetVariables = nullptr;
         llvm::Value *m_targetLists = nullptr;
+        llvm::Value *m_targetVariableVersions = nullptr;
         llvm::Value *m_warpArg = nullptr;
         llvm::Value *m_targetValidFlag = nullptr;
 
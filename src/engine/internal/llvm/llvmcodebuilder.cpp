@@ -93,6 +93,10 @@ std::shared_ptr<ExecutableCode> LLVMCodeBuilder::build()
     m_utils.end(m_instructions.empty() ? nullptr : m_instructions.last(), m_lastConstValue);
     verifyFunction(m_function);
 
+    // Only reporters of monitor contexts are run in a batch
+    if (m_codeType == Compiler::CodeType::Reporter && m_ctx->reporterBatchEnabled())
+        m_ctx->addReporterFunction(m_function);
+
     return std::make_shared<LLVMExecutableCode>(m_ctx, m_utils.scriptFunctionId(), m_function->getName().str(), m_ctx->coroutineResumeFunction()->getName().str(), m_utils.stringCount(), m_codeType);
 }
 
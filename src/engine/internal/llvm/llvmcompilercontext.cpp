@@ -8,12 +8,15 @@
 
 #include <scratchcpp/target.h>
 #include <scratchcpp/blockprototype.h>
+#include <scratchcpp/thread.h>
 #include <iostream>
+#include <algorithm>
 
 #include "llvmcompilercontext.h"
 #include "llvmcoroutine.h"
 #include "llvmtypes.h"
 #include "llvmexecutablecode.h"
+#include "llvmexecutioncontext.h"
 
 using namespace libscratchcpp;
 
@@ -45,6 +48,24 @@ void LLVMCompilerContext::preoptimize()
     initJit();
 }
 
+bool LLVMCompilerContext::runReporters(Thread *thread, const bool *mask, ValueData *results)
+{
+    assert(thread);
+
+    if (!m_jitInitialized)
+        initJit();
+
+    if (!m_reporterBatchFunction)
+        return false;
+
+    if (!m_reporterBatchExecutionContext || m_reporterBatchExecutionContext->thread() != thread)
+        m_reporterBatchExecutionContext = std::make_shared<LLVMExecutionContext>(this, thread);
+
+    Target *target = thread->target();
+    m_reporterBatchFunction(m_reporterBatchExecutionContext.get(), target, target->variableData(), target->listData(), mask, results);
+    return true;
+}
+
 llvm::LLVMContext *LLVMCompilerContext::llvmCtx()
 {
     return m_llvmCtxPtr;
@@ -66,6 +87,12 @@ const std::unordered_map<function_id_t, LLVMExecutableCode *> &LLVMCompilerConte
     return m_codeMap;
 }
 
+void LLVMCompilerContext::addReporterFunction(llvm::Function *function)
+{
+    assert(std::find(m_reporterFunctions.begin(), m_reporterFunctions.end(), function) == m_reporterFunctions.end());
+    m_reporterFunctions.push_back(function);
+}
+
 void LLVMCompilerContext::addDefinedProcedure(BlockPrototype *prototype)
 {
     m_definedProcedures.insert(prototype);
@@ -103,6 +130,10 @@ void LLVMCompilerContext::initJit()
     // Define shims for missing procedures
     createProcedureShims();
 
+    // Create the entry point for running all reporters at once
+    if (!m_reporterFunctions.empty())
+        m_reporterBatchFunctionName = createReporterBatchFunction()->getName().str();
+
     // Optimize
     optimize(llvm::OptimizationLevel::O3);
 
@@ -134,6 +165,12 @@ void LLVMCompilerContext::initJit()
     // Lookup coro_destroy()
     m_coroDestroyFunction = lookupFunction<DestroyCoroFuncType>(coroDestroyFuncName);
     assert(m_coroDestroyFunction);
+
+    // Lookup the reporter batch function
+    if (!m_reporterBatchFunctionName.empty()) {
+        m_reporterBatchFunction = lookupFunction<ReporterBatchFuncType>(m_reporterBatchFunctionName);
+        assert(m_reporterBatchFunction);
+    }
 }
 
 bool LLVMCompilerContext::jitInitialized() const
@@ -306,6 +343,46 @@ llvm::Function *LLVMCompilerContext::createCoroDestroyFunction()
     return func;
 }
 
+llvm::Function *LLVMCompilerContext::createReporterBatchFunction()
+{
+    llvm::IRBuilder<> builder(*m_llvmCtx);
+
+    // void reporters(ExecutionContext *, Target *, ValueData **, List **, const bool *mask, ValueData *results)
+    llvm::PointerType *pointerType = llvm::PointerType::get(llvm::Type::getInt8Ty(*m_llvmCtx), 0);
+    llvm::FunctionType *funcType = llvm::FunctionType::get(builder.getVoidTy(), { pointerType, pointerType, pointerType, pointerType, pointerType, pointerType }, false);
+    llvm::Function *func = llvm::Function::Create(funcType, llvm::Function::ExternalLinkage, "reporters", m_module.get());
+
+    llvm::BasicBlock *entry = llvm::BasicBlock::Create(*m_llvmCtx, "entry", func);
+    builder.SetInsertPoint(entry);
+
+    std::vector<llvm::Value *> args = { func->getArg(0), func->getArg(1), func->getArg(2), func->getArg(3) };
+    llvm::Value *mask = func->getArg(4);
+    llvm::Value *results = func->getArg(5);
+
+    for (size_t i = 0; i < m_reporterFunctions.size(); i++) {
+        llvm::BasicBlock *runBranch = llvm::BasicBlock::Create(*m_llvmCtx, "run", func);
+        llvm::BasicBlock *nextBranch = llvm::BasicBlock::Create(*m_llvmCtx, "next", func);
+
+        // if (mask[i])
+        llvm::Value *enabledPtr = builder.CreateGEP(builder.getInt8Ty(), mask, builder.getInt64(i));
+        llvm::Value *enabled = builder.CreateICmpNE(builder.CreateLoad(builder.getInt8Ty(), enabledPtr), builder.getInt8(0));
+        builder.CreateCondBr(enabled, runBranch, nextBranch);
+
+        // results[i] = reporter(...)
+        builder.SetInsertPoint(runBranch);
+        llvm::Value *ret = builder.CreateCall(m_reporterFunctions[i], args);
+        builder.CreateStore(ret, builder.CreateGEP(m_valueDataType, results, builder.getInt64(i)));
+        builder.CreateBr(nextBranch);
+
+        builder.SetInsertPoint(nextBranch);
+    }
+
+    builder.CreateRetVoid();
+
+    verifyFunction(func);
+    return func;
+}
+
 void LLVMCompilerContext::verifyFunction(llvm::Function *function)
 {
     if (llvm::verifyFunction(*function, &llvm::errs())) {
@@ -21,6 +21,7 @@ class ValueData;
 class List;
 class BlockPrototype;
 class LLVMExecutableCode;
+class LLVMExecutionContext;
 
 // NOTE: Change this in LLVMTypes as well
 using function_id_t = unsigned int;
@@ -31,6 +32,7 @@ class LIBSCRATCHCPP_TEST_EXPORT LLVMCompilerContext : public CompilerContext
         LLVMCompilerContext(IEngine *engine, Target *target);
 
         void preoptimize() override;
+        bool runReporters(Thread *thread, const bool *mask, ValueData *results) override;
 
         llvm::LLVMContext *llvmCtx();
         llvm::Module *module();
@@ -38,6 +40,8 @@ class LIBSCRATCHCPP_TEST_EXPORT LLVMCompilerContext : public CompilerContext
         void addCode(LLVMExecutableCode *code);
         const std::unordered_map<function_id_t, LLVMExecutableCode *> &codeMap() const;
 
+        void addReporterFunction(llvm::Function *function);
+
         void addDefinedProcedure(BlockPrototype *prototype);
         void addUsedProcedure(BlockPrototype *prototype, const std::string &functionName);
 
@@ -69,6 +73,7 @@ class LIBSCRATCHCPP_TEST_EXPORT LLVMCompilerContext : public CompilerContext
     private:
         using ResumeCoroFuncType = bool (*)(void *);
         using DestroyCoroFuncType = void (*)(void *);
+        using ReporterBatchFuncType = void (*)(ExecutionContext *, Target *, ValueData **, List **, const bool *, ValueData *);
 
         void initTarget();
         void createTargetMachine();
@@ -77,6 +82,7 @@ class LIBSCRATCHCPP_TEST_EXPORT LLVMCompilerContext : public CompilerContext
 
         llvm::Function *createCoroResumeFunction();
         llvm::Function *createCoroDestroyFunction();
+        llvm::Function *createReporterBatchFunction();
 
         void verifyFunction(llvm::Function *function);
 
@@ -100,6 +106,11 @@ class LIBSCRATCHCPP_TEST_EXPORT LLVMCompilerContext : public CompilerContext
         llvm::StructType *m_stringPtrType = nullptr;
         llvm::Type *m_functionIdType = nullptr;
 
+        std::vector<llvm::Function *> m_reporterFunctions;
+        std::string m_reporterBatchFunctionName;
+        ReporterBatchFuncType m_reporterBatchFunction = nullptr;
+        std::shared_ptr<LLVMExecutionContext> m_reporterBatchExecutionContext;
+
         std::unordered_set<BlockPrototype *> m_definedProcedures;
         std::unordered_map<BlockPrototype *, std::string> m_usedProcedures;
 };
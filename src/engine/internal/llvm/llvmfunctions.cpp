@@ -2,6 +2,7 @@
 
 #include <scratchcpp/value_functions.h>
 #include <scratchcpp/irandomgenerator.h>
+#include <scratchcpp/target.h>
 
 #include "llvmfunctions.h"
 #include "llvmcompilercontext.h"
@@ -45,6 +46,11 @@ extern "C"
     {
         return static_cast<LLVMExecutionContext *>(ctx)->finished();
     }
+
+    LIBSCRATCHCPP_EXPORT unsigned int **llvm_get_variable_versions(Target *target)
+    {
+        return target->variableVersionData();
+    }
 }
 
 LLVMFunctions::LLVMFunctions(LLVMCompilerContext *ctx, llvm::IRBuilder<> *builder) :
@@ -247,6 +253,15 @@ llvm::FunctionCallee LLVMFunctions::resolve_list_alloc_size_ptr()
     return callee;
 }
 
+llvm::FunctionCallee LLVMFunctions::resolve_list_version_ptr()
+{
+    llvm::Type *listPtr = llvm::PointerType::get(llvm::Type::getInt8Ty(*m_ctx->llvmCtx()), 0);
+    llvm::FunctionCallee callee = resolveFunction("list_version_ptr", llvm::FunctionType::get(m_builder->getInt32Ty()->getPointerTo(), { listPtr }, false));
+    llvm::Function *func = llvm::cast<llvm::Function>(callee.getCallee());
+    func->addFnAttr(llvm::Attribute::ReadOnly);
+    return callee;
+}
+
 llvm::FunctionCallee LLVMFunctions::resolve_list_to_string()
 {
     llvm::Type *pointerType = llvm::PointerType::get(llvm::Type::getInt8Ty(*m_ctx->llvmCtx()), 0);
@@ -304,6 +319,15 @@ llvm::FunctionCallee LLVMFunctions::resolve_llvm_is_thread_finished()
     return resolveFunction("llvm_is_thread_finished", llvm::FunctionType::get(m_builder->getInt1Ty(), { pointerType }, false));
 }
 
+llvm::FunctionCallee LLVMFunctions::resolve_llvm_get_variable_versions()
+{
+    llvm::Type *pointerType = llvm::PointerType::get(llvm::Type::getInt8Ty(*m_ctx->llvmCtx()), 0);
+    llvm::FunctionCallee callee = resolveFunction("llvm_get_variable_versions", llvm::FunctionType::get(m_builder->getInt32Ty()->getPointerTo()->getPointerTo(), { pointerType }, false));
+    llvm::Function *func = llvm::cast<llvm::Function>(callee.getCallee());
+    func->addFnAttr(llvm::Attribute::ReadOnly);
+    return callee;
+}
+
 llvm::FunctionCallee LLVMFunctions::resolve_string_pool_new()
 {
     return resolveFunction("string_pool_new", llvm::FunctionType::get(m_stringPtrType->getPointerTo(), false));
@@ -324,6 +348,11 @@ llvm::FunctionCallee LLVMFunctions::resolve_string_assign()
     return resolveFunction("string_assign", llvm::FunctionType::get(m_builder->getVoidTy(), { m_stringPtrType->getPointerTo(), m_stringPtrType->getPointerTo() }, false));
 }
 
+llvm::FunctionCallee LLVMFunctions::resolve_string_append()
+{
+    return resolveFunction("string_append", llvm::FunctionType::get(m_builder->getVoidTy(), { m_stringPtrType->getPointerTo(), m_stringPtrType->getPointerTo() }, false));
+}
+
 llvm::FunctionCallee LLVMFunctions::resolve_string_compare_case_sensitive()
 {
     llvm::Type *stringPtr = m_stringPtrType->getPointerTo();
@@ -42,6 +42,7 @@ class LLVMFunctions
         llvm::FunctionCallee resolve_list_data_ptr();
         llvm::FunctionCallee resolve_list_size_ptr();
         llvm::FunctionCallee resolve_list_alloc_size_ptr();
+        llvm::FunctionCallee resolve_list_version_ptr();
         llvm::FunctionCallee resolve_list_to_string();
         llvm::FunctionCallee resolve_llvm_random();
         llvm::FunctionCallee resolve_llvm_random_double();
@@ -50,10 +51,12 @@ class LLVMFunctions
         llvm::FunctionCallee resolve_llvm_get_string_array();
         llvm::FunctionCallee resolve_llvm_mark_thread_as_finished();
         llvm::FunctionCallee resolve_llvm_is_thread_finished();
+        llvm::FunctionCallee resolve_llvm_get_variable_versions();
         llvm::FunctionCallee resolve_string_pool_new();
         llvm::FunctionCallee resolve_string_pool_free();
         llvm::FunctionCallee resolve_string_alloc();
         llvm::FunctionCallee resolve_string_assign();
+        llvm::FunctionCallee resolve_string_append();
         llvm::FunctionCallee resolve_string_compare_case_sensitive();
         llvm::FunctionCallee resolve_string_compare_case_insensitive();
 
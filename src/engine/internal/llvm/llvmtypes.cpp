@@ -1,5 +1,6 @@
 // SPDX-License-Identifier: Apache-2.0
 
+#include <scratchcpp/stringptr.h>
 #include <llvm/IR/IRBuilder.h>
 
 #include "llvmtypes.h"
@@ -25,8 +26,11 @@ llvm::StructType *LLVMTypes::createStringPtrType(llvm::LLVMContext &ctx)
     // Create the StringPtr struct
     llvm::PointerType *pointerType = llvm::PointerType::get(llvm::Type::getInt8Ty(ctx), 0);
     llvm::Type *sizeType = llvm::Type::getInt64Ty(ctx);
+    llvm::Type *inlineDataType = llvm::ArrayType::get(llvm::Type::getInt16Ty(ctx), StringPtr::INLINE_CAPACITY);
+    llvm::Type *numberValueType = llvm::Type::getDoubleTy(ctx);
+    llvm::Type *numberStateType = llvm::Type::getInt32Ty(ctx); // StringPtr::NumberState
     llvm::StructType *ret = llvm::StructType::create(ctx, "StringPtr");
-    ret->setBody({ pointerType, sizeType, sizeType });
+    ret->setBody({ pointerType, sizeType, sizeType, inlineDataType, numberValueType, numberStateType });
 
     return ret;
 }
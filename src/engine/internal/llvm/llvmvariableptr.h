@@ -21,6 +21,7 @@ struct LLVMVariablePtr
         llvm::Value *heapPtr = nullptr;
         llvm::Value *stackPtr = nullptr;
         llvm::Value *changed = nullptr;
+        llvm::Value *versionPtr = nullptr;
 
         llvm::Value *isInt = nullptr;
         llvm::Value *intValue = nullptr;
@@ -0,0 +1,35 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include <unordered_map>
+#include <mutex>
+
+#include "opcoderegistry.h"
+
+using namespace libscratchcpp;
+
+static std::unordered_map<std::string, unsigned int> &opcodeIds()
+{
+    static std::unordered_map<std::string, unsigned int> ids;
+    return ids;
+}
+
+static std::mutex &opcodeMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+/*! Returns the ID of the given opcode (IDs are assigned in order of first use, starting at 0). */
+unsigned int OpcodeRegistry::id(const std::string &opcode)
+{
+    std::lock_guard<std::mutex> lock(opcodeMutex());
+    auto &ids = opcodeIds();
+    return ids.try_emplace(opcode, static_cast<unsigned int>(ids.size())).first->second;
+}
+
+/*! Returns the number of interned opcodes. */
+unsigned int OpcodeRegistry::count()
+{
+    std::lock_guard<std::mutex> lock(opcodeMutex());
+    return opcodeIds().size();
+}
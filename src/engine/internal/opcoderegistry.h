@@ -0,0 +1,22 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <string>
+
+#include "test_export.h"
+
+namespace libscratchcpp
+{
+
+/*! The OpcodeRegistry class interns block opcodes, i.e. assigns each distinct opcode a small integer ID. */
+class LIBSCRATCHCPP_TEST_EXPORT OpcodeRegistry
+{
+    public:
+        OpcodeRegistry() = delete;
+
+        static unsigned int id(const std::string &opcode);
+        static unsigned int count();
+};
+
+} // namespace libscratchcpp
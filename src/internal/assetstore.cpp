@@ -0,0 +1,60 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "assetstore.h"
+
+using namespace libscratchcpp;
+
+/*!
+ * Returns the shared buffer of the given file in data and returns its size.
+ * The loader is only called if there isn't a live buffer of the file yet.
+ */
+size_t AssetStore::get(const std::string &fileName, std::shared_ptr<const void> &data, const Loader &loader)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_entries.find(fileName);
+
+        if (it != m_entries.cend()) {
+            data = it->second.data.lock();
+
+            if (data)
+                return it->second.size;
+        }
+    }
+
+    // Load without holding the lock (other files can be loaded meanwhile)
+    std::shared_ptr<const void> loaded;
+    size_t size = loader(loaded);
+
+    if (!loaded) {
+        data.reset();
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Entry &entry = m_entries[fileName];
+    data = entry.data.lock();
+
+    // Another thread might have loaded the file in the meantime
+    if (data)
+        return entry.size;
+
+    entry.data = loaded;
+    entry.size = size;
+    data = loaded;
+    return size;
+}
+
+/*! Returns the number of files with a live buffer. */
+size_t AssetStore::count() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t ret = 0;
+
+    for (const auto &[fileName, entry] : m_entries) {
+        if (!entry.data.expired())
+            ret++;
+    }
+
+    return ret;
+}
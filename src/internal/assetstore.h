@@ -0,0 +1,43 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <string>
+#include <memory>
+#include <functional>
+#include <unordered_map>
+#include <mutex>
+
+#include "test_export.h"
+
+namespace libscratchcpp
+{
+
+/*!
+ * The AssetStore class holds one buffer for each asset file (identified by its md5ext file name),
+ * so that all assets referencing the same file share its data.
+ */
+class LIBSCRATCHCPP_TEST_EXPORT AssetStore
+{
+    public:
+        using Loader = std::function<size_t(std::shared_ptr<const void> &)>;
+
+        AssetStore() = default;
+        AssetStore(const AssetStore &) = delete;
+
+        size_t get(const std::string &fileName, std::shared_ptr<const void> &data, const Loader &loader);
+
+        size_t count() const;
+
+    private:
+        struct Entry
+        {
+                std::weak_ptr<const void> data; // the buffer is released with the last asset using it
+                size_t size = 0;
+        };
+
+        std::unordered_map<std::string, Entry> m_entries;
+        mutable std::mutex m_mutex;
+};
+
+} // namespace libscratchcpp
@@ -5,6 +5,8 @@
 #include <iostream>
 #include <vector>
 #include <memory>
+#include <atomic>
+#include <scratchcpp/signal.h>
 
 #ifndef NDEBUG
 #define READER_STEP(ptr, str) ptr = str
@@ -27,8 +29,17 @@ class IProjectReader
         virtual const std::string &fileName() const final { return m_fileName; }
         virtual void setFileName(const std::string &fileName) final { m_fileName = fileName; }
 
+        virtual bool lazyAssetLoading() const final { return m_lazyAssetLoading; }
+        virtual void setLazyAssetLoading(bool lazy) final { m_lazyAssetLoading = lazy; }
+
+        virtual const std::atomic<bool> *stopLoadingFlag() const final { return m_stopLoadingFlag; }
+        virtual void setStopLoadingFlag(const std::atomic<bool> *flag) final { m_stopLoadingFlag = flag; }
+
+        virtual sigslot::signal<unsigned int, unsigned int> &assetLoadProgressChanged() final { return m_assetLoadProgressChanged; }
+
         virtual bool load() = 0;
         virtual bool loadData(const std::string &data) = 0;
+        virtual bool waitForAssets() = 0;
         virtual bool isValid() = 0;
         virtual void clear() = 0;
         virtual const std::vector<std::shared_ptr<Target>> &targets() const = 0;
@@ -43,6 +54,9 @@ class IProjectReader
 
     private:
         std::string m_fileName;
+        bool m_lazyAssetLoading = false;
+        const std::atomic<bool> *m_stopLoadingFlag = nullptr;
+        sigslot::signal<unsigned int, unsigned int> m_assetLoadProgressChanged;
 };
 
 } // namespace libscratchcpp
@@ -0,0 +1,34 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <string>
+
+#include "test_export.h"
+
+namespace libscratchcpp
+{
+
+/*! The MappedFile class maps a file into memory for read-only access. */
+class LIBSCRATCHCPP_TEST_EXPORT MappedFile
+{
+    public:
+        MappedFile() = default;
+        MappedFile(const MappedFile &) = delete;
+        ~MappedFile();
+
+        bool open(const std::string &fileName);
+        void close();
+
+        const char *data() const;
+        size_t size() const;
+
+    private:
+        const char *m_data = nullptr;
+        size_t m_size = 0;
+#ifdef _WIN32
+        void *m_mapping = nullptr;
+#endif
+};
+
+} // namespace libscratchcpp
@@ -4,12 +4,14 @@
 
 #include <nlohmann/json.hpp>
 #include <string>
+#include <vector>
+#include <stdexcept>
 #include <scratchcpp/value.h>
 
 namespace libscratchcpp
 {
 
-Value jsonToValue(nlohmann::json value)
+Value jsonToValue(const nlohmann::json &value)
 {
     if (value.is_string())
         return value.get<std::string>();
@@ -25,4 +27,48 @@ Value jsonToValue(nlohmann::json value)
     }
 }
 
+// Collects the items of a flat JSON array of strings
+class StringArraySax : public nlohmann::json_sax<nlohmann::json>
+{
+    public:
+        std::vector<std::string> strings;
+
+        bool null() override { return false; }
+        bool boolean(bool) override { return false; }
+        bool number_integer(number_integer_t) override { return false; }
+        bool number_unsigned(number_unsigned_t) override { return false; }
+        bool number_float(number_float_t, const string_t &) override { return false; }
+        bool binary(binary_t &) override { return false; }
+        bool start_object(std::size_t) override { return false; }
+        bool key(string_t &) override { return false; }
+        bool end_object() override { return false; }
+
+        bool string(string_t &val) override
+        {
+            if (m_depth != 1)
+                return false;
+
+            strings.push_back(std::move(val));
+            return true;
+        }
+
+        bool start_array(std::size_t) override { return ++m_depth == 1; }
+        bool end_array() override { return --m_depth == 0; }
+        bool parse_error(std::size_t, const std::string &, const nlohmann::detail::exception &) override { return false; }
+
+    private:
+        int m_depth = 0;
+};
+
+// Parses a JSON array of strings stored in a string (e.g. custom block argument IDs) without building a DOM
+std::vector<std::string> parseStringArray(const std::string &str)
+{
+    StringArraySax sax;
+
+    if (!nlohmann::json::sax_parse(str, &sax))
+        throw std::runtime_error("expected a JSON array of strings");
+
+    return std::move(sax.strings);
+}
+
 } // namespace libscratchcpp
@@ -13,6 +13,8 @@
 #include <scratchcpp/stage.h>
 #include <scratchcpp/sprite.h>
 #include <scratchcpp/monitor.h>
+#include <algorithm>
+#include <atomic>
 
 #include "scratch3reader.h"
 #include "reader_common.h"
@@ -20,18 +22,27 @@
 using namespace libscratchcpp;
 using json = nlohmann::json;
 
+static const unsigned int MAX_ASSET_THREADS = 8;
+
+Scratch3Reader::~Scratch3Reader()
+{
+    waitForAssets();
+}
+
 bool Scratch3Reader::load()
 {
+    waitForAssets();
+
     if (m_json == "")
         read();
-    auto project = m_json;
+    json &project = m_json;
     const char *step = "";
 
     try {
         // targets
         READER_STEP(step, "targets");
-        auto targets = project["targets"];
-        for (auto jsonTarget : targets) {
+        auto &targets = project["targets"];
+        for (auto &jsonTarget : targets) {
             std::shared_ptr<Target> target;
 
             // isStage
@@ -47,9 +58,9 @@ bool Scratch3Reader::load()
 
             // variables
             READER_STEP(step, "target -> variables");
-            auto variables = jsonTarget["variables"];
+            auto &variables = jsonTarget["variables"];
             for (json::iterator it = variables.begin(); it != variables.end(); ++it) {
-                auto varInfo = it.value();
+                auto &varInfo = it.value();
                 bool cloudVar = (varInfo.size() >= 3 && varInfo[2]);
                 auto variable = std::make_shared<Variable>(it.key(), varInfo[0], Value(jsonToValue(varInfo[1])), cloudVar);
                 target->addVariable(variable);
@@ -57,19 +68,19 @@ bool Scratch3Reader::load()
 
             // lists
             READER_STEP(step, "target -> lists");
-            auto lists = jsonTarget["lists"];
+            auto &lists = jsonTarget["lists"];
             for (json::iterator it = lists.begin(); it != lists.end(); ++it) {
-                auto listInfo = it.value();
+                auto &listInfo = it.value();
                 auto list = std::make_shared<List>(it.key(), listInfo[0]);
-                auto arr = listInfo[1];
-                for (auto item : arr)
+                auto &arr = listInfo[1];
+                for (const auto &item : arr)
                     list->append(jsonToValue(item));
                 target->addList(list);
             }
 
             // broadcasts
             READER_STEP(step, "target -> broadcasts");
-            auto broadcasts = jsonTarget["broadcasts"];
+            auto &broadcasts = jsonTarget["broadcasts"];
             for (json::iterator it = broadcasts.begin(); it != broadcasts.end(); ++it) {
                 auto broadcast = std::make_shared<Broadcast>(it.key(), it.value());
                 m_broadcasts.push_back(broadcast);
@@ -77,9 +88,9 @@ bool Scratch3Reader::load()
 
             // blocks
             READER_STEP(step, "target -> blocks");
-            auto blocks = jsonTarget["blocks"];
+            auto &blocks = jsonTarget["blocks"];
             for (json::iterator it = blocks.begin(); it != blocks.end(); ++it) {
-                auto blockInfo = it.value();
+                auto &blockInfo = it.value();
 
                 if (blockInfo.is_array()) {
                     // This is a top level reporter block for a variable/list
@@ -129,11 +140,11 @@ bool Scratch3Reader::load()
 
                 // inputs
                 READER_STEP(step, "target -> block -> inputs");
-                auto inputs = blockInfo["inputs"];
+                auto &inputs = blockInfo["inputs"];
                 for (json::iterator it = inputs.begin(); it != inputs.end(); ++it) {
-                    auto inputInfo = it.value();
+                    auto &inputInfo = it.value();
                     auto input = std::make_shared<Input>(it.key(), static_cast<Input::Type>(inputInfo[0]));
-                    auto primary = inputInfo[1];
+                    auto &primary = inputInfo[1];
                     if (primary.is_array()) {
                         input->setPrimaryValue(jsonToValue(primary[1]));
                         input->primaryValue()->setType(static_cast<InputValue::Type>(primary[0]));
@@ -144,7 +155,7 @@ bool Scratch3Reader::load()
                     else
                         input->setValueBlockId(primary);
                     if (inputInfo.size() >= 3) {
-                        auto secondary = inputInfo[2];
+                        auto &secondary = inputInfo[2];
                         if (secondary.is_array()) {
                             input->setSecondaryValue(jsonToValue(secondary[1]));
                             input->secondaryValue()->setType(static_cast<InputValue::Type>(secondary[0]));
@@ -157,12 +168,12 @@ bool Scratch3Reader::load()
 
                 // fields
                 READER_STEP(step, "target -> block -> fields");
-                auto fields = blockInfo["fields"];
+                auto &fields = blockInfo["fields"];
                 for (json::iterator it = fields.begin(); it != fields.end(); ++it) {
-                    auto fieldInfo = it.value();
+                    auto &fieldInfo = it.value();
                     std::shared_ptr<Field> field;
                     if (fieldInfo.size() >= 2) {
-                        auto valueId = fieldInfo[1];
+                        auto &valueId = fieldInfo[1];
                         std::string valueIdStr;
                         if (!valueId.is_null())
                             valueIdStr = valueId;
@@ -175,7 +186,7 @@ bool Scratch3Reader::load()
                 // mutation
                 READER_STEP(step, "target -> block -> mutation");
                 if (blockInfo.contains("mutation")) {
-                    auto mutation = blockInfo["mutation"];
+                    auto &mutation = blockInfo["mutation"];
                     READER_STEP(step, "target -> block -> mutation -> hasnext");
                     if (mutation.contains("hasnext"))
                         block->setMutationHasNext(jsonToValue(mutation["hasnext"]).toBool());
@@ -184,21 +195,11 @@ bool Scratch3Reader::load()
                     if (mutation.contains("proccode"))
                         prototype->setProcCode(mutation["proccode"].get<std::string>());
                     READER_STEP(step, "target -> block -> mutation -> argumentids");
-                    if (mutation.contains("argumentids")) {
-                        std::vector<std::string> argIDs;
-                        auto argIDsJson = json::parse(mutation["argumentids"].get<std::string>());
-                        for (auto arg : argIDsJson)
-                            argIDs.push_back(arg.get<std::string>());
-                        prototype->setArgumentIds(argIDs);
-                    }
+                    if (mutation.contains("argumentids"))
+                        prototype->setArgumentIds(parseStringArray(mutation["argumentids"].get_ref<const std::string &>()));
                     READER_STEP(step, "target -> block -> mutation -> argumentnames");
-                    if (mutation.contains("argumentnames")) {
-                        std::vector<std::string> argNames;
-                        auto argNamesJson = json::parse(mutation["argumentnames"].get<std::string>());
-                        for (auto arg : argNamesJson)
-                            argNames.push_back(arg.get<std::string>());
-                        prototype->setArgumentNames(argNames);
-                    }
+                    if (mutation.contains("argumentnames"))
+                        prototype->setArgumentNames(parseStringArray(mutation["argumentnames"].get_ref<const std::string &>()));
                     READER_STEP(step, "target -> block -> mutation -> warp");
                     if (mutation.contains("warp"))
                         prototype->setWarp(jsonToValue(mutation["warp"]).toBool());
@@ -218,9 +219,9 @@ bool Scratch3Reader::load()
 
             // comments
             READER_STEP(step, "target -> comments");
-            auto comments = jsonTarget["comments"];
+            auto &comments = jsonTarget["comments"];
             for (json::iterator it = comments.begin(); it != comments.end(); ++it) {
-                auto commentInfo = it.value();
+                auto &commentInfo = it.value();
                 READER_STEP(step, "target -> comment -> { id, x, y }");
                 auto comment = std::make_shared<Comment>(it.key(), jsonToValue(commentInfo["x"]).toDouble(), jsonToValue(commentInfo["y"]).toDouble());
                 READER_STEP(step, "target -> comment -> blockId");
@@ -242,8 +243,8 @@ bool Scratch3Reader::load()
 
             // costumes
             READER_STEP(step, "target -> costumes");
-            auto costumes = jsonTarget["costumes"];
-            for (auto jsonCostume : costumes) {
+            auto &costumes = jsonTarget["costumes"];
+            for (auto &jsonCostume : costumes) {
                 READER_STEP(step, "target -> costume -> { name, assetId, dataFormat }");
                 auto costume = std::make_shared<Costume>(jsonCostume["name"], jsonCostume["assetId"], jsonCostume["dataFormat"]);
                 READER_STEP(step, "target -> costume -> bitmapResolution");
@@ -254,11 +255,17 @@ bool Scratch3Reader::load()
                 READER_STEP(step, "target -> costume -> rotationCenterY");
                 costume->setRotationCenterY(jsonCostume["rotationCenterY"]);
 
-                if (m_zipReader && !costume->data()) {
-                    void *data;
-                    unsigned int size = m_zipReader->readFile(costume->fileName(), &data);
-                    costume->setData(size, data);
-                }
+                if (m_zipReader && lazyAssetLoading()) {
+                    // Read the costume on first use
+                    std::shared_ptr<ZipReader> zipReader = m_zipReader;
+                    std::shared_ptr<AssetStore> store = m_assetStore;
+                    std::string fileName = costume->fileName();
+
+                    costume->setDataLoader([zipReader, store, fileName](std::shared_ptr<const void> &data) {
+                        return store->get(fileName, data, [&zipReader, &fileName](std::shared_ptr<const void> &buf) { return zipReader->readFile(fileName, buf); });
+                    });
+                } else if (m_zipReader)
+                    m_pendingAssets.push_back({ costume, costume->fileName() });
 
                 target->addCostume(costume);
             }
@@ -269,8 +276,8 @@ bool Scratch3Reader::load()
 
             // sounds
             READER_STEP(step, "target -> sounds");
-            auto sounds = jsonTarget["sounds"];
-            for (auto jsonSound : sounds) {
+            auto &sounds = jsonTarget["sounds"];
+            for (auto &jsonSound : sounds) {
                 READER_STEP(step, "target -> sound -> { name, assetId, dataFormat }");
                 auto sound = std::make_shared<Sound>(jsonSound["name"], jsonSound["assetId"], jsonSound["dataFormat"]);
                 READER_STEP(step, "target -> sound -> rate");
@@ -278,11 +285,8 @@ bool Scratch3Reader::load()
                 READER_STEP(step, "target -> sound -> sampleCount");
                 sound->setSampleCount(jsonSound["sampleCount"]);
 
-                if (m_zipReader && !sound->data()) {
-                    void *data;
-                    unsigned int size = m_zipReader->readFile(sound->fileName(), &data);
-                    sound->setData(size, data);
-                }
+                if (m_zipReader)
+                    m_pendingAssets.push_back({ sound, sound->fileName() });
 
                 target->addSound(sound);
             }
@@ -318,7 +322,7 @@ bool Scratch3Reader::load()
                 // textToSpeechLanguage
                 READER_STEP(step, "stage -> textToSpeechLanguage");
                 if (jsonTarget.contains("textToSpeechLanguage")) {
-                    auto lang = jsonTarget["textToSpeechLanguage"];
+                    auto &lang = jsonTarget["textToSpeechLanguage"];
                     std::string langStr;
                     if (!lang.is_null())
                         langStr = lang;
@@ -362,9 +366,9 @@ bool Scratch3Reader::load()
 
         // monitors
         READER_STEP(step, "monitors");
-        auto monitors = project["monitors"];
+        auto &monitors = project["monitors"];
 
-        for (auto jsonMonitor : monitors) {
+        for (auto &jsonMonitor : monitors) {
             READER_STEP(step, "monitor -> opcode");
             auto monitor = std::make_shared<Monitor>("", jsonMonitor["opcode"]);
 
@@ -374,7 +378,7 @@ bool Scratch3Reader::load()
 
             // mode
             READER_STEP(step, "monitor -> mode");
-            auto mode = jsonMonitor["mode"];
+            auto &mode = jsonMonitor["mode"];
 
             if (mode == "default")
                 monitor->setMode(Monitor::Mode::Default);
@@ -393,7 +397,7 @@ bool Scratch3Reader::load()
             READER_STEP(step, "monitor -> params");
 
             auto block = monitor->block();
-            auto params = jsonMonitor["params"];
+            auto &params = jsonMonitor["params"];
 
             for (json::iterator it = params.begin(); it != params.end(); ++it) {
                 auto field = std::make_shared<Field>(it.key(), jsonToValue(it.value()));
@@ -468,13 +472,13 @@ bool Scratch3Reader::load()
 
         // extensions
         READER_STEP(step, "extensions");
-        auto extensions = project["extensions"];
-        for (auto extension : extensions)
+        auto &extensions = project["extensions"];
+        for (const auto &extension : extensions)
             m_extensions.push_back(extension);
 
         // meta
         READER_STEP(step, "meta");
-        auto meta = project["meta"];
+        auto &meta = project["meta"];
         READER_STEP(step, "meta -> agent");
         m_userAgent = meta["agent"];
 
@@ -484,9 +488,16 @@ bool Scratch3Reader::load()
         else
             printErr(std::string("could not parse ") + step, e.what());
 
+        m_pendingAssets.clear();
         return false;
     }
 
+    // Read the assets in the background (see waitForAssets())
+    m_assetLoadFailed = false;
+
+    if (!m_pendingAssets.empty())
+        m_assetThread = std::thread(&Scratch3Reader::loadAssets, this);
+
     return true;
 }
 
@@ -519,8 +530,17 @@ bool Scratch3Reader::isValid()
     return (semver.substr(0, semver.find(".")) == "3");
 }
 
+bool Scratch3Reader::waitForAssets()
+{
+    if (m_assetThread.joinable())
+        m_assetThread.join();
+
+    return !m_assetLoadFailed;
+}
+
 void Scratch3Reader::clear()
 {
+    waitForAssets();
     m_json = "";
     m_targets.clear();
     m_broadcasts.clear();
@@ -558,7 +578,7 @@ void Scratch3Reader::read()
         return;
 
     // Read project.json
-    m_zipReader = std::make_unique<ZipReader>(fileName());
+    m_zipReader = std::make_shared<ZipReader>(fileName());
     if (m_zipReader->open()) {
         // Parse the JSON
         try {
@@ -573,3 +593,71 @@ void Scratch3Reader::read()
     } else
         printErr("could not read " + fileName());
 }
+
+void Scratch3Reader::loadAssets()
+{
+    // Group the assets by file (multiple assets can use the same file)
+    std::vector<std::string> files;
+    std::vector<std::vector<Asset *>> fileAssets; // assets using each file (indexed like files)
+    std::unordered_map<std::string, size_t> fileIndexes;
+
+    for (const auto &[asset, assetFileName] : m_pendingAssets) {
+        auto it = fileIndexes.find(assetFileName);
+
+        if (it == fileIndexes.cend()) {
+            fileIndexes[assetFileName] = files.size();
+            files.push_back(assetFileName);
+            fileAssets.push_back({ asset.get() });
+        } else
+            fileAssets[it->second].push_back(asset.get());
+    }
+
+    const size_t fileCount = files.size();
+    const size_t count = m_pendingAssets.size();
+    const unsigned int threadCount = std::min<size_t>(std::clamp(std::thread::hardware_concurrency(), 1u, MAX_ASSET_THREADS), fileCount);
+    std::atomic<size_t> next = 0;
+    std::atomic<unsigned int> loadedCount = 0;
+
+    // Inflate and decode (sounds) the assets concurrently
+    auto f = [this, count, fileCount, &files, &fileAssets, &next, &loadedCount]() {
+        // Every worker uses its own zip handle
+        ZipReader zipReader(fileName());
+
+        if (!zipReader.open()) {
+            printErr("could not read " + fileName());
+            m_assetLoadFailed = true;
+            return;
+        }
+
+        const std::atomic<bool> *stop = stopLoadingFlag();
+        size_t i;
+
+        while ((i = next++) < fileCount) {
+            // Don't read the remaining assets if loading has failed or has been aborted
+            if (m_assetLoadFailed || (stop && *stop)) {
+                m_assetLoadFailed = true;
+                return;
+            }
+
+            const std::string &assetFileName = files[i];
+            std::shared_ptr<const void> data;
+            unsigned int size = m_assetStore->get(assetFileName, data, [&zipReader, &assetFileName](std::shared_ptr<const void> &buf) { return zipReader.readFile(assetFileName, buf); });
+
+            // Every asset using the file shares the same buffer
+            for (Asset *asset : fileAssets[i]) {
+                asset->setData(size, data);
+                assetLoadProgressChanged()(++loadedCount, count);
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+
+    for (unsigned int i = 0; i < threadCount; i++)
+        threads.push_back(std::thread(f));
+
+    for (auto &thread : threads)
+        thread.join();
+
+    m_pendingAssets.clear();
+}
@@ -4,17 +4,25 @@
 
 #include "iprojectreader.h"
 #include <nlohmann/json.hpp>
+#include <thread>
+#include <atomic>
 
 #include "zipreader.h"
+#include "assetstore.h"
 
 namespace libscratchcpp
 {
 
+class Asset;
+
 class Scratch3Reader : public IProjectReader
 {
     public:
+        ~Scratch3Reader();
+
         bool load() override;
         bool loadData(const std::string &data) override;
+        bool waitForAssets() override;
         bool isValid() override;
         void clear() override;
         const std::vector<std::shared_ptr<Target>> &targets() const override;
@@ -25,13 +33,19 @@ class Scratch3Reader : public IProjectReader
 
     private:
         void read();
-        std::unique_ptr<ZipReader> m_zipReader;
+        void loadAssets();
+
+        std::shared_ptr<ZipReader> m_zipReader; // shared with lazy asset loaders
+        std::shared_ptr<AssetStore> m_assetStore = std::make_shared<AssetStore>();
         nlohmann::json m_json = "";
         std::vector<std::shared_ptr<Target>> m_targets;
         std::vector<std::shared_ptr<Broadcast>> m_broadcasts;
         std::vector<std::shared_ptr<Monitor>> m_monitors;
         std::vector<std::string> m_extensions;
         std::string m_userAgent;
+        std::vector<std::pair<std::shared_ptr<Asset>, std::string>> m_pendingAssets; // assets to read from the archive in loadAssets()
+        std::thread m_assetThread;
+        std::atomic<bool> m_assetLoadFailed = false;
 };
 
 } // namespace libscratchcpp
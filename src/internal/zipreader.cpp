@@ -1,9 +1,24 @@
 // SPDX-License-Identifier: Apache-2.0
 
+#include <cstdint>
+
 #include "zipreader.h"
+#include "mappedfile.h"
 
 using namespace libscratchcpp;
 
+static uint16_t readU16(const char *ptr)
+{
+    const unsigned char *p = reinterpret_cast<const unsigned char *>(ptr);
+    return p[0] | (p[1] << 8);
+}
+
+static uint32_t readU32(const char *ptr)
+{
+    const unsigned char *p = reinterpret_cast<const unsigned char *>(ptr);
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
 ZipReader::ZipReader(const std::string &fileName) :
     m_fileName(fileName)
 {
@@ -22,19 +37,38 @@ ZipReader::~ZipReader()
 bool ZipReader::open()
 {
     m_zip = zip_open(m_fileName.c_str(), 0, 'r');
+
+    if (m_zip) {
+        // Map the archive so that stored entries can be read without copying
+        auto mappedFile = std::make_shared<MappedFile>();
+
+        if (mappedFile->open(m_fileName)) {
+            m_mappedFile = mappedFile;
+            indexStoredEntries();
+        }
+    }
+
     return m_zip;
 }
 
 void ZipReader::close()
 {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
     if (m_zip)
         zip_close(m_zip);
 
     m_zip = nullptr;
+
+    // Buffers returned by readFile() keep the mapping alive
+    m_mappedFile.reset();
+    m_storedEntries.clear();
 }
 
 size_t ZipReader::readFile(const std::string &fileName, void **buf)
 {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
     if (!m_zip) {
         *buf = nullptr;
         return 0;
@@ -48,6 +82,30 @@ size_t ZipReader::readFile(const std::string &fileName, void **buf)
     return bufsize;
 }
 
+size_t ZipReader::readFile(const std::string &fileName, std::shared_ptr<const void> &buf)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_storedEntries.find(fileName);
+
+        if (it != m_storedEntries.cend()) {
+            // Return a view into the mapped file
+            buf = std::shared_ptr<const void>(m_mappedFile, m_mappedFile->data() + it->second.offset);
+            return it->second.size;
+        }
+    }
+
+    void *data = nullptr;
+    size_t size = readFile(fileName, &data);
+
+    if (data)
+        buf = std::shared_ptr<const void>(data, free);
+    else
+        buf.reset();
+
+    return size;
+}
+
 void ZipReader::readFileToString(const std::string &fileName, std::string &dst)
 {
     void *buf = nullptr;
@@ -59,3 +117,76 @@ void ZipReader::readFileToString(const std::string &fileName, std::string &dst)
     } else
         dst = "";
 }
+
+// Returns true if the given file is stored without compression (it can be read without a copy)
+bool ZipReader::isStored(const std::string &fileName) const
+{
+    return m_storedEntries.find(fileName) != m_storedEntries.cend();
+}
+
+// Finds uncompressed entries in the central directory of the mapped archive (ZIP64 archives aren't indexed)
+void ZipReader::indexStoredEntries()
+{
+    const char *data = m_mappedFile->data();
+    const size_t size = m_mappedFile->size();
+    const size_t eocdSize = 22;
+
+    if (size < eocdSize)
+        return;
+
+    // Find the end of central directory record (it may be followed by a comment)
+    const char *eocd = nullptr;
+    const size_t minPos = size > eocdSize + 0xFFFF ? size - eocdSize - 0xFFFF : 0;
+
+    for (size_t pos = size - eocdSize + 1; pos-- > minPos;) {
+        if (readU32(data + pos) == 0x06054b50) {
+            eocd = data + pos;
+            break;
+        }
+    }
+
+    if (!eocd)
+        return;
+
+    const uint16_t entryCount = readU16(eocd + 10);
+    const uint32_t dirOffset = readU32(eocd + 16);
+
+    if (entryCount == 0xFFFF || dirOffset == 0xFFFFFFFF)
+        return;
+
+    const size_t headerSize = 46;
+    const size_t localHeaderSize = 30;
+    size_t pos = dirOffset;
+
+    for (uint16_t i = 0; i < entryCount; i++) {
+        if (pos + headerSize > size || readU32(data + pos) != 0x02014b50)
+            return;
+
+        const char *header = data + pos;
+        const uint16_t flags = readU16(header + 8);
+        const uint16_t method = readU16(header + 10);
+        const uint32_t compressedSize = readU32(header + 20);
+        const uint32_t uncompressedSize = readU32(header + 24);
+        const uint16_t nameLength = readU16(header + 28);
+        const size_t localHeaderOffset = readU32(header + 42);
+        pos += headerSize + nameLength + readU16(header + 30) + readU16(header + 32);
+
+        if (pos > size)
+            return;
+
+        // Only unencrypted stored entries can be used directly
+        if (method != 0 || (flags & 1) || compressedSize != uncompressedSize)
+            continue;
+
+        if (localHeaderOffset + localHeaderSize > size || readU32(data + localHeaderOffset) != 0x04034b50)
+            continue;
+
+        const char *localHeader = data + localHeaderOffset;
+        const size_t dataOffset = localHeaderOffset + localHeaderSize + readU16(localHeader + 26) + readU16(localHeader + 28);
+
+        if (dataOffset + compressedSize > size)
+            continue;
+
+        m_storedEntries[std::string(header + headerSize, nameLength)] = { dataOffset, compressedSize };
+    }
+}
@@ -3,6 +3,9 @@
 #pragma once
 
 #include <string>
+#include <memory>
+#include <unordered_map>
+#include <mutex>
 #include <zip.h>
 
 #include "test_export.h"
@@ -10,6 +13,8 @@
 namespace libscratchcpp
 {
 
+class MappedFile;
+
 class LIBSCRATCHCPP_TEST_EXPORT ZipReader
 {
     public:
@@ -22,11 +27,25 @@ class LIBSCRATCHCPP_TEST_EXPORT ZipReader
         void close();
 
         size_t readFile(const std::string &fileName, void **buf);
+        size_t readFile(const std::string &fileName, std::shared_ptr<const void> &buf);
         void readFileToString(const std::string &fileName, std::string &dst);
 
+        bool isStored(const std::string &fileName) const;
+
     private:
+        struct StoredEntry
+        {
+                size_t offset = 0;
+                size_t size = 0;
+        };
+
+        void indexStoredEntries();
+
         std::string m_fileName;
         struct zip_t *m_zip = nullptr;
+        std::mutex m_mutex; // entries can be read from multiple threads (e.g. by lazy asset loaders)
+        std::shared_ptr<MappedFile> m_mappedFile;
+        std::unordered_map<std::string, StoredEntry> m_storedEntries; // uncompressed entries (can be read directly from the mapped file)
 };
 
 } // namespace libscratchcpp
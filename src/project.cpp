@@ -78,6 +78,21 @@ void Project::setFileName(const std::string &newFileName)
     impl->fileName = newFileName;
 }
 
+/*! Returns true if costume data is loaded on first use instead of during load(). */
+bool Project::lazyAssetLoading() const
+{
+    return impl->lazyAssetLoading;
+}
+
+/*!
+ * Sets whether costume data should be loaded on first use instead of during load().
+ * \note This only applies to projects loaded from a file. \see ScratchConfiguration::setAssetMemoryBudget()
+ */
+void Project::setLazyAssetLoading(bool lazy)
+{
+    impl->lazyAssetLoading = lazy;
+}
+
 /*! Returns the engine of the loaded project. \see IEngine */
 std::shared_ptr<IEngine> Project::engine() const
 {
@@ -92,3 +107,13 @@ sigslot::signal<unsigned int, unsigned int> &Project::downloadProgressChanged()
 {
     return impl->downloadProgressChanged();
 }
+
+/*!
+ * Emits when the progress of reading assets from a project file changes.
+ * \note The first parameter is the number of loaded assets and the latter is the number of all assets to load.
+ * \note The assets are loaded by multiple threads, so this signal is emitted from worker threads.
+ */
+sigslot::signal<unsigned int, unsigned int> &Project::assetLoadProgressChanged()
+{
+    return impl->assetLoadProgressChanged();
+}
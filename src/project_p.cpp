@@ -120,17 +120,20 @@ bool ProjectPrivate::tryLoad(IProjectReader *reader)
         for (size_t i = 0; i < assets.size(); i++) {
             const std::vector<Asset *> &assetList = assets[assetNames[i]];
 
-            for (Asset *asset : assetList) {
-                const std::string &data = assetData[i];
-                char *ptr = (char *)malloc(data.size() * sizeof(char));
-                memcpy(ptr, data.data(), data.size() * sizeof(char));
-                asset->setData(data.size(), ptr);
-            }
+            // Assets using the same file share one buffer
+            auto buffer = std::make_shared<std::string>(assetData[i]);
+            std::shared_ptr<const void> data(buffer, buffer->data());
+
+            for (Asset *asset : assetList)
+                asset->setData(buffer->size(), data);
         }
 
     } else {
         // Load from file
         reader->setFileName(fileName);
+        reader->setLazyAssetLoading(lazyAssetLoading);
+        reader->setStopLoadingFlag(&stopLoading);
+        reader->assetLoadProgressChanged().connect([this](unsigned int loaded, unsigned int total) { m_assetLoadProgressChanged(loaded, total); });
         if (!reader->isValid()) {
             std::cerr << "Could not read the project." << std::endl;
             return false;
@@ -158,13 +161,21 @@ bool ProjectPrivate::tryLoad(IProjectReader *reader)
     engine->setMonitors(reader->monitors());
     engine->setExtensions(reader->extensions());
     engine->setUserAgent(reader->userAgent());
+
+    // The assets are loaded in the background while compiling
     engine->compile();
+    const bool assetsLoaded = reader->waitForAssets();
 
     if (stopLoading) {
         loadingAborted();
         return false;
     }
 
+    if (!assetsLoaded) {
+        std::cerr << "Failed to load the project assets." << std::endl;
+        return false;
+    }
+
     return true;
 }
 
@@ -193,6 +204,11 @@ sigslot::signal<unsigned int, unsigned int> &ProjectPrivate::downloadProgressCha
     return downloader->downloadProgressChanged();
 }
 
+sigslot::signal<unsigned int, unsigned int> &ProjectPrivate::assetLoadProgressChanged()
+{
+    return m_assetLoadProgressChanged;
+}
+
 IProjectDownloaderFactory *ProjectPrivate::downloaderFactory()
 {
     return m_downloaderFactory;
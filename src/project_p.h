@@ -31,8 +31,10 @@ class LIBSCRATCHCPP_TEST_EXPORT ProjectPrivate
         void runEventLoop();
 
         sigslot::signal<unsigned int, unsigned int> &downloadProgressChanged();
+        sigslot::signal<unsigned int, unsigned int> &assetLoadProgressChanged();
 
         std::string fileName;
+        bool lazyAssetLoading = false;
         std::atomic<bool> stopLoading = false;
         std::shared_ptr<IEngine> engine = nullptr;
 
@@ -43,6 +45,7 @@ class LIBSCRATCHCPP_TEST_EXPORT ProjectPrivate
 
     private:
         static inline IProjectDownloaderFactory *m_downloaderFactory = nullptr;
+        sigslot::signal<unsigned int, unsigned int> m_assetLoadProgressChanged;
 };
 
 }; // namespace libscratchcpp
@@ -3,6 +3,7 @@
 #include <scratchcpp/asset.h>
 
 #include "asset_p.h"
+#include "assetcache.h"
 
 using namespace libscratchcpp;
 
@@ -17,10 +18,11 @@ Asset::Asset(const std::string &name, const std::string &id, const std::string &
 /*! Destroys Asset. */
 Asset::~Asset()
 {
-    if (impl->data && !impl->dataCloned) {
-        free(impl->data);
-        impl->data = nullptr;
-    }
+    // Unregister first so that the cache can't evict the data while the asset is being destroyed
+    if (impl->loader)
+        AssetCache::instance().remove(this);
+
+    impl->freeData();
 }
 
 /*! Sets the ID (MD5 hash) of the asset file. */
@@ -48,30 +50,100 @@ const std::string &Asset::dataFormat() const
     return impl->dataFormat;
 }
 
-/*! Returns the asset data. */
+/*!
+ * Returns the asset data.
+ * \note If a data loader is set, the data is loaded on first access. The returned pointer can't be tracked,
+ * so the data is never evicted after calling this (see ScratchConfiguration::setAssetMemoryBudget()).
+ * Use sharedData() instead to keep lazily loaded data evictable.
+ */
 const void *Asset::data() const
 {
+    std::lock_guard<std::mutex> lock(impl->mutex);
+    const_cast<Asset *>(this)->loadData(); // lazily loaded data
+
+    if (impl->data)
+        impl->dataPinned = true;
+
     return impl->data;
 }
 
+/*!
+ * Returns the asset data with shared ownership.
+ * Shared and lazily loaded data stays valid while the returned pointer exists, even if it's evicted meanwhile.
+ * Data owned by the asset (see setData(unsigned int, void *)) isn't shared, it's only valid while the asset exists.
+ */
+std::shared_ptr<const void> Asset::sharedData() const
+{
+    std::lock_guard<std::mutex> lock(impl->mutex);
+    const_cast<Asset *>(this)->loadData();
+
+    if (impl->sharedData)
+        return impl->sharedData;
+    else
+        return std::shared_ptr<const void>(std::shared_ptr<const void>(), impl->data);
+}
+
 /*! Returns the size of the asset data. */
 unsigned int Asset::dataSize() const
 {
+    std::lock_guard<std::mutex> lock(impl->mutex);
+    const_cast<Asset *>(this)->loadData();
     return impl->dataSize;
 }
 
 /*! Sets the asset data (will be deallocated when the object is destroyed). */
 void Asset::setData(unsigned int size, void *data)
 {
-    if (impl->data)
-        free(impl->data);
-
+    std::lock_guard<std::mutex> lock(impl->mutex);
+    setDataLoaderUnlocked(nullptr);
+    impl->freeData();
     impl->dataSize = size;
     impl->data = data;
     impl->dataCloned = isClone();
     processData(size, data);
 }
 
+/*!
+ * Sets the asset data to a shared read-only buffer, for example a view into a memory-mapped project file.
+ * \note The buffer isn't copied, it's released when the last reference to it is destroyed.
+ */
+void Asset::setData(unsigned int size, std::shared_ptr<const void> data)
+{
+    std::lock_guard<std::mutex> lock(impl->mutex);
+    setDataLoaderUnlocked(nullptr);
+    impl->freeData();
+    impl->dataSize = size;
+    impl->sharedData = data;
+    impl->data = const_cast<void *>(data.get());
+    impl->dataCloned = isClone();
+    processData(size, impl->data);
+}
+
+/*!
+ * Sets a function which loads the asset data on first access (see data()).
+ * Lazily loaded data counts towards the asset memory budget and can be evicted and loaded again later.
+ * \see ScratchConfiguration::setAssetMemoryBudget()
+ */
+void Asset::setDataLoader(const DataLoader &loader)
+{
+    std::lock_guard<std::mutex> lock(impl->mutex);
+    setDataLoaderUnlocked(loader);
+}
+
+/*! Returns false if the data is going to be loaded by the data loader on next access. */
+bool Asset::isDataLoaded() const
+{
+    std::lock_guard<std::mutex> lock(impl->mutex);
+    return !impl->loader || impl->data;
+}
+
+/*! Loads the data now if it's loaded lazily (use this as a hint for data which will be needed soon). */
+void Asset::prefetch()
+{
+    std::lock_guard<std::mutex> lock(impl->mutex);
+    loadData();
+}
+
 /*! Returns the sprite or stage this asset belongs to. */
 Target *Asset::target() const
 {
@@ -83,3 +155,48 @@ void Asset::setTarget(Target *target)
 {
     impl->target = target;
 }
+
+void Asset::setDataLoaderUnlocked(const DataLoader &loader)
+{
+    if (impl->loader) {
+        AssetCache::instance().remove(this);
+        impl->freeData();
+        impl->dataSize = 0;
+    }
+
+    impl->loader = loader;
+}
+
+// The asset mutex must be locked when calling this
+void Asset::loadData()
+{
+    if (!impl->loader)
+        return;
+
+    if (impl->data) {
+        AssetCache::instance().touch(this);
+        return;
+    }
+
+    std::shared_ptr<const void> data;
+    size_t size = impl->loader(data);
+
+    if (!data)
+        return;
+
+    impl->dataSize = size;
+    impl->sharedData = data;
+    impl->data = const_cast<void *>(data.get());
+    impl->dataCloned = isClone();
+
+    processData(size, impl->data);
+    AssetCache::instance().add(this, impl->data, size);
+}
+
+void Asset::evictData()
+{
+    // Called by AssetCache with the asset mutex locked, the data will be loaded again on next access
+    // Callers which hold the buffer from sharedData() keep it alive
+    impl->freeData();
+    impl->dataSize = 0;
+}
@@ -15,3 +15,14 @@ void AssetPrivate::updateFileName(const std::string &id)
     // NOTE: fileName depends on id and dataFormat
     fileName = id + "." + dataFormat;
 }
+
+void AssetPrivate::freeData()
+{
+    // Shared buffers are released with the last reference, cloned data is owned by the original asset
+    if (data && !dataCloned && !sharedData)
+        free(data);
+
+    data = nullptr;
+    sharedData.reset();
+    dataPinned = false;
+}
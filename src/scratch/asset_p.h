@@ -3,6 +3,9 @@
 #pragma once
 
 #include <string>
+#include <memory>
+#include <mutex>
+#include <scratchcpp/asset.h>
 
 namespace libscratchcpp
 {
@@ -15,6 +18,7 @@ struct AssetPrivate
         AssetPrivate(const AssetPrivate &) = delete;
 
         void updateFileName(const std::string &id);
+        void freeData();
 
         std::string name;
         std::string dataFormat;
@@ -22,6 +26,10 @@ struct AssetPrivate
         void *data = nullptr;
         unsigned int dataSize = 0;
         bool dataCloned = false;
+        mutable bool dataPinned = false; // the data has been returned by Asset::data(), so it can't be evicted
+        std::shared_ptr<const void> sharedData; // set if the data is a shared buffer
+        Asset::DataLoader loader; // set if the data is loaded lazily
+        mutable std::mutex mutex; // guards the data (lazily loaded data can be evicted by AssetCache from other threads)
         Target *target = nullptr;
 };
 
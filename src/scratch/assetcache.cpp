@@ -0,0 +1,144 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include <scratchcpp/asset.h>
+#include <algorithm>
+
+#include "assetcache.h"
+#include "asset_p.h"
+
+using namespace libscratchcpp;
+
+AssetCache &AssetCache::instance()
+{
+    static AssetCache cache;
+    return cache;
+}
+
+/*! Returns the maximum size of the lazily loaded asset data in bytes (0 means no limit). */
+size_t AssetCache::memoryBudget() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_budget;
+}
+
+/*! Sets the maximum size of the lazily loaded asset data in bytes (0 means no limit). */
+void AssetCache::setMemoryBudget(size_t budget)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_budget = budget;
+    evict(nullptr);
+}
+
+/*! Returns the size of the currently loaded lazy asset data in bytes. */
+size_t AssetCache::memoryUsage() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_usage;
+}
+
+/*! Registers the loaded data (buffer) of the given asset and evicts other data if the budget is exceeded. */
+void AssetCache::add(Asset *asset, const void *buffer, size_t size)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    detach(asset);
+
+    auto it = m_bufferIndex.find(buffer);
+    std::list<Entry>::iterator entryIt;
+
+    if (it == m_bufferIndex.cend()) {
+        // A new buffer
+        m_entries.push_front({ buffer, size, {} });
+        entryIt = m_entries.begin();
+        m_bufferIndex[buffer] = entryIt;
+        m_usage += size;
+    } else {
+        // The buffer is already used by other assets
+        entryIt = it->second;
+        m_entries.splice(m_entries.begin(), m_entries, entryIt);
+    }
+
+    entryIt->assets.push_back(asset);
+    m_index[asset] = entryIt;
+    evict(buffer);
+}
+
+/*! Marks the data of the given asset as recently used. */
+void AssetCache::touch(Asset *asset)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_index.find(asset);
+
+    if (it != m_index.cend())
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+}
+
+/*! Stops tracking the data of the given asset (call this when the data is released). */
+void AssetCache::remove(Asset *asset)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    detach(asset);
+}
+
+void AssetCache::detach(Asset *asset)
+{
+    auto it = m_index.find(asset);
+
+    if (it == m_index.cend())
+        return;
+
+    auto entryIt = it->second;
+    auto &assets = entryIt->assets;
+    assets.erase(std::find(assets.begin(), assets.end(), asset));
+    m_index.erase(it);
+
+    // The buffer is released with its last asset
+    if (assets.empty()) {
+        m_usage -= entryIt->size;
+        m_bufferIndex.erase(entryIt->buffer);
+        m_entries.erase(entryIt);
+    }
+}
+
+bool AssetCache::evictEntry(Entry &entry)
+{
+    // Assets which are being loaded or read right now are locked, skip the buffer in that case (evicting only some of its assets wouldn't release it)
+    std::vector<std::unique_lock<std::mutex>> locks;
+    locks.reserve(entry.assets.size());
+
+    // The raw pointers returned by Asset::data() can't be tracked, so data which has been returned by it stays loaded
+    for (Asset *asset : entry.assets) {
+        std::unique_lock<std::mutex> lock(asset->impl->mutex, std::try_to_lock);
+
+        if (!lock.owns_lock() || asset->impl->dataPinned)
+            return false;
+
+        locks.push_back(std::move(lock));
+    }
+
+    for (Asset *asset : entry.assets) {
+        asset->evictData();
+        m_index.erase(asset);
+    }
+
+    return true;
+}
+
+void AssetCache::evict(const void *keep)
+{
+    if (m_budget == 0)
+        return;
+
+    // Evict the least recently used data (keep the buffer which has just been loaded)
+    auto it = m_entries.end();
+
+    while (m_usage > m_budget && it != m_entries.begin()) {
+        --it;
+
+        if (it->buffer == keep || !evictEntry(*it))
+            continue;
+
+        m_usage -= it->size;
+        m_bufferIndex.erase(it->buffer);
+        it = m_entries.erase(it);
+    }
+}
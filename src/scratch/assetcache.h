@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <list>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+
+#include "test_export.h"
+
+namespace libscratchcpp
+{
+
+class Asset;
+
+/*!
+ * The AssetCache class tracks the data of lazily loaded assets and evicts the least recently used data when the memory budget is exceeded.
+ * Assets which share a buffer (see AssetStore) are counted and evicted together, since the buffer is only released with its last asset.
+ * Data which has been returned by Asset::data() isn't evicted.
+ */
+class LIBSCRATCHCPP_TEST_EXPORT AssetCache
+{
+    public:
+        AssetCache() = default;
+        AssetCache(const AssetCache &) = delete;
+
+        static AssetCache &instance();
+
+        size_t memoryBudget() const;
+        void setMemoryBudget(size_t budget);
+
+        size_t memoryUsage() const;
+
+        void add(Asset *asset, const void *buffer, size_t size);
+        void touch(Asset *asset);
+        void remove(Asset *asset);
+
+    private:
+        struct Entry
+        {
+                const void *buffer;
+                size_t size;
+                std::vector<Asset *> assets;
+        };
+
+        void detach(Asset *asset);
+        bool evictEntry(Entry &entry);
+        void evict(const void *keep);
+
+        mutable std::mutex m_mutex;
+        size_t m_budget = 0; // 0 means no limit
+        size_t m_usage = 0;
+        std::list<Entry> m_entries; // one entry per buffer, most recently used first
+        std::unordered_map<const void *, std::list<Entry>::iterator> m_bufferIndex;
+        std::unordered_map<Asset *, std::list<Entry>::iterator> m_index;
+};
+
+} // namespace libscratchcpp
@@ -34,6 +34,12 @@ const std::string &Block::opcode() const
     return impl->opcode;
 }
 
+/*! Returns the interned ID of the opcode (blocks with equal opcodes have equal IDs). */
+unsigned int Block::opcodeId() const
+{
+    return impl->opcodeId;
+}
+
 /*! Returns the compile function. \see <a href="blockSections.html">Block sections</a> */
 BlockComp Block::compileFunction() const
 {
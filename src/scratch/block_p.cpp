@@ -1,11 +1,13 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "block_p.h"
+#include "engine/internal/opcoderegistry.h"
 
 using namespace libscratchcpp;
 
 BlockPrivate::BlockPrivate(const std::string &opcode, bool isMonitorBlock) :
     opcode(opcode),
+    opcodeId(OpcodeRegistry::id(opcode)),
     isMonitorBlock(isMonitorBlock)
 {
 }
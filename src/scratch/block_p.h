@@ -22,6 +22,7 @@ struct BlockPrivate
         BlockPrivate(const BlockPrivate &) = delete;
 
         std::string opcode;
+        unsigned int opcodeId = 0;
         BlockComp compileFunction = nullptr;
         HatPredicateCompileFunc hatPredicateCompileFunction = nullptr;
         Block *next = nullptr;
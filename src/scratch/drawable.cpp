@@ -3,6 +3,7 @@
 #include <scratchcpp/drawable.h>
 
 #include "drawable_p.h"
+#include "engine/internal/layerlist.h"
 
 using namespace libscratchcpp;
 
@@ -12,9 +13,18 @@ Drawable::Drawable() :
 {
 }
 
+Drawable::~Drawable()
+{
+    if (impl->layerList)
+        impl->layerList->remove(this);
+}
+
 /*! Returns the layer number. */
 int Drawable::layerOrder() const
 {
+    if (impl->layerList)
+        impl->layerList->updateLayerOrders();
+
     return impl->layerOrder;
 }
 
@@ -8,11 +8,13 @@ namespace libscratchcpp
 {
 
 class IEngine;
+class LayerList;
 
 struct DrawablePrivate
 {
         int layerOrder = 0;
         IEngine *engine = nullptr;
+        LayerList *layerList = nullptr; // the layer order is computed lazily by the list
         mutable sigslot::signal<int> layerOrderChanged;
 };
 
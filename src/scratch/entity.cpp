@@ -21,5 +21,8 @@ const std::string &Entity::id() const
 /*! Sets the ID. */
 void Entity::setId(const std::string &newId)
 {
-    impl->id = newId;
+    if (newId != impl->id) {
+        impl->id = newId;
+        EntityPrivate::idGeneration++;
+    }
 }
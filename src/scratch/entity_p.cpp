@@ -4,6 +4,8 @@
 
 using namespace libscratchcpp;
 
+std::atomic<unsigned int> EntityPrivate::idGeneration = 0;
+
 EntityPrivate::EntityPrivate(const std::string &id) :
     id(id)
 {
@@ -3,6 +3,7 @@
 #pragma once
 
 #include <string>
+#include <atomic>
 
 namespace libscratchcpp
 {
@@ -12,6 +13,9 @@ struct EntityPrivate
         EntityPrivate(const std::string &id);
 
         std::string id;
+
+        // Changes whenever the ID of any entity changes, so that ID indexes can tell they're out of date
+        static std::atomic<unsigned int> idGeneration;
 };
 
 } // namespace libscratchcpp
@@ -31,4 +31,20 @@ const std::string &KeyEvent::name() const
     return impl->name;
 }
 
+/*!
+ * Returns a numeric code of the key in range [0, CODE_COUNT).
+ * \note Keys with equal names always have equal codes.
+ */
+unsigned int KeyEvent::code() const
+{
+    // 0-255: single byte keys, 256-261: special keys, 262: no key
+    if (impl->type != Type::Any)
+        return 255 + static_cast<unsigned int>(impl->type);
+
+    if (impl->name.empty())
+        return CODE_COUNT - 1;
+
+    return static_cast<unsigned char>(impl->name[0]);
+}
+
 } // namespace libscratchcpp
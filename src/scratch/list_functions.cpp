@@ -53,6 +53,11 @@ extern "C"
         return list->allocatedSizePtr();
     }
 
+    LIBSCRATCHCPP_EXPORT unsigned int *list_version_ptr(List *list)
+    {
+        return list->versionPtr();
+    }
+
     LIBSCRATCHCPP_EXPORT size_t list_size(List *list)
     {
         return list->size();
@@ -24,6 +24,7 @@ extern "C"
     ValueData *const *list_data_ptr(List *list);
     size_t *list_size_ptr(List *list);
     const size_t *list_alloc_size_ptr(List *list);
+    unsigned int *list_version_ptr(List *list);
     size_t list_size(List *list);
 
     void list_to_string(List *list, StringPtr *dst);
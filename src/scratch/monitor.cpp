@@ -5,6 +5,7 @@
 #include <scratchcpp/sprite.h>
 #include <scratchcpp/rect.h>
 #include <scratchcpp/imonitorhandler.h>
+#include <scratchcpp/thread.h>
 
 #include "monitor_p.h"
 #include "engine/internal/randomgenerator.h"
@@ -27,6 +28,7 @@ Monitor::Monitor(const std::string &id, const std::string &opcode) :
 void Monitor::setInterface(IMonitorHandler *iface)
 {
     impl->iface = iface;
+    impl->valueValid = false;
 
     if (iface)
         iface->init(this);
@@ -75,6 +77,8 @@ std::shared_ptr<Script> Monitor::script() const
 void Monitor::setScript(std::shared_ptr<Script> script)
 {
     impl->script = script;
+    impl->thread.reset();
+    impl->valueValid = false;
 }
 
 /*
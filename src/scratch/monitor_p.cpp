@@ -1,6 +1,9 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include <scratchcpp/block.h>
+#include <scratchcpp/thread.h>
+#include <scratchcpp/variable.h>
+#include <scratchcpp/list.h>
 
 #include "monitor_p.h"
 
@@ -12,3 +15,19 @@ MonitorPrivate::MonitorPrivate(const std::string &opcode) :
     block(std::make_shared<Block>("", opcode, true))
 {
 }
+
+// Returns false if this is a variable or list monitor and the value reported last time is still up to date.
+bool MonitorPrivate::sourceChanged()
+{
+    if (!variable && !list)
+        return true;
+
+    const unsigned int version = variable ? variable->version() : list->version();
+
+    if (valueValid && version == sourceVersion)
+        return false;
+
+    sourceVersion = version;
+    valueValid = true;
+    return true;
+}
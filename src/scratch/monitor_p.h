@@ -9,6 +9,9 @@ namespace libscratchcpp
 {
 
 class Block;
+class Thread;
+class Variable;
+class List;
 class IRandomGenerator;
 
 struct MonitorPrivate
@@ -16,6 +19,8 @@ struct MonitorPrivate
         MonitorPrivate(const std::string &opcode);
         MonitorPrivate(const MonitorPrivate &) = delete;
 
+        bool sourceChanged();
+
         IMonitorHandler *iface = nullptr;
         std::string name;
         Monitor::Mode mode = Monitor::Mode::Default;
@@ -32,6 +37,12 @@ struct MonitorPrivate
         double sliderMax = 0;
         bool discrete = false;
         bool needsAutoPosition = true;
+        std::shared_ptr<Thread> thread; // persistent reporter context
+        Variable *variable = nullptr;   // monitored variable (used for change tracking)
+        List *list = nullptr;           // monitored list (used for change tracking)
+        bool batched = false;           // evaluated along with other monitors of the target
+        bool valueValid = false;
+        unsigned int sourceVersion = 0;
         static IRandomGenerator *rng;
 };
 
@@ -1,7 +1,6 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include <scratchcpp/sound.h>
-#include <scratchcpp/sprite.h>
 #include <iostream>
 #include <unordered_map>
 #include <algorithm>
@@ -18,6 +17,22 @@ Sound::Sound(const std::string &name, const std::string &id, const std::string &
 {
 }
 
+Sound::Sound(const std::string &name, const std::string &id, const std::string &format, const Sound *cloneRoot) :
+    Asset(name, id, format),
+    impl(spimpl::make_unique_impl<SoundPrivate>(cloneRoot))
+{
+}
+
+/*! Destroys Sound. */
+Sound::~Sound()
+{
+    // Release the clone voice
+    const Sound *root = impl->cloneRoot ? impl->cloneRoot : this;
+
+    if (root == this || root->impl->voiceOwner == this)
+        releaseVoice();
+}
+
 /*! Returns the sampling rate of the sound in Hertz. */
 int Sound::rate() const
 {
@@ -45,7 +60,10 @@ void Sound::setSampleCount(int newSampleCount)
 /*! Sets the volume percentage of the sound. */
 void Sound::setVolume(double volume)
 {
-    impl->player->setVolume(volume / 100);
+    impl->volume = volume / 100;
+
+    if (impl->player)
+        impl->player->setVolume(impl->volume);
 }
 
 /*! Sets the value of the given sound effect. */
@@ -55,12 +73,20 @@ void Sound::setEffect(Effect effect, double value)
         case Effect::Pitch: {
             // Convert from linear
             const double root = std::pow(2, 1 / 12.0);
-            impl->player->setPitch(std::pow(root, value / 10));
+            impl->pitch = std::pow(root, value / 10);
+
+            if (impl->player)
+                impl->player->setPitch(impl->pitch);
+
             break;
         }
 
         case Effect::Pan:
-            impl->player->setPan(value / 100);
+            impl->pan = value / 100;
+
+            if (impl->player)
+                impl->player->setPan(impl->pan);
+
             break;
     }
 }
@@ -71,7 +97,12 @@ void Sound::start(Thread *owner)
     // Stop sounds in clones (#538)
     stopCloneSounds();
     impl->owner = owner;
-    impl->player->start();
+
+    if (impl->cloneRoot)
+        acquireVoice();
+
+    if (impl->player)
+        impl->player->start();
 }
 
 /*! Stops the playback of the sound. */
@@ -80,31 +111,49 @@ void Sound::stop()
     // Stop sounds in clones (#538)
     stopCloneSounds();
     impl->owner = nullptr;
-    impl->player->stop();
+
+    if (!impl->player)
+        return;
+
+    if (impl->cloneRoot)
+        releaseVoice();
+    else
+        impl->player->stop();
 }
 
 /*! Returns true if the sound is being played. */
 bool Sound::isPlaying() const
 {
-    return impl->player->isPlaying();
+    if (!impl->player)
+        return false;
+
+    if (impl->player->isPlaying())
+        return true;
+
+    // The clone voice isn't needed after the sound finishes
+    if (impl->cloneRoot)
+        const_cast<Sound *>(this)->releaseVoice();
+
+    return false;
 }
 
-/*! Returns an independent copy of the sound which is valid for as long as the original sound exists. */
+/*!
+ * Returns an independent copy of the sound which is valid for as long as the original sound exists.
+ * \note Clones don't have their own player, they share a voice which is acquired when the clone starts playing
+ * and released when it stops or finishes.
+ */
 std::shared_ptr<Sound> Sound::clone() const
 {
     const Sound *root = impl->cloneRoot ? impl->cloneRoot : this;
-    auto sound = std::make_shared<Sound>(name(), id(), dataFormat());
+    std::shared_ptr<Sound> sound(new Sound(name(), id(), dataFormat(), root));
     sound->setRate(rate());
     sound->setSampleCount(sampleCount());
-    sound->impl->cloneRoot = root;
-    sound->impl->player->setVolume(impl->player->volume());
-    sound->impl->player->setPitch(impl->player->pitch());
-    sound->impl->player->setPan(impl->player->pan());
+    sound->impl->volume = impl->volume;
+    sound->impl->pitch = impl->pitch;
+    sound->impl->pan = impl->pan;
 
-    if (root->impl->player->isLoaded()) {
-        sound->impl->player->loadCopy(root->impl->player.get());
+    if (root->impl->player->isLoaded())
         sound->setData(dataSize(), const_cast<void *>(data()));
-    }
 
     return sound;
 }
@@ -116,7 +165,8 @@ Thread *Sound::owner() const
 
 void Sound::processData(unsigned int size, void *data)
 {
-    if (impl->player->isLoaded())
+    // Clones play the data of the clone root
+    if (impl->cloneRoot || impl->player->isLoaded())
         return;
 
     if (!impl->player->load(size, data, impl->rate))
@@ -128,32 +178,58 @@ bool Sound::isClone() const
     return impl->cloneRoot;
 }
 
-void Sound::stopCloneSounds()
+void Sound::acquireVoice()
 {
-    Target *target = this->target();
+    Sound *root = const_cast<Sound *>(impl->cloneRoot);
+    SoundPrivate *rootImpl = root->impl.get();
+
+    if (rootImpl->voiceOwner == this)
+        return;
+
+    if (!rootImpl->cloneVoice)
+        rootImpl->cloneVoice = SoundPrivate::createPlayer();
+
+    if (!rootImpl->cloneVoice->isLoaded()) {
+        if (!rootImpl->player->isLoaded() || !rootImpl->cloneVoice->loadCopy(rootImpl->player.get()))
+            return;
+    }
+
+    // Take the voice from the previous owner (it has already been stopped)
+    if (rootImpl->voiceOwner)
+        rootImpl->voiceOwner->impl->player.reset();
 
-    if (target && !target->isStage()) {
-        Sprite *sprite = static_cast<Sprite *>(target);
+    rootImpl->voiceOwner = this;
+    impl->player = rootImpl->cloneVoice;
+    impl->player->setVolume(impl->volume);
+    impl->player->setPitch(impl->pitch);
+    impl->player->setPan(impl->pan);
+}
 
-        if (sprite->isClone())
-            sprite = sprite->cloneSprite();
+void Sound::stopCloneSounds()
+{
+    // Only the clone root and the owner of the clone voice can be playing, so there's no need to go through all clones
+    const Sound *root = impl->cloneRoot ? impl->cloneRoot : this;
+    SoundPrivate *rootImpl = const_cast<Sound *>(root)->impl.get();
 
-        // Stop the sound in the sprite (clone root)
-        const Sound *root = impl->cloneRoot ? impl->cloneRoot : this;
-        assert(root == sprite->soundAt(sprite->findSound(name())).get());
+    if (root != this)
+        rootImpl->player->stop();
 
-        if (root != this)
-            root->impl->player->stop();
+    if (rootImpl->voiceOwner && rootImpl->voiceOwner != this)
+        releaseVoice();
+}
 
-        // Stop the sound in clones
-        const auto &clones = sprite->clones();
+void Sound::releaseVoice()
+{
+    // The voice is a copy of the root player, which can't release its decoded data while the copy exists
+    const Sound *root = impl->cloneRoot ? impl->cloneRoot : this;
+    SoundPrivate *rootImpl = const_cast<Sound *>(root)->impl.get();
+    Sound *owner = rootImpl->voiceOwner;
 
-        for (auto clone : clones) {
-            auto sound = clone->soundAt(clone->findSound(name()));
-            assert(sound);
+    if (!owner)
+        return;
 
-            if (sound && sound.get() != this)
-                sound->impl->player->stop();
-        }
-    }
+    rootImpl->cloneVoice->stop();
+    rootImpl->cloneVoice.reset();
+    rootImpl->voiceOwner = nullptr;
+    owner->impl->player.reset();
 }
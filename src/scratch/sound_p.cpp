@@ -5,13 +5,21 @@
 
 using namespace libscratchcpp;
 
-SoundPrivate::SoundPrivate()
+SoundPrivate::SoundPrivate(const Sound *cloneRoot) :
+    cloneRoot(cloneRoot)
 {
-    // NOTE: audioOutput must be initialized in the constructor to avoid static initialization order fiasco
+    // Clones get a voice when they start playing
+    if (!cloneRoot)
+        player = createPlayer();
+}
+
+std::shared_ptr<IAudioPlayer> SoundPrivate::createPlayer()
+{
+    // NOTE: audioOutput must be initialized here (not statically) to avoid static initialization order fiasco
     if (!m_audioOutput)
         m_audioOutput = AudioOutput::instance().get();
 
-    player = m_audioOutput->createAudioPlayer();
+    return m_audioOutput->createAudioPlayer();
 }
 
 void SoundPrivate::setAudioOutput(IAudioOutput *audioOutput)
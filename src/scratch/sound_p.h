@@ -17,15 +17,27 @@ class Thread;
 class LIBSCRATCHCPP_TEST_EXPORT SoundPrivate
 {
     public:
-        SoundPrivate();
+        SoundPrivate(const Sound *cloneRoot = nullptr);
         SoundPrivate(const SoundPrivate &) = delete;
 
+        static std::shared_ptr<IAudioPlayer> createPlayer();
+
         int rate = 0;
         int sampleCount = 0;
-        std::shared_ptr<IAudioPlayer> player = nullptr;
+        std::shared_ptr<IAudioPlayer> player = nullptr; // clones only have a player while they hold the clone voice
         const Sound *cloneRoot = nullptr;
         Thread *owner = nullptr;
 
+        // Player settings (applied to the clone voice when a clone acquires it)
+        float volume = 1;
+        float pitch = 1;
+        float pan = 0;
+
+        // The voice shared by all clones of the sound (only one instance of a sound plays at a time, see #538)
+        // It only exists while a clone is playing
+        std::shared_ptr<IAudioPlayer> cloneVoice = nullptr;
+        Sound *voiceOwner = nullptr;
+
         static void setAudioOutput(IAudioOutput *newAudioOutput);
 
     private:
@@ -37,6 +37,7 @@ void Sprite::setInterface(ISpriteHandler *newInterface)
     assert(newInterface);
     impl->iface = newInterface;
     impl->iface->init(this);
+    invalidateRenderState();
 }
 
 /*! Returns the sprite interface. */
@@ -163,6 +164,7 @@ bool Sprite::visible() const
 void Sprite::setVisible(bool newVisible)
 {
     impl->visible = newVisible;
+    invalidateRenderState();
 
     if (impl->visible) {
         IEngine *eng = engine();
@@ -283,6 +285,7 @@ void Sprite::setSize(double newSize)
     }
 
     impl->size = newSize;
+    invalidateRenderState();
 
     if (impl->visible) {
         if (engine)
@@ -344,6 +347,8 @@ void Sprite::setDirection(double newDirection)
     else
         impl->direction = std::fmod(newDirection + 180, 360) - 180;
 
+    invalidateRenderState();
+
     if (impl->visible) {
         IEngine *eng = engine();
 
@@ -391,6 +396,7 @@ std::string Sprite::rotationStyleStr() const
 void Sprite::setRotationStyle(RotationStyle newRotationStyle)
 {
     impl->rotationStyle = newRotationStyle;
+    invalidateRenderState();
 
     if (impl->visible) {
         IEngine *eng = engine();
@@ -509,7 +515,14 @@ bool Sprite::touchingColor(Rgb color) const
     if (!impl->iface)
         return false;
 
-    return impl->iface->touchingColor(color);
+    bool result;
+
+    if (findCachedTouchingColor(color, 0, false, result))
+        return result;
+
+    result = impl->iface->touchingColor(color);
+    cacheTouchingColor(color, 0, false, result);
+    return result;
 }
 
 /*! Overrides Target#touchingColor(). */
@@ -518,7 +531,14 @@ bool Sprite::touchingColor(Rgb color, Rgb mask) const
     if (!impl->iface)
         return false;
 
-    return impl->iface->touchingColor(color, mask);
+    bool result;
+
+    if (findCachedTouchingColor(color, mask, true, result))
+        return result;
+
+    result = impl->iface->touchingColor(color, mask);
+    cacheTouchingColor(color, mask, true, result);
+    return result;
 }
 
 /*! Overrides Target#setGraphicsEffectValue(). */
@@ -579,6 +599,8 @@ void Sprite::setXY(double x, double y)
     } else
         impl->getFencedPosition(x, y, &impl->x, &impl->y);
 
+    invalidateRenderState();
+
     if (eng && impl->visible)
         eng->requestRedraw();
 
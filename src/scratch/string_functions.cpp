@@ -9,6 +9,9 @@
 #include <unicodelib.h>
 #include <unicodelib_encodings.h>
 
+#include "string_kernels.h"
+#include "string_pool_p.h"
+
 namespace libscratchcpp
 {
 
@@ -18,18 +21,40 @@ extern "C"
     /*! Ensures at least the given size is allocated on str. */
     void string_alloc(StringPtr *str, size_t size)
     {
+        // The string is going to be changed
+        str->numberState = StringPtr::NumberState::Unknown;
+
         size++; // null terminator
 
         if (str->allocatedSize < size) {
-            // TODO: Use std::bit_ceil() in C++20
-            const size_t newSize = std::pow(2, std::ceil(std::log2(size)));
             assert((str->data && str->allocatedSize > 0) || (!str->data && str->allocatedSize == 0));
 
-            if (str->data)
+            // Short strings don't need a heap allocation
+            if (!str->data && size <= StringPtr::INLINE_CAPACITY) {
+                str->data = str->inlineData;
+                str->allocatedSize = StringPtr::INLINE_CAPACITY;
+                return;
+            }
+
+            // Double the inline capacity (it isn't a power of two, so std::bit_ceil() wouldn't give the same sizes)
+            size_t newSize = StringPtr::INLINE_CAPACITY;
+
+            while (newSize < size)
+                newSize <<= 1;
+
+            const size_t oldHeapSize = str->isInline() ? 0 : str->allocatedSize;
+
+            if (str->isInline()) {
+                // Move the characters out of the inline buffer
+                char16_t *data = (typeof(str->data))malloc(newSize * sizeof(typeof(*str->data)));
+                memcpy(data, str->inlineData, StringPtr::INLINE_CAPACITY * sizeof(typeof(*str->data)));
+                str->data = data;
+            } else if (str->data)
                 str->data = (typeof(str->data))realloc(str->data, newSize * sizeof(typeof(*str->data)));
             else
                 str->data = (typeof(str->data))malloc(newSize * sizeof(typeof(*str->data)));
 
+            string_pool_add_bytes(static_cast<long long>((newSize - oldHeapSize) * sizeof(char16_t)));
             str->allocatedSize = newSize;
         }
     }
@@ -42,6 +67,21 @@ extern "C"
         memcpy(str->data, another->data, (another->size + 1) * sizeof(typeof(*str->data)));
     }
 
+    /*!
+     * Appends the given string to str.
+     * \note The allocated size grows geometrically, so repeated appends run in amortized linear time.
+     */
+    void string_append(StringPtr *str, const StringPtr *another)
+    {
+        // another may be the same string as str
+        const size_t size = str->size;
+        const size_t anotherSize = another->size;
+        string_alloc(str, size + anotherSize);
+        memcpy(str->data + size, another->data, anotherSize * sizeof(typeof(*str->data)));
+        str->size = size + anotherSize;
+        str->data[str->size] = u'\0';
+    }
+
     /*! Assigns the given string to str. */
     void string_assign_cstring(StringPtr *str, const char *another)
     {
@@ -62,11 +102,10 @@ extern "C"
     inline int string_compare_raw_case_sensitive_inline(const char16_t *str1, size_t n1, const char16_t *str2, size_t n2)
     {
         const size_t min_len = std::min(n1, n2);
+        const size_t i = string_kernels::mismatch(str1, str2, min_len);
 
-        for (size_t i = 0; i < min_len; i++) {
-            if (str1[i] != str2[i])
-                return str1[i] - str2[i];
-        }
+        if (i < min_len)
+            return str1[i] - str2[i];
 
         return n1 < n2 ? -1 : (n1 > n2 ? 1 : 0);
     }
@@ -81,21 +120,39 @@ extern "C"
         return string_compare_raw_case_sensitive_inline(str1->data, str1->size, str2->data, str2->size);
     }
 
+    inline char32_t to_lower_unicode(const char16_t *ch)
+    {
+        std::u32string cp;
+        unicode::utf16::decode(ch, 1, cp);
+        return unicode::simple_lowercase_mapping(cp.front());
+    }
+
     inline int string_compare_raw_case_insensitive_inline(const char16_t *str1, size_t n1, const char16_t *str2, size_t n2)
     {
         const size_t min_len = std::min(n1, n2);
-        char32_t cp1, cp2;
+        size_t i = 0;
+
+        while (true) {
+            // Skip equal ASCII characters
+            i += string_kernels::mismatch_ascii_case_insensitive(str1 + i, str2 + i, min_len - i);
+
+            if (i == min_len)
+                break;
 
-        for (size_t i = 0; i < min_len; ++i) {
-            std::u32string cp1_str, cp2_str;
-            unicode::utf16::decode(str1 + i, 1, cp1_str);
-            unicode::utf16::decode(str2 + i, 1, cp2_str);
+            char32_t cp1, cp2;
 
-            cp1 = unicode::simple_lowercase_mapping(cp1_str.front());
-            cp2 = unicode::simple_lowercase_mapping(cp2_str.front());
+            if ((str1[i] | str2[i]) < 0x80) {
+                cp1 = string_kernels::ascii_to_lower(str1[i]);
+                cp2 = string_kernels::ascii_to_lower(str2[i]);
+            } else {
+                cp1 = to_lower_unicode(str1 + i);
+                cp2 = to_lower_unicode(str2 + i);
+            }
 
             if (cp1 != cp2)
                 return cp1 - cp2;
+
+            i++;
         }
 
         return n1 < n2 ? -1 : (n1 > n2 ? 1 : 0);
@@ -111,59 +168,49 @@ extern "C"
         return string_compare_raw_case_insensitive_inline(str1->data, str1->size, str2->data, str2->size);
     }
 
-    inline bool string_contains_raw_case_sensitive_inline(const char16_t *str, const char16_t *substr)
+    inline bool string_contains_sized_case_sensitive(const char16_t *str, size_t n, const char16_t *substr, size_t m)
     {
-        size_t i = 0;
-
-        while (*str != u'\0') {
-            if (*str == substr[i]) {
-                i++;
+        if (m == 0 || m > n)
+            return false;
 
-                if (substr[i] == u'\0')
-                    return true;
-            } else
-                i = 0;
-
-            str++;
-        }
-
-        return false;
+        return string_kernels::find(str, n, substr, m);
     }
 
     /*! Returns true if the string contains the given substring (case sensitive). */
     bool string_contains_raw_case_sensitive(const char16_t *str, const char16_t *substr)
     {
-        return string_contains_raw_case_sensitive_inline(str, substr);
+        return string_contains_sized_case_sensitive(str, std::char_traits<char16_t>::length(str), substr, std::char_traits<char16_t>::length(substr));
     }
 
     /*! Returns true if the string contains the given substring (case sensitive). */
     bool string_contains_case_sensitive(const StringPtr *str, const StringPtr *substr)
     {
-        return string_contains_raw_case_sensitive_inline(str->data, substr->data);
+        return string_contains_sized_case_sensitive(str->data, str->size, substr->data, substr->size);
     }
 
-    inline bool string_contains_raw_case_insensitive_inline(const char16_t *str, const char16_t *substr)
+    inline bool string_contains_sized_case_insensitive(const char16_t *str, size_t n, const char16_t *substr, size_t m)
     {
-        size_t i = 0;
-        char32_t cp1, cp2;
+        if (m == 0 || m > n)
+            return false;
+
+        // Non-ASCII characters may be lower case variants of ASCII characters, so the fast path can't be used then
+        if (string_kernels::is_ascii(substr, m) && string_kernels::is_ascii(str, n))
+            return string_kernels::find_ascii_case_insensitive(str, n, substr, m);
 
-        while (*str != u'\0') {
-            std::u32string cp1_str, cp2_str;
-            unicode::utf16::decode(str, 1, cp1_str);
-            unicode::utf16::decode(substr + i, 1, cp2_str);
+        std::u32string lowerSubstr;
+        lowerSubstr.reserve(m);
 
-            cp1 = unicode::simple_lowercase_mapping(cp1_str.front());
-            cp2 = unicode::simple_lowercase_mapping(cp2_str.front());
+        for (size_t i = 0; i < m; i++)
+            lowerSubstr.push_back(to_lower_unicode(substr + i));
 
-            if (cp1 == cp2) {
-                i++;
+        for (size_t i = 0; i + m <= n; i++) {
+            size_t j = 0;
 
-                if (substr[i] == u'\0')
-                    return true;
-            } else
-                i = 0;
+            while (j < m && to_lower_unicode(str + i + j) == lowerSubstr[j])
+                j++;
 
-            str++;
+            if (j == m)
+                return true;
         }
 
         return false;
@@ -172,13 +219,13 @@ extern "C"
     /*! Returns true if the string contains the given substring (case insensitive). */
     bool string_contains_raw_case_insensitive(const char16_t *str, const char16_t *substr)
     {
-        return string_contains_raw_case_insensitive_inline(str, substr);
+        return string_contains_sized_case_insensitive(str, std::char_traits<char16_t>::length(str), substr, std::char_traits<char16_t>::length(substr));
     }
 
     /*! Returns true if the string contains the given substring (case insensitive). */
     bool string_contains_case_insensitive(const StringPtr *str, const StringPtr *substr)
     {
-        return string_contains_raw_case_insensitive_inline(str->data, substr->data);
+        return string_contains_sized_case_insensitive(str->data, str->size, substr->data, substr->size);
     }
 }
 
@@ -0,0 +1,359 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#include "string_kernels.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#define STRING_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+namespace libscratchcpp::string_kernels
+{
+
+namespace
+{
+
+// Shorter strings don't fill a single SSE2 register
+static const size_t SIMD_THRESHOLD = 8;
+
+inline bool isAsciiPair(char16_t c1, char16_t c2)
+{
+    return (c1 | c2) < 0x80;
+}
+
+size_t mismatchScalar(const char16_t *str1, const char16_t *str2, size_t n)
+{
+    for (size_t i = 0; i < n; i++) {
+        if (str1[i] != str2[i])
+            return i;
+    }
+
+    return n;
+}
+
+size_t mismatchCaseInsensitiveScalar(const char16_t *str1, const char16_t *str2, size_t n)
+{
+    for (size_t i = 0; i < n; i++) {
+        if (!isAsciiPair(str1[i], str2[i]) || ascii_to_lower(str1[i]) != ascii_to_lower(str2[i]))
+            return i;
+    }
+
+    return n;
+}
+
+bool isAsciiScalar(const char16_t *str, size_t n)
+{
+    char16_t acc = 0;
+
+    for (size_t i = 0; i < n; i++)
+        acc |= str[i];
+
+    return acc < 0x80;
+}
+
+template<bool caseInsensitive>
+inline bool matchesAt(const char16_t *str, const char16_t *substr, size_t m)
+{
+    // The first and last characters have already been checked
+    if (m <= 2)
+        return true;
+
+    if constexpr (caseInsensitive)
+        return mismatch_ascii_case_insensitive(str + 1, substr + 1, m - 2) == m - 2;
+    else
+        return mismatch(str + 1, substr + 1, m - 2) == m - 2;
+}
+
+template<bool caseInsensitive>
+bool findScalar(const char16_t *str, size_t n, const char16_t *substr, size_t m)
+{
+    for (size_t i = 0; i + m <= n; i++) {
+        if constexpr (caseInsensitive) {
+            if (mismatchCaseInsensitiveScalar(str + i, substr, m) == m)
+                return true;
+        } else {
+            if (mismatchScalar(str + i, substr, m) == m)
+                return true;
+        }
+    }
+
+    return false;
+}
+
+#ifdef STRING_KERNELS_X86
+// SSE2 (always available on x86-64)
+inline __m128i loadSse2(const char16_t *ptr)
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr));
+}
+
+inline __m128i toLowerSse2(__m128i v)
+{
+    // Signed comparison: code units >= 0x8000 are never upper case ASCII letters
+    const __m128i upper = _mm_and_si128(_mm_cmpgt_epi16(v, _mm_set1_epi16(u'A' - 1)), _mm_cmplt_epi16(v, _mm_set1_epi16(u'Z' + 1)));
+    return _mm_or_si128(v, _mm_and_si128(upper, _mm_set1_epi16(0x20)));
+}
+
+size_t mismatchSse2(const char16_t *str1, const char16_t *str2, size_t n)
+{
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        const unsigned mask = _mm_movemask_epi8(_mm_cmpeq_epi16(loadSse2(str1 + i), loadSse2(str2 + i))) ^ 0xFFFF;
+
+        if (mask)
+            return i + (__builtin_ctz(mask) >> 1);
+    }
+
+    return i + mismatchScalar(str1 + i, str2 + i, n - i);
+}
+
+size_t mismatchCaseInsensitiveSse2(const char16_t *str1, const char16_t *str2, size_t n)
+{
+    const __m128i nonAscii = _mm_set1_epi16(static_cast<short>(0xFF80));
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        const __m128i a = loadSse2(str1 + i);
+        const __m128i b = loadSse2(str2 + i);
+        const __m128i equal = _mm_cmpeq_epi16(toLowerSse2(a), toLowerSse2(b));
+        const __m128i ascii = _mm_cmpeq_epi16(_mm_and_si128(_mm_or_si128(a, b), nonAscii), zero);
+        const unsigned mask = _mm_movemask_epi8(_mm_and_si128(equal, ascii)) ^ 0xFFFF;
+
+        if (mask)
+            return i + (__builtin_ctz(mask) >> 1);
+    }
+
+    return i + mismatchCaseInsensitiveScalar(str1 + i, str2 + i, n - i);
+}
+
+bool isAsciiSse2(const char16_t *str, size_t n)
+{
+    __m128i acc = _mm_setzero_si128();
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8)
+        acc = _mm_or_si128(acc, loadSse2(str + i));
+
+    if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(acc, _mm_set1_epi16(static_cast<short>(0xFF80))), _mm_setzero_si128())) != 0xFFFF)
+        return false;
+
+    return isAsciiScalar(str + i, n - i);
+}
+
+template<bool caseInsensitive>
+bool findSse2(const char16_t *str, size_t n, const char16_t *substr, size_t m)
+{
+    if (n < m)
+        return false;
+
+    // Compare the first and the last character at 8 positions at once, then verify the candidates
+    const __m128i first = _mm_set1_epi16(caseInsensitive ? ascii_to_lower(substr[0]) : substr[0]);
+    const __m128i last = _mm_set1_epi16(caseInsensitive ? ascii_to_lower(substr[m - 1]) : substr[m - 1]);
+    const size_t positions = n - m + 1;
+    size_t i = 0;
+
+    for (; i + 8 <= positions; i += 8) {
+        __m128i blockFirst = loadSse2(str + i);
+        __m128i blockLast = loadSse2(str + i + m - 1);
+
+        if constexpr (caseInsensitive) {
+            blockFirst = toLowerSse2(blockFirst);
+            blockLast = toLowerSse2(blockLast);
+        }
+
+        unsigned mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi16(first, blockFirst), _mm_cmpeq_epi16(last, blockLast)));
+
+        while (mask) {
+            const unsigned bit = __builtin_ctz(mask);
+
+            if (matchesAt<caseInsensitive>(str + i + (bit >> 1), substr, m))
+                return true;
+
+            mask &= ~(3u << bit);
+        }
+    }
+
+    return findScalar<caseInsensitive>(str + i, n - i, substr, m);
+}
+
+// AVX2
+__attribute__((target("avx2"))) inline __m256i loadAvx2(const char16_t *ptr)
+{
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(ptr));
+}
+
+__attribute__((target("avx2"))) inline __m256i toLowerAvx2(__m256i v)
+{
+    const __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi16(v, _mm256_set1_epi16(u'A' - 1)), _mm256_cmpgt_epi16(_mm256_set1_epi16(u'Z' + 1), v));
+    return _mm256_or_si256(v, _mm256_and_si256(upper, _mm256_set1_epi16(0x20)));
+}
+
+__attribute__((target("avx2"))) size_t mismatchAvx2(const char16_t *str1, const char16_t *str2, size_t n)
+{
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        const unsigned mask = ~static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi16(loadAvx2(str1 + i), loadAvx2(str2 + i))));
+
+        if (mask)
+            return i + (__builtin_ctz(mask) >> 1);
+    }
+
+    return i + mismatchSse2(str1 + i, str2 + i, n - i);
+}
+
+__attribute__((target("avx2"))) size_t mismatchCaseInsensitiveAvx2(const char16_t *str1, const char16_t *str2, size_t n)
+{
+    const __m256i nonAscii = _mm256_set1_epi16(static_cast<short>(0xFF80));
+    const __m256i zero = _mm256_setzero_si256();
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        const __m256i a = loadAvx2(str1 + i);
+        const __m256i b = loadAvx2(str2 + i);
+        const __m256i equal = _mm256_cmpeq_epi16(toLowerAvx2(a), toLowerAvx2(b));
+        const __m256i ascii = _mm256_cmpeq_epi16(_mm256_and_si256(_mm256_or_si256(a, b), nonAscii), zero);
+        const unsigned mask = ~static_cast<unsigned>(_mm256_movemask_epi8(_mm256_and_si256(equal, ascii)));
+
+        if (mask)
+            return i + (__builtin_ctz(mask) >> 1);
+    }
+
+    return i + mismatchCaseInsensitiveSse2(str1 + i, str2 + i, n - i);
+}
+
+__attribute__((target("avx2"))) bool isAsciiAvx2(const char16_t *str, size_t n)
+{
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16)
+        acc = _mm256_or_si256(acc, loadAvx2(str + i));
+
+    if (!_mm256_testz_si256(acc, _mm256_set1_epi16(static_cast<short>(0xFF80))))
+        return false;
+
+    return isAsciiSse2(str + i, n - i);
+}
+
+template<bool caseInsensitive>
+__attribute__((target("avx2"))) bool findAvx2(const char16_t *str, size_t n, const char16_t *substr, size_t m)
+{
+    if (n < m)
+        return false;
+
+    const __m256i first = _mm256_set1_epi16(caseInsensitive ? ascii_to_lower(substr[0]) : substr[0]);
+    const __m256i last = _mm256_set1_epi16(caseInsensitive ? ascii_to_lower(substr[m - 1]) : substr[m - 1]);
+    const size_t positions = n - m + 1;
+    size_t i = 0;
+
+    for (; i + 16 <= positions; i += 16) {
+        __m256i blockFirst = loadAvx2(str + i);
+        __m256i blockLast = loadAvx2(str + i + m - 1);
+
+        if constexpr (caseInsensitive) {
+            blockFirst = toLowerAvx2(blockFirst);
+            blockLast = toLowerAvx2(blockLast);
+        }
+
+        unsigned mask = _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi16(first, blockFirst), _mm256_cmpeq_epi16(last, blockLast)));
+
+        while (mask) {
+            const unsigned bit = __builtin_ctz(mask);
+
+            if (matchesAt<caseInsensitive>(str + i + (bit >> 1), substr, m))
+                return true;
+
+            mask &= ~(3u << bit);
+        }
+    }
+
+    return findSse2<caseInsensitive>(str + i, n - i, substr, m);
+}
+#endif // STRING_KERNELS_X86
+
+struct Kernels
+{
+        size_t (*mismatch)(const char16_t *, const char16_t *, size_t) = &mismatchScalar;
+        size_t (*mismatchCaseInsensitive)(const char16_t *, const char16_t *, size_t) = &mismatchCaseInsensitiveScalar;
+        bool (*isAscii)(const char16_t *, size_t) = &isAsciiScalar;
+        bool (*find)(const char16_t *, size_t, const char16_t *, size_t) = &findScalar<false>;
+        bool (*findCaseInsensitive)(const char16_t *, size_t, const char16_t *, size_t) = &findScalar<true>;
+};
+
+Kernels detectKernels()
+{
+    Kernels ret;
+
+#ifdef STRING_KERNELS_X86
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2")) {
+        ret.mismatch = &mismatchAvx2;
+        ret.mismatchCaseInsensitive = &mismatchCaseInsensitiveAvx2;
+        ret.isAscii = &isAsciiAvx2;
+        ret.find = &findAvx2<false>;
+        ret.findCaseInsensitive = &findAvx2<true>;
+    } else {
+        ret.mismatch = &mismatchSse2;
+        ret.mismatchCaseInsensitive = &mismatchCaseInsensitiveSse2;
+        ret.isAscii = &isAsciiSse2;
+        ret.find = &findSse2<false>;
+        ret.findCaseInsensitive = &findSse2<true>;
+    }
+#endif
+
+    return ret;
+}
+
+const Kernels &kernels()
+{
+    static const Kernels kernels = detectKernels();
+    return kernels;
+}
+
+} // namespace
+
+size_t mismatch(const char16_t *str1, const char16_t *str2, size_t n)
+{
+    if (n < SIMD_THRESHOLD)
+        return mismatchScalar(str1, str2, n);
+
+    return kernels().mismatch(str1, str2, n);
+}
+
+size_t mismatch_ascii_case_insensitive(const char16_t *str1, const char16_t *str2, size_t n)
+{
+    if (n < SIMD_THRESHOLD)
+        return mismatchCaseInsensitiveScalar(str1, str2, n);
+
+    return kernels().mismatchCaseInsensitive(str1, str2, n);
+}
+
+bool is_ascii(const char16_t *str, size_t n)
+{
+    if (n < SIMD_THRESHOLD)
+        return isAsciiScalar(str, n);
+
+    return kernels().isAscii(str, n);
+}
+
+bool find(const char16_t *str, size_t n, const char16_t *substr, size_t m)
+{
+    if (n < SIMD_THRESHOLD)
+        return findScalar<false>(str, n, substr, m);
+
+    return kernels().find(str, n, substr, m);
+}
+
+bool find_ascii_case_insensitive(const char16_t *str, size_t n, const char16_t *substr, size_t m)
+{
+    if (n < SIMD_THRESHOLD)
+        return findScalar<true>(str, n, substr, m);
+
+    return kernels().findCaseInsensitive(str, n, substr, m);
+}
+
+} // namespace libscratchcpp::string_kernels
@@ -0,0 +1,32 @@
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstddef>
+
+namespace libscratchcpp::string_kernels
+{
+
+// Vectorized UTF-16 helpers (AVX2 or SSE2 picked at runtime, scalar elsewhere)
+
+// Returns the index of the first code unit which differs, or n if the strings are equal
+size_t mismatch(const char16_t *str1, const char16_t *str2, size_t n);
+
+// Returns the index of the first code unit which differs after ASCII case folding or which isn't ASCII in either string, or n
+size_t mismatch_ascii_case_insensitive(const char16_t *str1, const char16_t *str2, size_t n);
+
+// Returns true if all code units are ASCII
+bool is_ascii(const char16_t *str, size_t n);
+
+// Returns true if the string contains the substring (n >= m > 0)
+bool find(const char16_t *str, size_t n, const char16_t *substr, size_t m);
+
+// Same as find(), but with ASCII case folding (both strings must be ASCII)
+bool find_ascii_case_insensitive(const char16_t *str, size_t n, const char16_t *substr, size_t m);
+
+inline char16_t ascii_to_lower(char16_t c)
+{
+    return (c >= u'A' && c <= u'Z') ? c + (u'a' - u'A') : c;
+}
+
+} // namespace libscratchcpp::string_kernels
@@ -3,17 +3,173 @@
 #include <scratchcpp/string_pool.h>
 #include <scratchcpp/stringptr.h>
 #include <scratchcpp/string_functions.h>
-#include <memory>
-#include <unordered_set>
-#include <map>
-#include <cassert>
+#include <vector>
+#include <atomic>
+#include <mutex>
 #include <algorithm>
+#include <cassert>
+
+#include "string_pool_p.h"
 
 namespace libscratchcpp
 {
 
-static std::unordered_set<std::unique_ptr<StringPtr>> strings;
-static std::multimap<size_t, StringPtr *> freeStrings; // sorted by allocated space
+static thread_local bool poolDestroyed = false; // strings can be freed by static objects after the pool is destroyed
+
+// Live strings of every thread are counted separately, so that the hot path doesn't contend on a shared cache line
+// The counters are only written by their thread, other threads read them in string_pool_live_count() and string_pool_live_bytes()
+struct StringPoolStats
+{
+        std::atomic<long long> liveCount = 0;
+        std::atomic<long long> liveBytes = 0;
+        StringPoolStats *prev = nullptr;
+        StringPoolStats *next = nullptr;
+};
+
+static std::mutex statsMutex;
+static StringPoolStats *statsList = nullptr;        // stats of threads with a pool
+static std::atomic<long long> retiredLiveCount = 0; // strings of finished threads (they can be freed by other threads)
+static std::atomic<long long> retiredLiveBytes = 0;
+
+static inline void addToCounter(std::atomic<long long> &counter, long long value)
+{
+    // There's only one writer, so no atomic read-modify-write is needed
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+// Every thread has its own pool, so that engines can run in parallel threads without locking
+class StringPool
+{
+    public:
+        // Free strings are sorted into size classes by their capacity (0, inline, then doubling)
+        static constexpr size_t CLASS_COUNT = 32;
+
+        StringPool()
+        {
+            std::lock_guard<std::mutex> lock(statsMutex);
+            m_stats.next = statsList;
+
+            if (statsList)
+                statsList->prev = &m_stats;
+
+            statsList = &m_stats;
+        }
+
+        ~StringPool()
+        {
+            trim();
+            poolDestroyed = true;
+
+            // Keep the counts of the thread's strings, they can still be freed later
+            std::lock_guard<std::mutex> lock(statsMutex);
+            retiredLiveCount += m_stats.liveCount;
+            retiredLiveBytes += m_stats.liveBytes;
+
+            if (m_stats.prev)
+                m_stats.prev->next = m_stats.next;
+            else
+                statsList = m_stats.next;
+
+            if (m_stats.next)
+                m_stats.next->prev = m_stats.prev;
+        }
+
+        StringPtr *take()
+        {
+            addToCounter(m_stats.liveCount, 1);
+
+            // Optimization: pick a string with the highest capacity to minimize allocs
+            for (size_t i = CLASS_COUNT; i > 0; i--) {
+                auto &list = m_freeLists[i - 1];
+
+                if (!list.empty()) {
+                    StringPtr *str = list.back();
+                    list.pop_back();
+                    const size_t size = bytes(str);
+                    m_freeCount--;
+                    m_freeBytes -= size;
+                    addToCounter(m_stats.liveBytes, size);
+                    return str;
+                }
+            }
+
+            addToCounter(m_stats.liveBytes, sizeof(StringPtr));
+            return new StringPtr;
+        }
+
+        void put(StringPtr *str)
+        {
+            const size_t size = bytes(str);
+            m_freeLists[sizeClass(str->allocatedSize)].push_back(str);
+            m_freeCount++;
+            m_freeBytes += size;
+            addToCounter(m_stats.liveCount, -1);
+            addToCounter(m_stats.liveBytes, -static_cast<long long>(size));
+        }
+
+        void trim()
+        {
+            for (auto &list : m_freeLists) {
+                for (StringPtr *str : list) {
+                    // Free strings aren't counted as live, so release the characters before the destructor counts them
+                    if (str->data && !str->isInline())
+                        free(str->data);
+
+                    str->data = nullptr;
+                    str->allocatedSize = 0;
+                    delete str;
+                }
+
+                list.clear();
+                list.shrink_to_fit();
+            }
+
+            m_freeCount = 0;
+            m_freeBytes = 0;
+        }
+
+        void addLiveBytes(long long bytes) { addToCounter(m_stats.liveBytes, bytes); }
+
+        size_t freeCount() const { return m_freeCount; }
+        size_t freeBytes() const { return m_freeBytes; }
+
+        static size_t heapBytes(const StringPtr *str) { return (str->data && !str->isInline()) ? str->allocatedSize * sizeof(char16_t) : 0; }
+
+    private:
+        static size_t sizeClass(size_t allocatedSize)
+        {
+            if (allocatedSize == 0)
+                return 0;
+
+            size_t ret = 1;
+            size_t capacity = StringPtr::INLINE_CAPACITY;
+
+            while (capacity < allocatedSize && ret < CLASS_COUNT - 1) {
+                capacity <<= 1;
+                ret++;
+            }
+
+            return ret;
+        }
+
+        static size_t bytes(const StringPtr *str) { return sizeof(StringPtr) + heapBytes(str); }
+
+        std::vector<StringPtr *> m_freeLists[CLASS_COUNT];
+        size_t m_freeCount = 0;
+        size_t m_freeBytes = 0;
+        StringPoolStats m_stats;
+};
+
+static thread_local StringPool pool;
+
+// Counts characters allocated or released by a string (see string_alloc() and ~StringPtr())
+void string_pool_add_bytes(long long bytes)
+{
+    if (poolDestroyed)
+        retiredLiveBytes += bytes;
+    else
+        pool.addLiveBytes(bytes);
+}
 
 extern "C"
 {
@@ -23,29 +179,75 @@ extern "C"
      */
     StringPtr *string_pool_new()
     {
-        if (freeStrings.empty()) {
-            auto str = std::make_unique<StringPtr>();
-            StringPtr *ptr = str.get();
-            assert(strings.find(str) == strings.cend());
-            strings.insert(std::move(str));
-
-            return ptr;
+        if (poolDestroyed) {
+            retiredLiveCount++;
+            retiredLiveBytes += sizeof(StringPtr);
+            return new StringPtr;
         }
 
-        // Optimization: pick string with the highest capacity to minimize allocs
-        auto last = std::prev(freeStrings.end());
-        StringPtr *ptr = last->second;
-        freeStrings.erase(last);
-
-        return ptr;
+        return pool.take();
     }
 
-    /*! Invalidates the given StringPtr so that it can be used for new strings later. */
+    /*!
+     * Invalidates the given StringPtr so that it can be used for new strings later.
+     * \note Strings are reused by the pool of the calling thread.
+     */
     void string_pool_free(StringPtr *str)
     {
-        assert(std::find_if(freeStrings.begin(), freeStrings.end(), [str](const std::pair<size_t, StringPtr *> &p) { return p.second == str; }) == freeStrings.end());
-        assert(std::find_if(strings.begin(), strings.end(), [str](const std::unique_ptr<StringPtr> &p) { return p.get() == str; }) != strings.end());
-        freeStrings.insert(std::pair<size_t, StringPtr *>(str->allocatedSize, str));
+        assert(str);
+
+        if (poolDestroyed) {
+            retiredLiveCount--;
+            retiredLiveBytes -= sizeof(StringPtr);
+            delete str;
+        } else
+            pool.put(str);
+    }
+
+    /*! Deletes the free strings of the calling thread (use this to release memory after peaks). */
+    void string_pool_trim()
+    {
+        if (!poolDestroyed)
+            pool.trim();
+    }
+
+    /*! Returns the number of strings which are in use (in all threads). */
+    size_t string_pool_live_count()
+    {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        long long ret = retiredLiveCount;
+
+        for (StringPoolStats *stats = statsList; stats; stats = stats->next)
+            ret += stats->liveCount.load(std::memory_order_relaxed);
+
+        return std::max(ret, 0LL);
+    }
+
+    /*!
+     * Returns the memory used by strings which are in use (in all threads, in bytes).
+     * \note Characters of strings which don't come from the pool (e. g. StringPtr objects on the stack) are counted as well.
+     */
+    size_t string_pool_live_bytes()
+    {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        long long ret = retiredLiveBytes;
+
+        for (StringPoolStats *stats = statsList; stats; stats = stats->next)
+            ret += stats->liveBytes.load(std::memory_order_relaxed);
+
+        return std::max(ret, 0LL);
+    }
+
+    /*! Returns the number of free strings in the pool of the calling thread. */
+    size_t string_pool_free_count()
+    {
+        return poolDestroyed ? 0 : pool.freeCount();
+    }
+
+    /*! Returns the memory used by free strings in the pool of the calling thread (in bytes). */
+    size_t string_pool_free_bytes()
+    {
+        return poolDestroyed ? 0 : pool.freeBytes();
     }
 }
 
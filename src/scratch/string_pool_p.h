@@ -9,4 +9,6 @@ void string_pool_add_thread(Thread *thread);
 void string_pool_remove_thread(Thread *thread);
 void string_pool_set_thread(Thread *thread);
 
+void string_pool_add_bytes(long long bytes);
+
 } // namespace libscratchcpp
@@ -3,9 +3,19 @@
 #include <scratchcpp/stringptr.h>
 #include <scratchcpp/string_functions.h>
 
+#include "string_pool_p.h"
+
 using namespace libscratchcpp;
 
 StringPtr::StringPtr(const std::string &str)
 {
     string_assign_cstring(this, str.c_str());
 }
+
+StringPtr::~StringPtr()
+{
+    if (data && data != inlineData && allocatedSize > 0) {
+        string_pool_add_bytes(-static_cast<long long>(allocatedSize * sizeof(char16_t)));
+        free(data);
+    }
+}
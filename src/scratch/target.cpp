@@ -10,8 +10,12 @@
 #include <scratchcpp/igraphicseffect.h>
 
 #include <unordered_set>
+#include <algorithm>
+#include <atomic>
+#include <cassert>
 
 #include "target_p.h"
+#include "entity_p.h"
 
 using namespace libscratchcpp;
 
@@ -22,11 +26,77 @@ static std::unordered_map<Sound::Effect, std::pair<double, double>> SOUND_EFFECT
     { Sound::Effect::Pan, { -100, 100 } }    // // 100% left to 100% right
 };
 
+// Rebuilds the ID index if the ID of any entity has changed since it was built
+template<typename T>
+static void updateIdIndex(const std::vector<std::shared_ptr<T>> &entities, EntityIdIndex &idIndex)
+{
+    const unsigned int generation = EntityPrivate::idGeneration;
+
+    if (idIndex.generation == generation)
+        return;
+
+    // The first entity with the ID wins (like in a linear search)
+    idIndex.map.clear();
+
+    for (size_t i = 0; i < entities.size(); i++)
+        idIndex.map.try_emplace(entities[i]->id(), i);
+
+    idIndex.generation = generation;
+}
+
+// Adds the entity to the vector (if it isn't there yet) and to the ID index, returns the index of the entity
+template<typename T>
+static int addEntity(std::vector<std::shared_ptr<T>> &entities, EntityIdIndex &idIndex, std::shared_ptr<T> entity, bool &added)
+{
+    updateIdIndex(entities, idIndex);
+    added = false;
+    auto [indexIt, inserted] = idIndex.map.try_emplace(entity->id(), entities.size());
+
+    if (!inserted) {
+        // There's already an entity with this ID (it can be the same entity)
+        if (entities[indexIt->second] == entity)
+            return indexIt->second;
+
+        auto it = std::find(entities.begin(), entities.end(), entity);
+
+        if (it != entities.end())
+            return it - entities.begin();
+    }
+
+    entities.push_back(entity);
+    added = true;
+    return entities.size() - 1;
+}
+
+// Returns the index of the entity with the given ID
+template<typename T>
+static int findEntityById(const std::vector<std::shared_ptr<T>> &entities, EntityIdIndex &idIndex, const std::string &id)
+{
+    updateIdIndex(entities, idIndex);
+    auto indexIt = idIndex.map.find(id);
+
+    if (indexIt == idIndex.map.cend())
+        return -1;
+
+    assert(entities[indexIt->second]->id() == id);
+    return indexIt->second;
+}
+
+// Render versions are unique across all targets, so the highest render version of a group of targets changes whenever any of them changes
+static std::atomic<unsigned int> renderVersionCounter = 0;
+
+// Returns a non-zero frame identifier if collision query results can be cached
+static unsigned int collisionCacheFrame(IEngine *engine)
+{
+    return (engine && engine->collisionCacheEnabled()) ? engine->frameCount() + 1 : 0;
+}
+
 /*! Constructs target. */
 Target::Target() :
     Drawable(),
     impl(spimpl::make_unique_impl<TargetPrivate>())
 {
+    impl->renderVersion = ++renderVersionCounter;
 }
 
 /*! Destroys Target. */
@@ -35,6 +105,9 @@ Target::~Target()
     if (impl->variableData)
         free(impl->variableData);
 
+    if (impl->variableVersionData)
+        free(impl->variableVersionData);
+
     if (impl->listData)
         free(impl->listData);
 }
@@ -57,8 +130,10 @@ const std::string &Target::name() const
  */
 void Target::setName(const std::string &name)
 {
-    if (RESERVED_NAMES.find(name) == RESERVED_NAMES.cend())
+    if (RESERVED_NAMES.find(name) == RESERVED_NAMES.cend() && name != impl->name) {
         impl->name = name;
+        TargetPrivate::nameGeneration++;
+    }
 }
 
 /*! Returns the list of variables. */
@@ -70,16 +145,16 @@ const std::vector<std::shared_ptr<Variable>> &Target::variables() const
 /*! Adds a variable and returns its index. */
 int Target::addVariable(std::shared_ptr<Variable> variable)
 {
-    auto it = std::find(impl->variables.begin(), impl->variables.end(), variable);
-
-    if (it != impl->variables.end())
-        return it - impl->variables.begin();
+    bool added;
+    const int index = addEntity(impl->variables, impl->variableIndex, variable, added);
 
-    impl->variables.push_back(variable);
-    impl->variableDataDirty = true;
-    variable->setTarget(this);
+    if (added) {
+        impl->variableDataDirty = true;
+        impl->variableVersionDataDirty = true;
+        variable->setTarget(this);
+    }
 
-    return impl->variables.size() - 1;
+    return index;
 }
 
 /*! Returns the variable at index. */
@@ -105,12 +180,7 @@ int Target::findVariable(const std::string &variableName) const
 /*! Returns the index of the variable with the given ID. */
 int Target::findVariableById(const std::string &id) const
 {
-    auto it = std::find_if(impl->variables.begin(), impl->variables.end(), [id](std::shared_ptr<Variable> variable) { return variable->id() == id; });
-
-    if (it == impl->variables.end())
-        return -1;
-    else
-        return it - impl->variables.begin();
+    return findEntityById(impl->variables, impl->variableIndex, id);
 }
 
 /*! Returns an array of raw variable data pointers (for optimized variable access). */
@@ -138,6 +208,31 @@ ValueData **Target::variableData()
     return impl->variableData;
 }
 
+/*! Returns an array of variable version pointers (for tracking variable changes in compiled code). */
+unsigned int **Target::variableVersionData()
+{
+    if (impl->variableVersionDataDirty) {
+        const size_t len = impl->variables.size();
+
+        if (len == 0) {
+            impl->variableVersionDataDirty = false;
+            return nullptr;
+        }
+
+        if (impl->variableVersionData)
+            impl->variableVersionData = (unsigned int **)realloc(impl->variableVersionData, len * sizeof(unsigned int *));
+        else
+            impl->variableVersionData = (unsigned int **)malloc(len * sizeof(unsigned int *));
+
+        for (size_t i = 0; i < len; i++)
+            impl->variableVersionData[i] = impl->variables[i]->versionPtr();
+
+        impl->variableVersionDataDirty = false;
+    }
+
+    return impl->variableVersionData;
+}
+
 /*! Returns the list of Scratch lists. */
 const std::vector<std::shared_ptr<List>> &Target::lists() const
 {
@@ -147,16 +242,15 @@ const std::vector<std::shared_ptr<List>> &Target::lists() const
 /*! Adds a list and returns its index. */
 int Target::addList(std::shared_ptr<List> list)
 {
-    auto it = std::find(impl->lists.begin(), impl->lists.end(), list);
-
-    if (it != impl->lists.end())
-        return it - impl->lists.begin();
+    bool added;
+    const int index = addEntity(impl->lists, impl->listIndex, list, added);
 
-    impl->lists.push_back(list);
-    impl->listDataDirty = true;
-    list->setTarget(this);
+    if (added) {
+        impl->listDataDirty = true;
+        list->setTarget(this);
+    }
 
-    return impl->lists.size() - 1;
+    return index;
 }
 
 /*! Returns the list at index. */
@@ -182,12 +276,7 @@ int Target::findList(const std::string &listName) const
 /*! Returns the index of the list with the given ID. */
 int Target::findListById(const std::string &id) const
 {
-    auto it = std::find_if(impl->lists.begin(), impl->lists.end(), [id](std::shared_ptr<List> list) { return list->id() == id; });
-
-    if (it == impl->lists.end())
-        return -1;
-    else
-        return it - impl->lists.begin();
+    return findEntityById(impl->lists, impl->listIndex, id);
 }
 
 /*! Returns an array of list pointers (for optimized list access). */
@@ -230,13 +319,8 @@ int Target::addBlock(std::shared_ptr<Block> block)
     if (Target *source = dataSource())
         return source->addBlock(block);
 
-    auto it = std::find(impl->blocks.begin(), impl->blocks.end(), block);
-
-    if (it != impl->blocks.end())
-        return it - impl->blocks.begin();
-
-    impl->blocks.push_back(block);
-    return impl->blocks.size() - 1;
+    bool added;
+    return addEntity(impl->blocks, impl->blockIndex, block, added);
 }
 
 /*! Returns the block at index. */
@@ -257,12 +341,7 @@ int Target::findBlock(const std::string &id) const
     if (Target *source = dataSource())
         return source->findBlock(id);
 
-    auto it = std::find_if(impl->blocks.begin(), impl->blocks.end(), [id](std::shared_ptr<Block> block) { return block->id() == id; });
-
-    if (it == impl->blocks.end())
-        return -1;
-    else
-        return it - impl->blocks.begin();
+    return findEntityById(impl->blocks, impl->blockIndex, id);
 }
 
 /*! Returns list of all "when green flag clicked" blocks. */
@@ -294,13 +373,8 @@ int Target::addComment(std::shared_ptr<Comment> comment)
     if (Target *source = dataSource())
         return source->addComment(comment);
 
-    auto it = std::find(impl->comments.begin(), impl->comments.end(), comment);
-
-    if (it != impl->comments.end())
-        return it - impl->comments.begin();
-
-    impl->comments.push_back(comment);
-    return impl->comments.size() - 1;
+    bool added;
+    return addEntity(impl->comments, impl->commentIndex, comment, added);
 }
 
 /*! Returns the comment at index. */
@@ -321,12 +395,7 @@ int Target::findComment(const std::string &id) const
     if (Target *source = dataSource())
         return source->findComment(id);
 
-    auto it = std::find_if(impl->comments.begin(), impl->comments.end(), [id](std::shared_ptr<Comment> comment) { return comment->id() == id; });
-
-    if (it == impl->comments.end())
-        return -1;
-    else
-        return it - impl->comments.begin();
+    return findEntityById(impl->comments, impl->commentIndex, id);
 }
 
 /*! Returns the index of the current costume. */
@@ -338,8 +407,10 @@ int Target::costumeIndex() const
 /*! Sets the index of the current costume. */
 void Target::setCostumeIndex(int newCostumeIndex)
 {
-    if (newCostumeIndex >= 0 && newCostumeIndex < costumes().size())
+    if (newCostumeIndex >= 0 && newCostumeIndex < costumes().size()) {
         impl->costumeIndex = newCostumeIndex;
+        invalidateRenderState();
+    }
 
     if (isStage()) {
         IEngine *eng = engine();
@@ -541,6 +612,21 @@ Rect Target::fastBoundingRect() const
     return Rect();
 }
 
+/*!
+ * Returns a number which changes whenever the target changes in a way which affects rendering
+ * or collision detection (position, size, direction, costume, graphic effects, etc.).
+ */
+unsigned int Target::renderVersion() const
+{
+    return impl->renderVersion;
+}
+
+/*! Increments the render version. Call this after changing a property which affects rendering or collision detection. */
+void Target::invalidateRenderState()
+{
+    impl->renderVersion = ++renderVersionCounter;
+}
+
 /*! Returns true if the Target is touching the given Sprite (or its clones). */
 bool Target::touchingSprite(Sprite *sprite) const
 {
@@ -550,17 +636,61 @@ bool Target::touchingSprite(Sprite *sprite) const
 
     Sprite *firstClone = sprite->isClone() ? sprite->cloneSprite() : sprite;
     assert(firstClone);
+    const unsigned int frame = collisionCacheFrame(engine());
+    CollisionQueryResult *cached = nullptr;
+
+    if (frame) {
+        unsigned int version = std::max(renderVersion(), firstClone->renderVersion());
+        const auto &spriteClones = firstClone->clones();
+
+        for (auto clone : spriteClones)
+            version = std::max(version, clone->renderVersion());
+
+        cached = &impl->touchingSpriteCache[firstClone];
+
+        if (cached->frame == frame && cached->version == version && cached->count == spriteClones.size()) {
+            impl->collisionCacheHits++;
+            return cached->result;
+        }
+
+        impl->collisionCacheMisses++;
+        cached->frame = frame;
+        cached->version = version;
+        cached->count = spriteClones.size();
+    }
+
     std::vector<Sprite *> clones;
 
-    if (firstClone != this && firstClone->visible()) // TODO: Filter clones that are being dragged, including firstClone
+    // Skip clones whose bounds don't intersect the bounds of this target
+    // (fast bounding rectangles are cached until the render state of the target changes)
+    auto cachedFastBoundingRect = [](const Target *target) -> const Rect & {
+        const TargetPrivate *targetImpl = target->impl.get();
+
+        if (!targetImpl->fastBoundsValid || targetImpl->fastBoundsVersion != targetImpl->renderVersion) {
+            targetImpl->fastBounds = target->fastBoundingRect();
+            targetImpl->fastBoundsVersion = targetImpl->renderVersion;
+            targetImpl->fastBoundsValid = true;
+        }
+
+        return targetImpl->fastBounds;
+    };
+
+    const Rect &bounds = cachedFastBoundingRect(this);
+
+    if (firstClone != this && firstClone->visible() && cachedFastBoundingRect(firstClone).intersects(bounds)) // TODO: Filter clones that are being dragged, including firstClone
         clones.push_back(firstClone);
 
     for (auto clone : firstClone->clones()) {
-        if (clone.get() != this && clone->visible()) // TODO: Filter clones that are being dragged
+        if (clone.get() != this && clone->visible() && cachedFastBoundingRect(clone.get()).intersects(bounds)) // TODO: Filter clones that are being dragged
             clones.push_back(clone.get());
     }
 
-    return touchingClones(clones);
+    const bool result = clones.empty() ? false : touchingClones(clones);
+
+    if (cached)
+        cached->result = result;
+
+    return result;
 }
 
 /*! Returns true if the Target is touching the given point (in Scratch coordinates). */
@@ -575,16 +705,33 @@ bool Target::touchingEdge() const
     // https://github.com/scratchfoundation/scratch-vm/blob/8dbcc1fc8f8d8c4f1e40629fe8a388149d6dfd1c/src/sprites/rendered-target.js#L772-L785
     IEngine *eng = engine();
 
-    if (eng) {
-        const double stageWidth = eng->stageWidth();
-        const double stageHeight = eng->stageHeight();
-        Rect bounds = boundingRect();
+    if (!eng)
+        return false;
+
+    const unsigned int frame = collisionCacheFrame(eng);
+    CollisionQueryResult &cached = impl->touchingEdgeCache;
+
+    if (frame) {
+        if (cached.frame == frame && cached.version == impl->renderVersion) {
+            impl->collisionCacheHits++;
+            return cached.result;
+        }
 
-        if ((bounds.left() < -stageWidth / 2) || (bounds.right() > stageWidth / 2) || (bounds.top() > stageHeight / 2) || (bounds.bottom() < -stageHeight / 2))
-            return true;
+        impl->collisionCacheMisses++;
     }
 
-    return false;
+    const double stageWidth = eng->stageWidth();
+    const double stageHeight = eng->stageHeight();
+    Rect bounds = boundingRect();
+    const bool result = (bounds.left() < -stageWidth / 2) || (bounds.right() > stageWidth / 2) || (bounds.top() > stageHeight / 2) || (bounds.bottom() < -stageHeight / 2);
+
+    if (frame) {
+        cached.frame = frame;
+        cached.version = impl->renderVersion;
+        cached.result = result;
+    }
+
+    return result;
 }
 
 /*! Returns true if the Target is touching the given color (RGB triplet). */
@@ -599,6 +746,68 @@ bool Target::touchingColor(Rgb color, Rgb mask) const
     return false;
 }
 
+/*! Returns the number of touching queries answered from the collision cache. */
+unsigned long Target::collisionCacheHits() const
+{
+    return impl->collisionCacheHits;
+}
+
+/*! Returns the number of touching queries which had to be evaluated because the collision cache didn't contain a valid result. */
+unsigned long Target::collisionCacheMisses() const
+{
+    return impl->collisionCacheMisses;
+}
+
+/*!
+ * Looks up a cached result of touchingColor() (use masked = true for the mask variant).
+ * \returns true if the collision cache contains a valid result
+ */
+bool Target::findCachedTouchingColor(Rgb color, Rgb mask, bool masked, bool &result) const
+{
+    const unsigned int frame = collisionCacheFrame(engine());
+
+    if (!frame)
+        return false;
+
+    // Color queries depend on all targets, so use the latest render version
+    const CollisionQueryResult *cached = nullptr;
+
+    if (masked) {
+        auto it = impl->touchingMaskedColorCache.find(static_cast<uint64_t>(color) << 32 | mask);
+
+        if (it != impl->touchingMaskedColorCache.cend())
+            cached = &it->second;
+    } else {
+        auto it = impl->touchingColorCache.find(color);
+
+        if (it != impl->touchingColorCache.cend())
+            cached = &it->second;
+    }
+
+    if (cached && cached->frame == frame && cached->version == renderVersionCounter) {
+        impl->collisionCacheHits++;
+        result = cached->result;
+        return true;
+    }
+
+    impl->collisionCacheMisses++;
+    return false;
+}
+
+/*! Stores a result of touchingColor() in the collision cache (use masked = true for the mask variant). */
+void Target::cacheTouchingColor(Rgb color, Rgb mask, bool masked, bool result) const
+{
+    const unsigned int frame = collisionCacheFrame(engine());
+
+    if (!frame)
+        return;
+
+    CollisionQueryResult &cached = masked ? impl->touchingMaskedColorCache[static_cast<uint64_t>(color) << 32 | mask] : impl->touchingColorCache[color];
+    cached.frame = frame;
+    cached.version = renderVersionCounter;
+    cached.result = result;
+}
+
 /*! Returns the value of the given graphics effect. */
 double Target::graphicsEffectValue(IGraphicsEffect *effect) const
 {
@@ -616,14 +825,17 @@ double Target::graphicsEffectValue(IGraphicsEffect *effect) const
 /*! Sets the value of the given graphics effect. */
 void Target::setGraphicsEffectValue(IGraphicsEffect *effect, double value)
 {
-    if (effect)
+    if (effect) {
         impl->graphicsEffects[effect] = effect->clamp(value);
+        invalidateRenderState();
+    }
 }
 
 /*! Sets the value of all graphics effects to 0 (clears them). */
 void Target::clearGraphicsEffects()
 {
     impl->graphicsEffects.clear();
+    invalidateRenderState();
 }
 
 /*! Returns the Bubble of this Target. */
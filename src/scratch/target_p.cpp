@@ -4,6 +4,8 @@
 
 using namespace libscratchcpp;
 
+std::atomic<unsigned int> TargetPrivate::nameGeneration = 0;
+
 TargetPrivate::TargetPrivate()
 {
 }
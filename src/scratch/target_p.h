@@ -6,10 +6,12 @@
 #include <vector>
 #include <memory>
 #include <unordered_map>
+#include <atomic>
 #include <scratchcpp/costume.h>
 #include <scratchcpp/sound.h>
 #include <scratchcpp/target.h>
 #include <scratchcpp/textbubble.h>
+#include <scratchcpp/rect.h>
 
 namespace libscratchcpp
 {
@@ -20,6 +22,22 @@ class List;
 class Block;
 class Comment;
 class IGraphicsEffect;
+class Sprite;
+
+struct CollisionQueryResult
+{
+        unsigned int frame = 0;
+        unsigned int version = 0;
+        size_t count = 0;
+        bool result = false;
+};
+
+// Maps entity IDs to indices, rebuilt after an entity ID changes
+struct EntityIdIndex
+{
+        std::unordered_map<std::string, int> map;
+        unsigned int generation = 0;
+};
 
 struct TargetPrivate
 {
@@ -28,13 +46,19 @@ struct TargetPrivate
 
         std::string name;
         std::vector<std::shared_ptr<Variable>> variables;
+        mutable EntityIdIndex variableIndex;
         bool variableDataDirty = true;
         ValueData **variableData = nullptr;
+        bool variableVersionDataDirty = true;
+        unsigned int **variableVersionData = nullptr;
         std::vector<std::shared_ptr<List>> lists;
+        mutable EntityIdIndex listIndex;
         bool listDataDirty = true;
         List **listData = nullptr;
         std::vector<std::shared_ptr<Block>> blocks;
+        mutable EntityIdIndex blockIndex;
         std::vector<std::shared_ptr<Comment>> comments;
+        mutable EntityIdIndex commentIndex;
         int costumeIndex = -1;
         std::vector<std::shared_ptr<Costume>> costumes;
         std::vector<std::shared_ptr<Sound>> sounds;
@@ -42,6 +66,18 @@ struct TargetPrivate
         std::unordered_map<Sound::Effect, double> soundEffects;
         std::unordered_map<IGraphicsEffect *, double> graphicsEffects;
         TextBubble bubble;
+        unsigned int renderVersion = 0;
+        mutable bool fastBoundsValid = false;
+        mutable unsigned int fastBoundsVersion = 0;
+        mutable Rect fastBounds;
+        mutable std::unordered_map<const Sprite *, CollisionQueryResult> touchingSpriteCache;
+        mutable CollisionQueryResult touchingEdgeCache;
+        mutable std::unordered_map<Rgb, CollisionQueryResult> touchingColorCache;
+        mutable std::unordered_map<uint64_t, CollisionQueryResult> touchingMaskedColorCache;
+        mutable unsigned long collisionCacheHits = 0;
+        mutable unsigned long collisionCacheMisses = 0;
+
+        static std::atomic<unsigned int> nameGeneration; // increased when any target is renamed (see Engine::findTarget())
 };
 
 } // namespace libscratchcpp
@@ -2,7 +2,6 @@
 #include <scratchcpp/stringptr.h>
 #include <ctgmath>
 #include <cassert>
-#include <clocale>
 #include <utf8.h>
 
 #include "value_functions_p.h"
@@ -386,7 +385,7 @@ extern "C"
     LIBSCRATCHCPP_EXPORT void value_doubleToStringPtr(double v, StringPtr *dst)
     {
         if (v == 0)
-            string_assign_cstring(dst, "0");
+            string_assign(dst, &ZERO_STR);
         else if (std::isinf(v)) {
             if (v > 0)
                 string_assign(dst, &INFINITY_STR);
@@ -394,64 +393,8 @@ extern "C"
                 string_assign(dst, &NEGATIVE_INFINITY_STR);
         } else if (std::isnan(v))
             string_assign(dst, &NAN_STR);
-        else {
-            // snprintf() is locale-dependent
-            std::string oldLocale = std::setlocale(LC_NUMERIC, nullptr);
-            std::setlocale(LC_NUMERIC, "C");
-
-            const int maxlen = 26; // should be enough for any number
-            char *buffer = (char *)malloc((maxlen + 1) * sizeof(char));
-
-            // Constants for significant digits and thresholds
-            const int significantDigits = 17 - value_intDigitCount(std::floor(std::fabs(v)));
-            constexpr double scientificThreshold = 1e21;
-            constexpr double minScientificThreshold = 1e-6;
-
-            // Use scientific notation if the number is very large or very small
-            if (std::fabs(v) >= scientificThreshold || std::fabs(v) < minScientificThreshold) {
-                int ret = snprintf(buffer, maxlen, "%.*g", significantDigits - 1, v);
-                assert(ret >= 0);
-            } else {
-                snprintf(buffer, maxlen, "%.*f", significantDigits - 1, v);
-
-                // Remove trailing zeros from the fractional part
-                char *dot = std::strchr(buffer, '.');
-
-                if (dot) {
-                    char *end = buffer + std::strlen(buffer) - 1;
-                    while (end > dot && *end == '0') {
-                        *end-- = '\0';
-                    }
-                    if (*end == '.') {
-                        *end = '\0'; // Remove trailing dot
-                    }
-                }
-            }
-
-            // Remove leading zeros after e+/e-
-            for (int i = 0; i < 2; i++) {
-                const char *target = (i == 0) ? "e+" : "e-";
-                char *index = strstr(buffer, target);
-
-                if (index != nullptr) {
-                    char *ptr = index + 2;
-                    while (*(ptr + 1) != '\0' && *ptr == '0') {
-                        // Shift the characters left to erase '0'
-                        char *shiftPtr = ptr;
-                        do {
-                            *shiftPtr = *(shiftPtr + 1);
-                            shiftPtr++;
-                        } while (*shiftPtr != '\0');
-                    }
-                }
-            }
-
-            // Restore old locale
-            std::setlocale(LC_NUMERIC, oldLocale.c_str());
-
-            string_assign_cstring(dst, buffer);
-            free(buffer);
-        }
+        else
+            value_doubleToStringImpl(v, dst);
     }
 
     /*!
@@ -466,12 +409,7 @@ extern "C"
     /*! Converts the given string to double. */
     LIBSCRATCHCPP_EXPORT double value_stringToDouble(const StringPtr *s)
     {
-        if (strings_equal_case_sensitive(s, &INFINITY_STR))
-            return std::numeric_limits<double>::infinity();
-        else if (strings_equal_case_sensitive(s, &NEGATIVE_INFINITY_STR))
-            return -std::numeric_limits<double>::infinity();
-
-        return value_stringToDoubleImpl(s->data, s->size);
+        return value_stringToDoubleCached(s);
     }
 
     /*!
@@ -480,14 +418,7 @@ extern "C"
      */
     LIBSCRATCHCPP_EXPORT double value_stringToDoubleWithCheck(const StringPtr *s, bool *ok)
     {
-        *ok = true;
-
-        if (strings_equal_case_sensitive(s, &INFINITY_STR))
-            return std::numeric_limits<double>::infinity();
-        else if (strings_equal_case_sensitive(s, &NEGATIVE_INFINITY_STR))
-            return -std::numeric_limits<double>::infinity();
-
-        return value_stringToDoubleImpl(s->data, s->size, ok);
+        return value_stringToDoubleCached(s, ok);
     }
 
     /*! Converts the given string to boolean. */
@@ -11,6 +11,7 @@
 #include <ctgmath>
 #include <charconv>
 #include <cassert>
+#include <cstring>
 #include <utf8.h>
 
 #include "thirdparty/fast_float/fast_float.h"
@@ -61,6 +62,145 @@ inline unsigned int value_digitCount(T v)
     return i + j;
 }
 
+// Pairs of decimal digits: "00", "01", ..., "99"
+struct DigitPairTable
+{
+        constexpr DigitPairTable() :
+            data()
+        {
+            for (int i = 0; i < 100; i++) {
+                data[i * 2] = u'0' + i / 10;
+                data[i * 2 + 1] = u'0' + i % 10;
+            }
+        }
+
+        char16_t data[200];
+};
+
+static constexpr DigitPairTable DIGIT_PAIRS;
+
+// Writes the digits of v so that they end at the given position and returns the first digit
+inline char16_t *value_writeUInt(char16_t *end, uint64_t v)
+{
+    while (v >= 100) {
+        const unsigned int i = (v % 100) * 2;
+        v /= 100;
+        *--end = DIGIT_PAIRS.data[i + 1];
+        *--end = DIGIT_PAIRS.data[i];
+    }
+
+    if (v >= 10) {
+        *--end = DIGIT_PAIRS.data[v * 2 + 1];
+        *--end = DIGIT_PAIRS.data[v * 2];
+    } else
+        *--end = u'0' + v;
+
+    return end;
+}
+
+// Converts a finite, non-zero number to string like JavaScript's Number.prototype.toString()
+inline void value_doubleToStringImpl(double v, StringPtr *dst)
+{
+    const bool negative = v < 0;
+    const double abs = negative ? -v : v;
+
+    // Integers up to 2^53 are their own shortest representation
+    if (abs < 9007199254740992.0 && abs == std::trunc(abs)) {
+        char16_t buffer[17];
+        char16_t *end = buffer + 17;
+        char16_t *begin = value_writeUInt(end, static_cast<uint64_t>(abs));
+
+        if (negative)
+            *--begin = u'-';
+
+        const size_t len = end - begin;
+        string_alloc(dst, len);
+        memcpy(dst->data, begin, len * sizeof(char16_t));
+        dst->data[len] = u'\0';
+        dst->size = len;
+        return;
+    }
+
+    // Shortest digits which round-trip, e.g. "1.2345e+2"
+    char sci[32];
+    auto [sciEnd, ec] = std::to_chars(sci, sci + sizeof(sci), abs, std::chars_format::scientific);
+    assert(ec == std::errc{});
+
+    char digits[17];
+    int k = 0; // digit count
+    const char *p = sci;
+
+    for (; *p != 'e'; p++) {
+        if (*p != '.')
+            digits[k++] = *p;
+    }
+
+    int exponent = 0;
+    std::from_chars(p + (p[1] == '+' ? 2 : 1), sciEnd, exponent);
+    const int n = exponent + 1; // decimal point position
+
+    // See Number::toString in the ECMAScript specification
+    char16_t out[32];
+    char16_t *w = out;
+
+    if (negative)
+        *w++ = u'-';
+
+    if (k <= n && n <= 21) {
+        // 123000
+        for (int i = 0; i < k; i++)
+            *w++ = digits[i];
+
+        for (int i = k; i < n; i++)
+            *w++ = u'0';
+    } else if (0 < n && n <= 21) {
+        // 123.45
+        for (int i = 0; i < n; i++)
+            *w++ = digits[i];
+
+        *w++ = u'.';
+
+        for (int i = n; i < k; i++)
+            *w++ = digits[i];
+    } else if (-6 < n && n <= 0) {
+        // 0.00012345
+        *w++ = u'0';
+        *w++ = u'.';
+
+        for (int i = n; i < 0; i++)
+            *w++ = u'0';
+
+        for (int i = 0; i < k; i++)
+            *w++ = digits[i];
+    } else {
+        // 1.2345e+21, 1e-7
+        *w++ = digits[0];
+
+        if (k > 1) {
+            *w++ = u'.';
+
+            for (int i = 1; i < k; i++)
+                *w++ = digits[i];
+        }
+
+        *w++ = u'e';
+        *w++ = exponent < 0 ? u'-' : u'+';
+
+        char16_t expBuffer[3];
+        char16_t *expEnd = expBuffer + 3;
+        char16_t *expBegin = value_writeUInt(expEnd, exponent < 0 ? -exponent : exponent);
+
+        while (expBegin < expEnd)
+            *w++ = *expBegin++;
+    }
+
+    const size_t len = w - out;
+    string_alloc(dst, len);
+    memcpy(dst->data, out, len * sizeof(char16_t));
+    dst->data[len] = u'\0';
+    dst->size = len;
+}
+
 extern "C"
 {
     inline bool value_isInf(double v)
@@ -345,9 +485,33 @@ extern "C"
         return 0;
     }
 
+    // Converts the string to double and caches the result in the string
+    inline double value_stringToDoubleCached(const StringPtr *s, bool *ok = nullptr)
+    {
+        if (s->numberState == StringPtr::NumberState::Unknown) {
+            bool valid = true;
+            double ret;
+
+            if (strings_equal_case_sensitive(s, &INFINITY_STR))
+                ret = std::numeric_limits<double>::infinity();
+            else if (strings_equal_case_sensitive(s, &NEGATIVE_INFINITY_STR))
+                ret = -std::numeric_limits<double>::infinity();
+            else
+                ret = value_stringToDoubleImpl(s->data, s->size, &valid);
+
+            s->numberValue = ret;
+            s->numberState = valid ? StringPtr::NumberState::Valid : StringPtr::NumberState::Invalid;
+        }
+
+        if (ok)
+            *ok = (s->numberState == StringPtr::NumberState::Valid);
+
+        return s->numberValue;
+    }
+
     inline long value_stringToLong(const StringPtr *s, bool *ok = nullptr)
     {
-        const double ret = value_stringToDoubleImpl(s->data, s->size, ok);
+        const double ret = value_stringToDoubleCached(s, ok);
 
         if (std::isinf(ret))
             return 0;
@@ -387,7 +551,7 @@ extern "C"
             value_stringToLong(str, &ok);
             return ok ? 1 : 0;
         } else {
-            value_stringToDoubleImpl(str->data, str->size, &ok);
+            value_stringToDoubleCached(str, &ok);
             return ok ? 2 : 0;
         }
     }
@@ -401,7 +565,7 @@ extern "C"
         // Since functions calling this already prioritize int, double and bool,
         // we can optimize by prioritizing the other types here.
         if (v->type == ValueType::String)
-            return value_stringToDoubleImpl(v->stringValue->data, v->stringValue->size, ok);
+            return value_stringToDoubleCached(v->stringValue, ok);
         else if (v->type == ValueType::Number) {
             if (std::isnan(v->numberValue)) {
                 *ok = false;
@@ -35,6 +35,25 @@ Value *Variable::valuePtr()
 void Variable::setValue(const Value &value)
 {
     impl->value = value;
+    impl->version++;
+}
+
+/*!
+ * Returns the version of the value. It is incremented every time the value changes,
+ * so it can be used to detect changes (e.g. in monitors).
+ */
+unsigned int Variable::version() const
+{
+    return impl->version;
+}
+
+/*!
+ * Returns a pointer to the version of the value.
+ * \note This is used internally by compiled code to bump the version after writing the value.
+ */
+unsigned int *Variable::versionPtr()
+{
+    return &impl->version;
 }
 
 /*! Returns true if the variable is a cloud variable. */
@@ -20,6 +20,7 @@ struct VariablePrivate
         bool isCloudVariable;
         Target *target = nullptr;
         Monitor *monitor = nullptr;
+        unsigned int version = 0;
 };
 
 } // namespace libscratchcpp
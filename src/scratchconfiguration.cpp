@@ -5,6 +5,8 @@
 #include <algorithm>
 
 #include "scratchconfiguration_p.h"
+#include "scratch/assetcache.h"
+#include "audio/iaudioengine.h"
 
 using namespace libscratchcpp;
 
@@ -62,6 +64,55 @@ IGraphicsEffect *ScratchConfiguration::getGraphicsEffect(const std::string &name
     return nullptr;
 }
 
+/*! Returns the maximum size of lazily loaded asset data in bytes (0 means no limit). */
+size_t ScratchConfiguration::assetMemoryBudget()
+{
+    return AssetCache::instance().memoryBudget();
+}
+
+/*!
+ * Sets the maximum size of lazily loaded asset data in bytes (0 means no limit).
+ * When the budget is exceeded, the least recently used asset data is evicted and loaded again on next access.
+ * \note Data which has been read using Asset::data() is never evicted, use Asset::sharedData() to read evictable data.
+ * \see Asset::setDataLoader()
+ */
+void ScratchConfiguration::setAssetMemoryBudget(size_t bytes)
+{
+    AssetCache::instance().setMemoryBudget(bytes);
+}
+
+/*! Returns the maximum size of decoded sound data in bytes (0 means no limit). */
+size_t ScratchConfiguration::audioMemoryBudget()
+{
+    return IAudioEngine::instance()->decodedMemoryBudget();
+}
+
+/*!
+ * Sets the maximum size of decoded sound data in bytes (0 means no limit).
+ * Short sounds are decoded to PCM on load, long sounds (and sounds which don't fit into the budget) are decoded while playing.
+ * When the budget is exceeded, the PCM data of the least recently played sounds is released and decoded again on next start.
+ */
+void ScratchConfiguration::setAudioMemoryBudget(size_t bytes)
+{
+    IAudioEngine::instance()->setDecodedMemoryBudget(bytes);
+}
+
+/*! Returns true if sounds are mixed without an audio device. */
+bool ScratchConfiguration::offlineAudio()
+{
+    return IAudioEngine::instance()->isOffline();
+}
+
+/*!
+ * Enables or disables offline audio. In offline mode, no audio device is used and sounds are mixed
+ * in lockstep with IEngine::step() (see IEngine::renderedAudio()), which is useful for headless runs.
+ * \note The mode can't be changed while any sound is loaded, so call this before loading any project.
+ */
+void ScratchConfiguration::setOfflineAudio(bool enabled)
+{
+    IAudioEngine::instance()->setOffline(enabled);
+}
+
 /*! Returns the version string of the library. */
 const std::string &ScratchConfiguration::version()
 {
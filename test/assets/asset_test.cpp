@@ -1,5 +1,6 @@
 #include <scratchcpp/asset.h>
 #include <scratchcpp/target.h>
+#include <scratchcpp/scratchconfiguration.h>
 
 #include "../common.h"
 #include "testasset.h"
@@ -44,11 +45,205 @@ TEST(AssetTest, Data)
 
     asset.setData(5, data);
     ASSERT_EQ(asset.data(), data);
+    ASSERT_EQ(asset.sharedData().get(), data);
     ASSERT_EQ(asset.size, 5);
     ASSERT_EQ(asset.processedData, data);
     ASSERT_EQ(asset.callCount, 2);
 }
 
+TEST(AssetTest, SharedData)
+{
+    auto buffer = std::make_shared<std::string>("abcd");
+    std::shared_ptr<const void> data(buffer, buffer->data());
+
+    {
+        TestAsset asset;
+        asset.setData(4, data);
+        ASSERT_EQ(asset.data(), buffer->data());
+        ASSERT_EQ(asset.dataSize(), 4);
+        ASSERT_EQ(asset.processedData, buffer->data());
+        ASSERT_EQ(asset.callCount, 1);
+        ASSERT_EQ(data.use_count(), 3); // buffer, data and the asset
+        ASSERT_EQ(asset.sharedData(), data);
+
+        // Should release the shared buffer in setData()
+        char *ownedData = (char *)malloc(4 * sizeof(char));
+        asset.setData(4, ownedData);
+        ASSERT_EQ(asset.data(), ownedData);
+        ASSERT_EQ(data.use_count(), 2);
+
+        asset.setData(4, data);
+        ASSERT_EQ(data.use_count(), 3);
+    }
+
+    // Should release the shared buffer in the destructor
+    ASSERT_EQ(data.use_count(), 2);
+}
+
+TEST(AssetTest, DataLoader)
+{
+    auto buffer = std::make_shared<std::string>("abcd");
+    int loadCount = 0;
+
+    auto loader = [buffer, &loadCount](std::shared_ptr<const void> &data) {
+        loadCount++;
+        data = std::shared_ptr<const void>(buffer, buffer->data());
+        return buffer->size();
+    };
+
+    TestAsset asset;
+    asset.setDataLoader(loader);
+    ASSERT_FALSE(asset.isDataLoaded());
+    ASSERT_EQ(loadCount, 0);
+    ASSERT_EQ(asset.callCount, 0);
+
+    // Should load the data on first access
+    ASSERT_EQ(asset.data(), buffer->data());
+    ASSERT_EQ(asset.dataSize(), 4);
+    ASSERT_TRUE(asset.isDataLoaded());
+    ASSERT_EQ(loadCount, 1);
+    ASSERT_EQ(asset.processedData, buffer->data());
+    ASSERT_EQ(asset.callCount, 1);
+
+    // Prefetch
+    TestAsset asset2;
+    asset2.setDataLoader(loader);
+    asset2.prefetch();
+    ASSERT_TRUE(asset2.isDataLoaded());
+    ASSERT_EQ(loadCount, 2);
+
+    // Setting the data removes the loader
+    char *data = (char *)malloc(4 * sizeof(char));
+    asset2.setData(4, data);
+    ASSERT_EQ(asset2.data(), data);
+    ASSERT_TRUE(asset2.isDataLoaded());
+    ASSERT_EQ(loadCount, 2);
+}
+
+TEST(AssetTest, MemoryBudget)
+{
+    int loadCount = 0;
+
+    // Each asset loads its own buffer
+    auto loader = [&loadCount](std::shared_ptr<const void> &data) {
+        loadCount++;
+        auto buffer = std::make_shared<std::string>("abcd");
+        data = std::shared_ptr<const void>(buffer, buffer->data());
+        return buffer->size();
+    };
+
+    ASSERT_EQ(ScratchConfiguration::assetMemoryBudget(), 0);
+    ScratchConfiguration::setAssetMemoryBudget(8);
+    ASSERT_EQ(ScratchConfiguration::assetMemoryBudget(), 8);
+
+    {
+        TestAsset asset1, asset2, asset3;
+        asset1.setDataLoader(loader);
+        asset2.setDataLoader(loader);
+        asset3.setDataLoader(loader);
+
+        asset1.prefetch();
+        asset2.prefetch();
+        ASSERT_TRUE(asset1.isDataLoaded());
+        ASSERT_TRUE(asset2.isDataLoaded());
+
+        // asset1 is used more recently than asset2
+        asset1.prefetch();
+
+        // Loading asset3 exceeds the budget, so the least recently used data should be evicted
+        asset3.prefetch();
+        ASSERT_TRUE(asset1.isDataLoaded());
+        ASSERT_FALSE(asset2.isDataLoaded());
+        ASSERT_TRUE(asset3.isDataLoaded());
+        ASSERT_EQ(loadCount, 3);
+
+        // Evicted data should be loaded again
+        ASSERT_TRUE(asset2.sharedData());
+        ASSERT_EQ(loadCount, 4);
+        ASSERT_FALSE(asset1.isDataLoaded());
+
+        // Lowering the budget evicts data immediately
+        ScratchConfiguration::setAssetMemoryBudget(4);
+        ASSERT_TRUE(asset2.isDataLoaded());
+        ASSERT_FALSE(asset3.isDataLoaded());
+    }
+
+    ScratchConfiguration::setAssetMemoryBudget(0);
+}
+
+TEST(AssetTest, MemoryBudgetSharedBuffer)
+{
+    auto buffer = std::make_shared<std::string>("abcd");
+    auto otherBuffer = std::make_shared<std::string>("efgh");
+
+    auto loader = [buffer](std::shared_ptr<const void> &data) {
+        data = std::shared_ptr<const void>(buffer, buffer->data());
+        return buffer->size();
+    };
+
+    auto otherLoader = [otherBuffer](std::shared_ptr<const void> &data) {
+        data = std::shared_ptr<const void>(otherBuffer, otherBuffer->data());
+        return otherBuffer->size();
+    };
+
+    ScratchConfiguration::setAssetMemoryBudget(8);
+
+    {
+        TestAsset asset1, asset2, asset3;
+        asset1.setDataLoader(loader);
+        asset2.setDataLoader(loader);
+        asset3.setDataLoader(otherLoader);
+        const long useCount = buffer.use_count();
+
+        // The shared buffer is counted once
+        asset1.prefetch();
+        asset2.prefetch();
+        asset3.prefetch();
+        ASSERT_TRUE(asset1.isDataLoaded());
+        ASSERT_TRUE(asset2.isDataLoaded());
+        ASSERT_TRUE(asset3.isDataLoaded());
+        ASSERT_EQ(buffer.use_count(), useCount + 2);
+
+        // Assets sharing a buffer are evicted together, so that the buffer is released
+        ScratchConfiguration::setAssetMemoryBudget(4);
+        ASSERT_FALSE(asset1.isDataLoaded());
+        ASSERT_FALSE(asset2.isDataLoaded());
+        ASSERT_TRUE(asset3.isDataLoaded());
+        ASSERT_EQ(buffer.use_count(), useCount);
+    }
+
+    ScratchConfiguration::setAssetMemoryBudget(0);
+}
+
+TEST(AssetTest, SharedDataOutlivesEviction)
+{
+    auto loader = [](std::shared_ptr<const void> &data) {
+        auto buffer = std::make_shared<std::string>("abcd");
+        data = std::shared_ptr<const void>(buffer, buffer->data());
+        return buffer->size();
+    };
+
+    ScratchConfiguration::setAssetMemoryBudget(4);
+
+    {
+        TestAsset asset1, asset2;
+        asset1.setDataLoader(loader);
+        asset2.setDataLoader(loader);
+
+        std::shared_ptr<const void> data = asset1.sharedData();
+        ASSERT_TRUE(data);
+        ASSERT_EQ(data, asset1.sharedData());
+
+        // The evicted buffer stays valid while it's used
+        asset2.prefetch();
+        ASSERT_FALSE(asset1.isDataLoaded());
+        ASSERT_EQ(data.use_count(), 1);
+        ASSERT_EQ(std::string(static_cast<const char *>(data.get()), 4), "abcd");
+    }
+
+    ScratchConfiguration::setAssetMemoryBudget(0);
+}
+
 TEST(AssetTest, Target)
 {
     Asset asset("sound1", "a", "wav");
@@ -58,3 +253,43 @@ TEST(AssetTest, Target)
     asset.setTarget(&target);
     ASSERT_EQ(asset.target(), &target);
 }
+
+TEST(AssetTest, DataIsNotEvictedAfterAccess)
+{
+    auto loader = [](std::shared_ptr<const void> &data) {
+        auto buffer = std::make_shared<std::string>("abcd");
+        data = std::shared_ptr<const void>(buffer, buffer->data());
+        return buffer->size();
+    };
+
+    ScratchConfiguration::setAssetMemoryBudget(4);
+
+    {
+        TestAsset asset1, asset2, asset3;
+        asset1.setDataLoader(loader);
+        asset2.setDataLoader(loader);
+        asset3.setDataLoader(loader);
+
+        // The pointer returned by data() can't be invalidated
+        const void *data = asset1.data();
+        ASSERT_TRUE(data);
+        asset2.prefetch();
+        ASSERT_TRUE(asset1.isDataLoaded());
+        ASSERT_TRUE(asset2.isDataLoaded());
+        ASSERT_EQ(asset1.data(), data);
+
+        // Data which hasn't been returned by data() can still be evicted
+        asset3.prefetch();
+        ASSERT_TRUE(asset1.isDataLoaded());
+        ASSERT_FALSE(asset2.isDataLoaded());
+        ASSERT_TRUE(asset3.isDataLoaded());
+
+        // Replacing the data unpins it
+        asset1.setDataLoader(loader);
+        asset1.prefetch();
+        asset2.prefetch();
+        ASSERT_FALSE(asset1.isDataLoaded());
+    }
+
+    ScratchConfiguration::setAssetMemoryBudget(0);
+}
@@ -185,17 +185,16 @@ TEST_F(SoundTest, Clone)
     EXPECT_CALL(*m_player, load(3, data, 44100)).WillOnce(Return(true));
     sound->setData(3, data);
 
-    auto clonePlayer = std::make_shared<AudioPlayerMock>();
-    EXPECT_CALL(m_playerFactory, createAudioPlayer()).WillOnce(Return(clonePlayer));
+    EXPECT_CALL(*m_player, setVolume(0.45));
+    sound->setVolume(45);
+    EXPECT_CALL(*m_player, setPitch(2));
+    sound->setEffect(Sound::Effect::Pitch, 120);
+    EXPECT_CALL(*m_player, setPan(-0.75));
+    sound->setEffect(Sound::Effect::Pan, -75);
+
+    // Clones don't create a player
+    EXPECT_CALL(m_playerFactory, createAudioPlayer()).Times(0);
     EXPECT_CALL(*m_player, isLoaded()).WillOnce(Return(true));
-    EXPECT_CALL(*clonePlayer, loadCopy(m_player.get())).WillOnce(Return(true));
-    EXPECT_CALL(*m_player, volume()).WillOnce(Return(0.45));
-    EXPECT_CALL(*clonePlayer, setVolume(0.45));
-    EXPECT_CALL(*m_player, pitch()).WillOnce(Return(1.25));
-    EXPECT_CALL(*clonePlayer, setPitch(1.25));
-    EXPECT_CALL(*m_player, pan()).WillOnce(Return(-0.75));
-    EXPECT_CALL(*clonePlayer, setPan(-0.75));
-    EXPECT_CALL(*clonePlayer, isLoaded()).WillOnce(Return(true));
     auto clone = sound->clone();
     ASSERT_TRUE(clone);
     ASSERT_EQ(clone->name(), sound->name());
@@ -203,70 +202,118 @@ TEST_F(SoundTest, Clone)
     ASSERT_EQ(clone->dataFormat(), sound->dataFormat());
     ASSERT_EQ(clone->rate(), sound->rate());
     ASSERT_EQ(clone->sampleCount(), sound->sampleCount());
+    ASSERT_EQ(clone->data(), sound->data());
+    ASSERT_FALSE(clone->isPlaying());
+
+    clone->setVolume(62);
 
-    auto cloneClonePlayer = std::make_shared<AudioPlayerMock>();
-    EXPECT_CALL(m_playerFactory, createAudioPlayer()).WillOnce(Return(cloneClonePlayer));
     EXPECT_CALL(*m_player, isLoaded()).WillOnce(Return(true));
-    EXPECT_CALL(*cloneClonePlayer, loadCopy(m_player.get())).WillOnce(Return(true));
-    EXPECT_CALL(*clonePlayer, volume()).WillOnce(Return(0.62));
-    EXPECT_CALL(*cloneClonePlayer, setVolume(0.62));
-    EXPECT_CALL(*clonePlayer, pitch()).WillOnce(Return(0.5));
-    EXPECT_CALL(*cloneClonePlayer, setPitch(0.5));
-    EXPECT_CALL(*clonePlayer, pan()).WillOnce(Return(0.25));
-    EXPECT_CALL(*cloneClonePlayer, setPan(0.25));
-    EXPECT_CALL(*cloneClonePlayer, isLoaded()).WillOnce(Return(true));
     auto cloneClone = clone->clone();
     ASSERT_TRUE(cloneClone);
 
-    auto anotherClonePlayer = std::make_shared<AudioPlayerMock>();
-    EXPECT_CALL(m_playerFactory, createAudioPlayer()).WillOnce(Return(anotherClonePlayer));
-    EXPECT_CALL(*m_player, isLoaded()).WillOnce(Return(false));
-    EXPECT_CALL(*anotherClonePlayer, loadCopy).Times(0);
-    EXPECT_CALL(*clonePlayer, volume()).WillOnce(Return(0.62));
-    EXPECT_CALL(*anotherClonePlayer, setVolume(0.62));
-    EXPECT_CALL(*clonePlayer, pitch()).WillOnce(Return(2));
-    EXPECT_CALL(*anotherClonePlayer, setPitch(2));
-    EXPECT_CALL(*clonePlayer, pan()).WillOnce(Return(1));
-    EXPECT_CALL(*anotherClonePlayer, setPan(1));
-    EXPECT_CALL(*anotherClonePlayer, isLoaded()).Times(0);
-    auto anotherClone = clone->clone();
-    ASSERT_TRUE(anotherClone);
-
-    // Stopping/starting the sound should stop its clones
-    auto anotherPlayer = std::make_shared<AudioPlayerMock>();
-    EXPECT_CALL(m_playerFactory, createAudioPlayer()).WillOnce(Return(anotherPlayer));
-    auto another = std::make_shared<Sound>("another", "c", "mp3");
-    Sprite sprite;
-    EngineMock engine;
-    sprite.setEngine(&engine);
-
-    EXPECT_CALL(engine, cloneLimit()).WillOnce(Return(-1));
-    EXPECT_CALL(engine, initClone);
-    EXPECT_CALL(engine, requestRedraw);
-    EXPECT_CALL(engine, moveDrawableBehindOther);
-    auto spriteClone = sprite.clone();
-
-    EXPECT_CALL(*anotherPlayer, setVolume).Times(2);
-    EXPECT_CALL(*m_player, setVolume);
-    EXPECT_CALL(*clonePlayer, setVolume);
-    sprite.addSound(another);
-    sprite.addSound(sound);
-    spriteClone->addSound(another);
-    spriteClone->addSound(clone);
+    // The voice is acquired when a clone starts
+    auto voice = std::make_shared<AudioPlayerMock>();
+    EXPECT_CALL(m_playerFactory, createAudioPlayer()).WillOnce(Return(voice));
+    EXPECT_CALL(*voice, isLoaded()).WillOnce(Return(false));
+    EXPECT_CALL(*m_player, isLoaded()).WillOnce(Return(true));
+    EXPECT_CALL(*voice, loadCopy(m_player.get())).WillOnce(Return(true));
+    EXPECT_CALL(*voice, setVolume(0.62f));
+    EXPECT_CALL(*voice, setPitch(2));
+    EXPECT_CALL(*voice, setPan(-0.75));
+    EXPECT_CALL(*m_player, stop());
+    EXPECT_CALL(*voice, start());
+    cloneClone->start();
 
+    EXPECT_CALL(*voice, isPlaying()).WillOnce(Return(true));
+    ASSERT_TRUE(cloneClone->isPlaying());
+    ASSERT_FALSE(clone->isPlaying());
+
+    // Another clone takes the voice (the previous voice is released)
+    auto voice2 = std::make_shared<AudioPlayerMock>();
     EXPECT_CALL(*m_player, stop());
-    EXPECT_CALL(*clonePlayer, stop());
-    sound->stop();
+    EXPECT_CALL(*voice, stop());
+    EXPECT_CALL(m_playerFactory, createAudioPlayer()).WillOnce(Return(voice2));
+    EXPECT_CALL(*voice2, isLoaded()).WillOnce(Return(false));
+    EXPECT_CALL(*m_player, isLoaded()).WillOnce(Return(true));
+    EXPECT_CALL(*voice2, loadCopy(m_player.get())).WillOnce(Return(true));
+    EXPECT_CALL(*voice2, setVolume(0.62f));
+    EXPECT_CALL(*voice2, setPitch(2));
+    EXPECT_CALL(*voice2, setPan(-0.75));
+    EXPECT_CALL(*voice2, start());
+    clone->start();
+    ASSERT_EQ(voice.use_count(), 1);
+    ASSERT_FALSE(cloneClone->isPlaying());
 
+    EXPECT_CALL(*voice2, setVolume(0.5));
+    clone->setVolume(50);
+    cloneClone->setVolume(20);
+
+    // Stopping/starting the sound should stop its clones and release the voice
     EXPECT_CALL(*m_player, stop());
-    EXPECT_CALL(*clonePlayer, stop());
-    clone->stop();
+    EXPECT_CALL(*voice2, stop());
+    sound->stop();
+    ASSERT_EQ(voice2.use_count(), 1);
+    ASSERT_FALSE(clone->isPlaying());
 
     EXPECT_CALL(*m_player, start());
-    EXPECT_CALL(*clonePlayer, stop());
     sound->start();
 
     EXPECT_CALL(*m_player, stop());
-    EXPECT_CALL(*clonePlayer, start());
+    clone->stop();
+
+    EXPECT_CALL(*m_player, stop());
+    cloneClone->stop();
+
+    // The voice is released when its owner stops
+    auto voice3 = std::make_shared<AudioPlayerMock>();
+    EXPECT_CALL(*m_player, stop());
+    EXPECT_CALL(m_playerFactory, createAudioPlayer()).WillOnce(Return(voice3));
+    EXPECT_CALL(*voice3, isLoaded()).WillOnce(Return(false));
+    EXPECT_CALL(*m_player, isLoaded()).WillOnce(Return(true));
+    EXPECT_CALL(*voice3, loadCopy(m_player.get())).WillOnce(Return(true));
+    EXPECT_CALL(*voice3, setVolume(0.5f));
+    EXPECT_CALL(*voice3, setPitch(2));
+    EXPECT_CALL(*voice3, setPan(-0.75));
+    EXPECT_CALL(*voice3, start());
+    clone->start();
+
+    EXPECT_CALL(*m_player, stop());
+    EXPECT_CALL(*voice3, stop());
+    clone->stop();
+    ASSERT_EQ(voice3.use_count(), 1);
+
+    // ...or when the sound finishes
+    auto voice4 = std::make_shared<AudioPlayerMock>();
+    EXPECT_CALL(*m_player, stop());
+    EXPECT_CALL(m_playerFactory, createAudioPlayer()).WillOnce(Return(voice4));
+    EXPECT_CALL(*voice4, isLoaded()).WillOnce(Return(false));
+    EXPECT_CALL(*m_player, isLoaded()).WillOnce(Return(true));
+    EXPECT_CALL(*voice4, loadCopy(m_player.get())).WillOnce(Return(true));
+    EXPECT_CALL(*voice4, setVolume(0.5f));
+    EXPECT_CALL(*voice4, setPitch(2));
+    EXPECT_CALL(*voice4, setPan(-0.75));
+    EXPECT_CALL(*voice4, start());
+    clone->start();
+
+    EXPECT_CALL(*voice4, isPlaying()).WillOnce(Return(false));
+    EXPECT_CALL(*voice4, stop());
+    ASSERT_FALSE(clone->isPlaying());
+    ASSERT_EQ(voice4.use_count(), 1);
+
+    // ...or when it's destroyed
+    auto voice5 = std::make_shared<AudioPlayerMock>();
+    EXPECT_CALL(*m_player, stop());
+    EXPECT_CALL(m_playerFactory, createAudioPlayer()).WillOnce(Return(voice5));
+    EXPECT_CALL(*voice5, isLoaded()).WillOnce(Return(false));
+    EXPECT_CALL(*m_player, isLoaded()).WillOnce(Return(true));
+    EXPECT_CALL(*voice5, loadCopy(m_player.get())).WillOnce(Return(true));
+    EXPECT_CALL(*voice5, setVolume(0.5f));
+    EXPECT_CALL(*voice5, setPitch(2));
+    EXPECT_CALL(*voice5, setPan(-0.75));
+    EXPECT_CALL(*voice5, start());
     clone->start();
+
+    EXPECT_CALL(*voice5, stop());
+    clone.reset();
+    ASSERT_EQ(voice5.use_count(), 1);
 }
@@ -1,5 +1,8 @@
+#include <scratchcpp/scratchconfiguration.h>
+
 #ifdef LIBSCRATCHCPP_AUDIO_SUPPORT
 #include <audio/internal/audioengine.h>
+#include <audio/internal/audioplayer.h>
 #else
 #include <audio/internal/audioenginestub.h>
 #endif
@@ -29,3 +32,79 @@ TEST(AudioEngineTest, Volume)
     engine->setVolume(0.86f);
     ASSERT_EQ(engine->volume(), 0.86f);
 }
+
+TEST(AudioEngineTest, DecodedMemoryBudget)
+{
+    IAudioEngine *engine = IAudioEngine::instance();
+    ASSERT_TRUE(engine);
+    ASSERT_EQ(engine->decodedMemoryBudget(), 64 * 1024 * 1024);
+    ASSERT_EQ(engine->decodedMemoryUsage(), 0);
+
+    engine->setDecodedMemoryBudget(1024);
+    ASSERT_EQ(engine->decodedMemoryBudget(), 1024);
+    ASSERT_EQ(ScratchConfiguration::audioMemoryBudget(), 1024);
+
+    ScratchConfiguration::setAudioMemoryBudget(0);
+    ASSERT_EQ(engine->decodedMemoryBudget(), 0);
+
+    engine->setDecodedMemoryBudget(64 * 1024 * 1024);
+}
+
+class OfflineAudioTest : public testing::Test
+{
+    public:
+        void SetUp() override { m_offline = ScratchConfiguration::offlineAudio(); }
+
+        // The audio engine is a singleton, so the mode mustn't leak into other tests
+        void TearDown() override { ScratchConfiguration::setOfflineAudio(m_offline); }
+
+    private:
+        bool m_offline = false;
+};
+
+TEST_F(OfflineAudioTest, Offline)
+{
+    IAudioEngine *engine = IAudioEngine::instance();
+    ASSERT_TRUE(engine);
+    ASSERT_FALSE(engine->isOffline());
+    ASSERT_FALSE(ScratchConfiguration::offlineAudio());
+
+    float buffer[200];
+    ASSERT_EQ(engine->render(buffer, 100), 0);
+
+    ScratchConfiguration::setOfflineAudio(true);
+    ASSERT_TRUE(engine->isOffline());
+    ASSERT_TRUE(ScratchConfiguration::offlineAudio());
+    ASSERT_EQ(engine->sampleRate(), 48000);
+    ASSERT_EQ(engine->channelCount(), 2);
+
+    // Nothing is playing, so the output is silent
+    std::fill(buffer, buffer + 200, 1.0f);
+    ASSERT_EQ(engine->render(buffer, 100), 100);
+    ASSERT_EQ(buffer[0], 0.0f);
+    ASSERT_EQ(buffer[199], 0.0f);
+
+    engine->setOffline(false);
+    ASSERT_FALSE(engine->isOffline());
+}
+
+#ifdef LIBSCRATCHCPP_AUDIO_SUPPORT
+TEST_F(OfflineAudioTest, ModeChangeWithLoadedSounds)
+{
+    IAudioEngine *engine = IAudioEngine::instance();
+    engine->setOffline(true);
+    const std::string data = readFileStr("Meow.wav");
+
+    {
+        AudioPlayer player;
+        ASSERT_TRUE(player.load(data.size(), data.data(), 44100));
+
+        // The engine can't be re-created while the sound uses it
+        engine->setOffline(false);
+        ASSERT_TRUE(engine->isOffline());
+    }
+
+    engine->setOffline(false);
+    ASSERT_FALSE(engine->isOffline());
+}
+#endif
@@ -1,10 +1,66 @@
 #include <audio/internal/audioplayer.h>
+#include <audio/internal/audioengine.h>
 
 #include "../common.h"
 
 using namespace libscratchcpp;
 
-TEST(AudioPlayerTest, Volume)
+class AudioPlayerTest : public testing::Test
+{
+    public:
+        void SetUp() override
+        {
+            // Mix without a device, so that the tests don't depend on the audio hardware
+            m_engine = IAudioEngine::instance();
+            m_offline = m_engine->isOffline();
+            m_budget = m_engine->decodedMemoryBudget();
+            m_engine->setOffline(true);
+        }
+
+        void TearDown() override
+        {
+            m_engine->setDecodedMemoryBudget(m_budget);
+            m_engine->setOffline(m_offline);
+        }
+
+        // Creates a silent mono 16-bit WAV file
+        static std::string createWav(double seconds)
+        {
+            const uint32_t dataSize = SAMPLE_RATE * seconds * sizeof(int16_t);
+            std::string wav;
+
+            auto write = [&wav](uint32_t value, int bytes) {
+                for (int i = 0; i < bytes; i++)
+                    wav.push_back(static_cast<char>((value >> (i * 8)) & 0xFF));
+            };
+
+            wav += "RIFF";
+            write(36 + dataSize, 4);
+            wav += "WAVEfmt ";
+            write(16, 4);
+            write(1, 2);
+            write(1, 2);
+            write(SAMPLE_RATE, 4);
+            write(SAMPLE_RATE * sizeof(int16_t), 4);
+            write(sizeof(int16_t), 2);
+            write(16, 2);
+            wav += "data";
+            write(dataSize, 4);
+            wav.append(dataSize, '\0');
+            return wav;
+        }
+
+        static constexpr unsigned int SAMPLE_RATE = 8000;
+        static constexpr size_t DECODED_SECOND = SAMPLE_RATE * 2 * sizeof(float); // decoded data is stereo
+
+        IAudioEngine *m_engine = nullptr;
+
+    private:
+        bool m_offline = false;
+        size_t m_budget = 0;
+};
+
+TEST_F(AudioPlayerTest, Volume)
 {
     AudioPlayer player;
     ASSERT_EQ(player.volume(), 1);
@@ -13,7 +69,7 @@ TEST(AudioPlayerTest, Volume)
     ASSERT_EQ(player.volume(), 0.86f);
 }
 
-TEST(AudioPlayerTest, Pitch)
+TEST_F(AudioPlayerTest, Pitch)
 {
     AudioPlayer player;
     ASSERT_EQ(player.pitch(), 1);
@@ -21,3 +77,109 @@ TEST(AudioPlayerTest, Pitch)
     player.setPitch(1.5f);
     ASSERT_EQ(player.pitch(), 1.5f);
 }
+
+TEST_F(AudioPlayerTest, DecodeShortSounds)
+{
+    const std::string shortSound = createWav(1);
+    const std::string longSound = createWav(AudioPlayer::MAX_DECODED_LENGTH + 1);
+
+    {
+        AudioPlayer player;
+        ASSERT_TRUE(player.load(shortSound.size(), shortSound.data(), SAMPLE_RATE));
+        ASSERT_FALSE(player.isStreamed());
+        ASSERT_TRUE(player.isDecoded());
+        ASSERT_EQ(m_engine->decodedMemoryUsage(), DECODED_SECOND);
+    }
+
+    ASSERT_EQ(m_engine->decodedMemoryUsage(), 0);
+
+    // Long sounds are decoded while playing
+    AudioPlayer player1;
+    ASSERT_TRUE(player1.load(longSound.size(), longSound.data(), SAMPLE_RATE));
+    ASSERT_TRUE(player1.isStreamed());
+    ASSERT_FALSE(player1.isDecoded());
+    ASSERT_EQ(m_engine->decodedMemoryUsage(), 0);
+
+    // ...as well as sounds which don't fit into the memory budget
+    m_engine->setDecodedMemoryBudget(DECODED_SECOND / 2);
+    AudioPlayer player2;
+    ASSERT_TRUE(player2.load(shortSound.size(), shortSound.data(), SAMPLE_RATE));
+    ASSERT_TRUE(player2.isStreamed());
+    ASSERT_FALSE(player2.isDecoded());
+}
+
+TEST_F(AudioPlayerTest, MemoryBudget)
+{
+    const std::string sound = createWav(1);
+    m_engine->setDecodedMemoryBudget(DECODED_SECOND * 2);
+
+    AudioPlayer player1, player2, player3;
+    ASSERT_TRUE(player1.load(sound.size(), sound.data(), SAMPLE_RATE));
+    ASSERT_TRUE(player2.load(sound.size(), sound.data(), SAMPLE_RATE));
+    ASSERT_EQ(m_engine->decodedMemoryUsage(), DECODED_SECOND * 2);
+
+    // The least recently used data is released when the budget is exceeded
+    ASSERT_TRUE(player3.load(sound.size(), sound.data(), SAMPLE_RATE));
+    ASSERT_FALSE(player1.isDecoded());
+    ASSERT_TRUE(player2.isDecoded());
+    ASSERT_TRUE(player3.isDecoded());
+    ASSERT_FALSE(player1.isStreamed());
+    ASSERT_EQ(m_engine->decodedMemoryUsage(), DECODED_SECOND * 2);
+
+    // Lowering the budget releases the data immediately
+    m_engine->setDecodedMemoryBudget(DECODED_SECOND);
+    ASSERT_FALSE(player2.isDecoded());
+    ASSERT_TRUE(player3.isDecoded());
+    ASSERT_EQ(m_engine->decodedMemoryUsage(), DECODED_SECOND);
+}
+
+TEST_F(AudioPlayerTest, DecodeAfterRelease)
+{
+    const std::string sound = createWav(1);
+    m_engine->setDecodedMemoryBudget(DECODED_SECOND);
+
+    AudioPlayer player1, player2;
+    ASSERT_TRUE(player1.load(sound.size(), sound.data(), SAMPLE_RATE));
+    ASSERT_TRUE(player2.load(sound.size(), sound.data(), SAMPLE_RATE));
+    ASSERT_FALSE(player1.isDecoded());
+
+    // The sound is decoded again when it starts
+    player1.start();
+    ASSERT_TRUE(player1.isDecoded());
+    ASSERT_TRUE(player1.isPlaying());
+    ASSERT_FALSE(player2.isDecoded());
+    ASSERT_EQ(m_engine->decodedMemoryUsage(), DECODED_SECOND);
+
+    // Playing sounds aren't released
+    player2.start();
+    ASSERT_TRUE(player1.isDecoded());
+    ASSERT_TRUE(player2.isDecoded());
+    ASSERT_EQ(m_engine->decodedMemoryUsage(), DECODED_SECOND * 2);
+
+    player1.stop();
+    player2.stop();
+}
+
+TEST_F(AudioPlayerTest, CopiesBlockRelease)
+{
+    const std::string sound = createWav(1);
+
+    AudioPlayer player;
+    ASSERT_TRUE(player.load(sound.size(), sound.data(), SAMPLE_RATE));
+
+    {
+        AudioPlayer copy;
+        ASSERT_TRUE(copy.loadCopy(&player));
+        ASSERT_TRUE(copy.isDecoded());
+
+        // The data can't be released while the copy reads it
+        m_engine->setDecodedMemoryBudget(1);
+        ASSERT_TRUE(player.isDecoded());
+        ASSERT_TRUE(copy.isDecoded());
+        ASSERT_EQ(m_engine->decodedMemoryUsage(), DECODED_SECOND);
+    }
+
+    m_engine->setDecodedMemoryBudget(2);
+    ASSERT_FALSE(player.isDecoded());
+    ASSERT_EQ(m_engine->decodedMemoryUsage(), 0);
+}
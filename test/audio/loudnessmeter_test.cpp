@@ -0,0 +1,97 @@
+#include <audio/internal/loudnessmeter.h>
+#include <cmath>
+
+#include "../common.h"
+
+using namespace libscratchcpp;
+
+TEST(LoudnessMeterTest, Configuration)
+{
+    LoudnessMeter meter;
+    ASSERT_EQ(meter.windowSize(), 1024);
+    ASSERT_EQ(meter.updateInterval(), 512);
+    ASSERT_EQ(meter.loudness(), -1);
+
+    meter.setWindowSize(256);
+    ASSERT_EQ(meter.windowSize(), 256);
+
+    meter.setUpdateInterval(64);
+    ASSERT_EQ(meter.updateInterval(), 64);
+
+    meter.setWindowSize(0);
+    ASSERT_EQ(meter.windowSize(), 1);
+}
+
+TEST(LoudnessMeterTest, SumOfSquares)
+{
+    std::vector<float> data;
+
+    for (int i = 0; i < 37; i++)
+        data.push_back(i * 0.1f - 1.5f);
+
+    float expected = 0;
+
+    for (float v : data)
+        expected += v * v;
+
+    ASSERT_NEAR(LoudnessMeter::sumOfSquares(data.data(), data.size()), expected, 1e-4);
+    ASSERT_EQ(LoudnessMeter::sumOfSquares(data.data(), 0), 0);
+    ASSERT_EQ(LoudnessMeter::sumOfSquares(data.data(), 3), data[0] * data[0] + data[1] * data[1] + data[2] * data[2]);
+}
+
+TEST(LoudnessMeterTest, Process)
+{
+    LoudnessMeter meter(8, 4);
+    std::vector<float> samples(3, 0.0f);
+
+    // Not updated before the update interval
+    meter.process(samples.data(), samples.size());
+    ASSERT_EQ(meter.loudness(), -1);
+
+    meter.process(samples.data(), 1);
+    ASSERT_EQ(meter.loudness(), 0);
+
+    // Constant signal: rms = sqrt(0.5^2 / 20)
+    samples.assign(8, 0.5f);
+    meter.process(samples.data(), samples.size());
+    int expected = std::round(std::sqrt(std::sqrt(0.25f / 20.0f) * 1.63f) * 100);
+    ASSERT_EQ(meter.loudness(), expected);
+
+    // Loud signal
+    samples.assign(8, 100.0f);
+    meter.process(samples.data(), samples.size());
+    ASSERT_EQ(meter.loudness(), 100);
+}
+
+TEST(LoudnessMeterTest, Smoothing)
+{
+    // Constant signal: rms = sqrt(0.5^2 / 20)
+    const float rms = std::sqrt(0.25f / 20.0f);
+    const int loud = std::round(std::sqrt(rms * 1.63f) * 100);
+    const int decayed = std::round(std::sqrt(rms * 0.6f * 1.63f) * 100);
+    const int decayedTwice = std::round(std::sqrt(rms * 0.36f * 1.63f) * 100);
+
+    std::vector<float> signal(LoudnessMeter::SMOOTHING_INTERVAL, 0.5f);
+    std::vector<float> silence(LoudnessMeter::SMOOTHING_INTERVAL, 0.0f);
+
+    // The loudness decays by 40 % per 2048 samples regardless of the update interval
+    for (unsigned int interval : { 64u, 512u, 2048u }) {
+        LoudnessMeter meter(1024, interval);
+        meter.process(signal.data(), signal.size());
+        ASSERT_EQ(meter.loudness(), loud);
+
+        meter.process(silence.data(), silence.size());
+        ASSERT_EQ(meter.loudness(), decayed);
+
+        meter.process(silence.data(), silence.size());
+        ASSERT_EQ(meter.loudness(), decayedTwice);
+    }
+
+    // A louder signal isn't smoothed
+    LoudnessMeter meter;
+    meter.process(silence.data(), silence.size());
+    ASSERT_EQ(meter.loudness(), 0);
+
+    meter.process(signal.data(), signal.size());
+    ASSERT_EQ(meter.loudness(), loud);
+}
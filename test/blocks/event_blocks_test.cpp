@@ -4,6 +4,7 @@
 #include <scratchcpp/sprite.h>
 #include <scratchcpp/broadcast.h>
 #include <scratchcpp/block.h>
+#include <scratchcpp/input.h>
 #include <scratchcpp/script.h>
 #include <scratchcpp/thread.h>
 #include <scratchcpp/executablecode.h>
@@ -15,12 +16,14 @@
 
 #include "../common.h"
 #include "blocks/eventblocks.h"
+#include "util.h"
 
 using namespace libscratchcpp;
 using namespace libscratchcpp::test;
 
 using ::testing::Return;
 using ::testing::ReturnRef;
+using ::testing::_;
 
 class EventBlocksTest : public testing::Test
 {
@@ -30,6 +33,7 @@ class EventBlocksTest : public testing::Test
             m_extension = std::make_unique<EventBlocks>();
             m_engine = m_project.engine().get();
             m_extension->registerBlocks(m_engine);
+            registerBlocks(m_engine, m_extension.get());
 
             EXPECT_CALL(m_engineMock, targets()).WillRepeatedly(ReturnRef(m_engine->targets()));
         }
@@ -325,17 +329,30 @@ TEST_F(EventBlocksTest, Broadcast)
     builder.addNullObscuredInput("BROADCAST_INPUT");
     auto block2 = builder.currentBlock();
 
+    builder.addBlock("event_broadcast");
+    auto valueBlock = std::make_shared<Block>("", "test_const_string");
+    auto input = std::make_shared<Input>("STRING", Input::Type::Shadow);
+    input->setPrimaryValue("test");
+    valueBlock->addInput(input);
+    builder.addObscuredInput("BROADCAST_INPUT", valueBlock);
+    auto block3 = builder.currentBlock();
+
     block1->setNext(nullptr);
     block2->setParent(nullptr);
+    block2->setNext(nullptr);
+    block3->setParent(nullptr);
 
     {
+        // The broadcasts are looked up at compile time
+        EXPECT_CALL(m_engineMock, findBroadcasts("test")).WillOnce(Return(std::vector<int>({ 1, 4 })));
         Compiler compiler(&m_engineMock, target.get());
         auto code = compiler.compile(block1);
         Script script(target.get(), block1, &m_engineMock);
         script.setCode(code);
         Thread thread(target.get(), &m_engineMock, &script);
 
-        EXPECT_CALL(m_engineMock, findBroadcasts("test")).WillOnce(Return(std::vector<int>({ 1, 4 })));
+        // The indices are baked into the code, so the broadcasts aren't looked up at runtime
+        EXPECT_CALL(m_engineMock, findBroadcasts(_)).Times(0);
         EXPECT_CALL(m_engineMock, broadcast(1, &thread, false));
         EXPECT_CALL(m_engineMock, broadcast(4, &thread, false));
         thread.run();
@@ -344,13 +361,15 @@ TEST_F(EventBlocksTest, Broadcast)
     }
 
     {
+        // The broadcasts are looked up at compile time
+        EXPECT_CALL(m_engineMock, findBroadcasts("0")).WillOnce(Return(std::vector<int>({ 5, 7, 8 })));
         Compiler compiler(&m_engineMock, target.get());
         auto code = compiler.compile(block2);
         Script script(target.get(), block2, &m_engineMock);
         script.setCode(code);
         Thread thread(target.get(), &m_engineMock, &script);
 
-        EXPECT_CALL(m_engineMock, findBroadcasts("0")).WillOnce(Return(std::vector<int>({ 5, 7, 8 })));
+        EXPECT_CALL(m_engineMock, findBroadcasts(_)).Times(0);
         EXPECT_CALL(m_engineMock, broadcast(5, &thread, false));
         EXPECT_CALL(m_engineMock, broadcast(7, &thread, false));
         EXPECT_CALL(m_engineMock, broadcast(8, &thread, false));
@@ -358,6 +377,21 @@ TEST_F(EventBlocksTest, Broadcast)
         ASSERT_TRUE(thread.isFinished());
         ASSERT_FALSE(thread.promise());
     }
+
+    {
+        Compiler compiler(&m_engineMock, target.get());
+        auto code = compiler.compile(block3);
+        Script script(target.get(), block3, &m_engineMock);
+        script.setCode(code);
+        Thread thread(target.get(), &m_engineMock, &script);
+
+        // Dynamic names are looked up when the block runs
+        EXPECT_CALL(m_engineMock, findBroadcasts("test")).WillOnce(Return(std::vector<int>({ 2 })));
+        EXPECT_CALL(m_engineMock, broadcast(2, &thread, false));
+        thread.run();
+        ASSERT_TRUE(thread.isFinished());
+        ASSERT_FALSE(thread.promise());
+    }
 }
 
 TEST_F(EventBlocksTest, BroadcastAndWait)
@@ -380,13 +414,15 @@ TEST_F(EventBlocksTest, BroadcastAndWait)
     block2->setParent(nullptr);
 
     {
+        // The broadcasts are looked up at compile time
+        EXPECT_CALL(m_engineMock, findBroadcasts("test")).WillOnce(Return(std::vector<int>({ 1, 4 })));
         Compiler compiler(&m_engineMock, target.get());
         auto code = compiler.compile(block1);
         Script script(target.get(), block1, &m_engineMock);
         script.setCode(code);
         Thread thread(target.get(), &m_engineMock, &script);
 
-        EXPECT_CALL(m_engineMock, findBroadcasts("test")).WillOnce(Return(std::vector<int>({ 1, 4 })));
+        EXPECT_CALL(m_engineMock, findBroadcasts(_)).Times(0);
         EXPECT_CALL(m_engineMock, broadcast(1, &thread, true));
         EXPECT_CALL(m_engineMock, broadcast(4, &thread, true));
         thread.run();
@@ -395,13 +431,15 @@ TEST_F(EventBlocksTest, BroadcastAndWait)
     }
 
     {
+        // The broadcasts are looked up at compile time
+        EXPECT_CALL(m_engineMock, findBroadcasts("0")).WillOnce(Return(std::vector<int>({ 5, 7, 8 })));
         Compiler compiler(&m_engineMock, target.get());
         auto code = compiler.compile(block2);
         Script script(target.get(), block2, &m_engineMock);
         script.setCode(code);
         Thread thread(target.get(), &m_engineMock, &script);
 
-        EXPECT_CALL(m_engineMock, findBroadcasts("0")).WillOnce(Return(std::vector<int>({ 5, 7, 8 })));
+        EXPECT_CALL(m_engineMock, findBroadcasts(_)).Times(0);
         EXPECT_CALL(m_engineMock, broadcast(5, &thread, true));
         EXPECT_CALL(m_engineMock, broadcast(7, &thread, true));
         EXPECT_CALL(m_engineMock, broadcast(8, &thread, true));
@@ -1253,6 +1253,33 @@ TEST_F(SensingBlocksTest, KeyPressed_M)
     value_free(&value);
 }
 
+TEST_F(SensingBlocksTest, KeyPressed_Any)
+{
+    auto targetMock = std::make_shared<TargetMock>();
+    targetMock->setEngine(&m_engineMock);
+
+    ScriptBuilder builder(m_extension.get(), m_engine, targetMock);
+    builder.addBlock("sensing_keypressed");
+    builder.addDropdownInput("KEY_OPTION", "any");
+    Block *block = builder.currentBlock();
+
+    Compiler compiler(&m_engineMock, targetMock.get());
+    auto code = compiler.compile(block, Compiler::CodeType::Reporter);
+    Script script(targetMock.get(), block, &m_engineMock);
+    script.setCode(code);
+    Thread thread(targetMock.get(), &m_engineMock, &script);
+
+    EXPECT_CALL(m_engineMock, keyPressed("any")).WillOnce(Return(true));
+    ValueData value = thread.runReporter();
+    ASSERT_TRUE(value_toBool(&value));
+    value_free(&value);
+
+    EXPECT_CALL(m_engineMock, keyPressed("any")).WillOnce(Return(false));
+    value = thread.runReporter();
+    ASSERT_FALSE(value_toBool(&value));
+    value_free(&value);
+}
+
 TEST_F(SensingBlocksTest, MouseDown)
 {
     auto targetMock = std::make_shared<TargetMock>();
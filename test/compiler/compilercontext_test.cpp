@@ -1,4 +1,5 @@
 #include <scratchcpp/compilercontext.h>
+#include <scratchcpp/valuedata.h>
 #include <enginemock.h>
 #include <targetmock.h>
 
@@ -11,4 +12,28 @@ TEST(CompilerContextTest, Constructors)
     CompilerContext ctx(&engine, &target);
     ASSERT_EQ(ctx.engine(), &engine);
     ASSERT_EQ(ctx.target(), &target);
+    ASSERT_FALSE(ctx.reporterBatchEnabled());
+}
+
+TEST(CompilerContextTest, ReporterBatchEnabled)
+{
+    EngineMock engine;
+    TargetMock target;
+    CompilerContext ctx(&engine, &target);
+
+    ctx.setReporterBatchEnabled(true);
+    ASSERT_TRUE(ctx.reporterBatchEnabled());
+
+    ctx.setReporterBatchEnabled(false);
+    ASSERT_FALSE(ctx.reporterBatchEnabled());
+}
+
+TEST(CompilerContextTest, RunReporters)
+{
+    EngineMock engine;
+    TargetMock target;
+    CompilerContext ctx(&engine, &target);
+    bool mask = true;
+    ValueData result;
+    ASSERT_FALSE(ctx.runReporters(nullptr, &mask, &result));
 }
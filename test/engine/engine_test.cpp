@@ -25,6 +25,7 @@
 #include <monitorhandlermock.h>
 #include <extensionmock.h>
 #include <thread>
+#include <fstream>
 
 #include "../common.h"
 #include "engine/internal/engine.h"
@@ -273,6 +274,159 @@ TEST(EngineTest, CompileAndExecuteMonitors)
     ScratchConfiguration::removeExtension(extension);
 }
 
+TEST(EngineTest, UpdateVariableAndListMonitorsOnlyOnChange)
+{
+    Engine engine;
+    auto stage = std::make_shared<Stage>();
+    auto var = std::make_shared<Variable>("a", "var", 5);
+    auto list = std::make_shared<List>("b", "list");
+    stage->addVariable(var);
+    stage->addList(list);
+    engine.setTargets({ stage });
+
+    auto extension = std::make_shared<ExtensionMock>();
+    EXPECT_CALL(*extension, name()).WillRepeatedly(Return("MonitorTest"));
+    EXPECT_CALL(*extension, registerBlocks);
+    EXPECT_CALL(*extension, onInit);
+    ScratchConfiguration::registerExtension(extension);
+    engine.setExtensions({ "MonitorTest" });
+    engine.addCompileFunction(extension.get(), "data_variable", [](Compiler *compiler) -> CompilerValue * {
+        return compiler->addVariableValue(static_cast<Variable *>(compiler->field("VARIABLE")->valuePtr().get()));
+    });
+    engine.addCompileFunction(extension.get(), "data_listcontents", [](Compiler *compiler) -> CompilerValue * {
+        return compiler->addListContents(static_cast<List *>(compiler->field("LIST")->valuePtr().get()));
+    });
+
+    engine.createVariableMonitor(var, "data_variable", "VARIABLE");
+    engine.createListMonitor(list, "data_listcontents", "LIST");
+    Monitor *m1 = var->monitor();
+    Monitor *m2 = list->monitor();
+    ASSERT_TRUE(m1 && m2);
+    m1->setVisible(true);
+    m2->setVisible(true);
+
+    MonitorHandlerMock iface1, iface2;
+    EXPECT_CALL(iface1, init);
+    EXPECT_CALL(iface2, init);
+    m1->setInterface(&iface1);
+    m2->setInterface(&iface2);
+
+    // First update
+    EXPECT_CALL(iface1, onValueChanged(_)).WillOnce(WithArgs<0>(Invoke([](const Value &value) { ASSERT_EQ(value.toDouble(), 5); })));
+    EXPECT_CALL(iface2, onValueChanged);
+    engine.updateMonitors();
+
+    // Nothing has changed
+    EXPECT_CALL(iface1, onValueChanged).Times(0);
+    EXPECT_CALL(iface2, onValueChanged).Times(0);
+    engine.updateMonitors();
+
+    // Change the variable
+    var->setValue(-2.5);
+    EXPECT_CALL(iface1, onValueChanged(_)).WillOnce(WithArgs<0>(Invoke([](const Value &value) { ASSERT_EQ(value.toDouble(), -2.5); })));
+    EXPECT_CALL(iface2, onValueChanged).Times(0);
+    engine.updateMonitors();
+
+    // Change the list
+    list->append("test");
+    EXPECT_CALL(iface1, onValueChanged).Times(0);
+    EXPECT_CALL(iface2, onValueChanged);
+    engine.updateMonitors();
+
+    EXPECT_CALL(iface1, onValueChanged).Times(0);
+    EXPECT_CALL(iface2, onValueChanged).Times(0);
+    engine.updateMonitors();
+
+    // Replacing the interface forces an update
+    MonitorHandlerMock iface3;
+    EXPECT_CALL(iface3, init);
+    m1->setInterface(&iface3);
+    EXPECT_CALL(iface3, onValueChanged);
+    EXPECT_CALL(iface2, onValueChanged).Times(0);
+    engine.updateMonitors();
+
+    ScratchConfiguration::removeExtension(extension);
+}
+
+TEST(EngineTest, OpcodeTable)
+{
+    Engine engine;
+    auto stage = std::make_shared<Stage>();
+    auto var1 = std::make_shared<Variable>("a", "var1");
+    auto var2 = std::make_shared<Variable>("b", "var2");
+    stage->addVariable(var1);
+    stage->addVariable(var2);
+
+    // Blocks which aren't top level aren't compiled, but they get the registered functions
+    auto block1 = std::make_shared<Block>("c", "opcode_table_block");
+    auto block2 = std::make_shared<Block>("d", "opcode_table_hat");
+    auto block3 = std::make_shared<Block>("e", "opcode_table_predicate_only");
+    auto block4 = std::make_shared<Block>("f", "opcode_table_unknown");
+
+    for (auto block : { block1, block2, block3, block4 }) {
+        block->setParentId("parent");
+        stage->addBlock(block);
+    }
+
+    engine.setTargets({ stage });
+
+    ExtensionMock extension1, extension2;
+    BlockComp compileBlock = [](Compiler *compiler) -> CompilerValue * { return compiler->addConstValue(1); };
+    BlockComp compileHat = [](Compiler *compiler) -> CompilerValue * { return nullptr; };
+    HatPredicateCompileFunc compilePredicate = [](Compiler *compiler) -> CompilerValue * { return compiler->addConstValue(true); };
+
+    MonitorNameFunc monitorName = [](Block *block) -> const std::string & {
+        static const std::string name = "test";
+        return name;
+    };
+
+    MonitorChangeFunc monitorChange = [](Block *block, const Value &newValue) { std::cout << "change!" << std::endl; };
+
+    engine.addCompileFunction(&extension1, block1->opcode(), compileBlock);
+
+    // Hat predicates and monitor functions are keyed by opcode alone (the order and the extension don't matter)
+    engine.addHatPredicateCompileFunction(&extension2, block2->opcode(), compilePredicate);
+    engine.addCompileFunction(&extension1, block2->opcode(), compileHat);
+    engine.addHatPredicateCompileFunction(&extension1, block3->opcode(), compilePredicate);
+
+    engine.addMonitorNameFunction(&extension2, "opcode_table_reporter", monitorName);
+    engine.addMonitorChangeFunction(&extension2, "opcode_table_reporter", monitorChange);
+    engine.addCompileFunction(&extension1, "opcode_table_reporter", compileBlock);
+    engine.addMonitorNameFunction(&extension1, "opcode_table_monitor_only", monitorName);
+    engine.addMonitorChangeFunction(&extension1, "opcode_table_monitor_only", monitorChange);
+
+    engine.compile();
+    ASSERT_EQ(block1->compileFunction(), compileBlock);
+    ASSERT_EQ(block1->hatPredicateCompileFunction(), nullptr);
+    ASSERT_EQ(block2->compileFunction(), compileHat);
+    ASSERT_EQ(block2->hatPredicateCompileFunction(), compilePredicate);
+
+    // Opcodes without a compile function aren't resolved
+    ASSERT_EQ(block3->compileFunction(), nullptr);
+    ASSERT_EQ(block3->hatPredicateCompileFunction(), nullptr);
+    ASSERT_EQ(block4->compileFunction(), nullptr);
+    ASSERT_EQ(block4->hatPredicateCompileFunction(), nullptr);
+
+    // Monitors get the extension which registered the compile function
+    Monitor *monitor1 = engine.createVariableMonitor(var1, "opcode_table_reporter", "VARIABLE");
+    ASSERT_EQ(monitor1->block()->compileFunction(), compileBlock);
+    ASSERT_EQ(monitor1->extension(), &extension1);
+    ASSERT_EQ(monitor1->name(), "test");
+
+    testing::internal::CaptureStdout();
+    monitor1->changeValue(0);
+    ASSERT_EQ(testing::internal::GetCapturedStdout(), "change!\n");
+
+    Monitor *monitor2 = engine.createVariableMonitor(var2, "opcode_table_monitor_only", "VARIABLE");
+    ASSERT_EQ(monitor2->block()->compileFunction(), nullptr);
+    ASSERT_EQ(monitor2->extension(), nullptr);
+    ASSERT_TRUE(monitor2->name().empty());
+
+    testing::internal::CaptureStdout();
+    monitor2->changeValue(0);
+    ASSERT_TRUE(testing::internal::GetCapturedStdout().empty());
+}
+
 TEST(EngineTest, IsRunning)
 {
     Engine engine;
@@ -337,6 +491,61 @@ TEST(EngineTest, GlobalVolume)
     engine.setGlobalVolume(92.36);
 }
 
+TEST(EngineTest, OfflineAudio)
+{
+    Engine engine;
+    AudioEngineMock audioEngine;
+    engine.m_audioEngine = &audioEngine;
+    engine.setFps(30);
+    ASSERT_TRUE(engine.renderedAudio().empty());
+
+    EXPECT_CALL(audioEngine, isOffline()).WillOnce(Return(false));
+    engine.step();
+    ASSERT_TRUE(engine.renderedAudio().empty());
+
+    // 44100 / 30 = 1470 frames per step
+    EXPECT_CALL(audioEngine, isOffline()).WillRepeatedly(Return(true));
+    EXPECT_CALL(audioEngine, sampleRate()).WillRepeatedly(Return(44100));
+    EXPECT_CALL(audioEngine, channelCount()).WillRepeatedly(Return(2));
+
+    EXPECT_CALL(audioEngine, render(_, 1470)).Times(2).WillRepeatedly([](float *buffer, size_t frameCount) {
+        std::fill(buffer, buffer + frameCount * 2, 0.5f);
+        return frameCount;
+    });
+
+    engine.step();
+    engine.step();
+    ASSERT_EQ(engine.renderedAudio().size(), 1470 * 2 * 2);
+    ASSERT_EQ(engine.renderedAudio().back(), 0.5f);
+    ASSERT_EQ(engine.renderedAudioSampleRate(), 44100);
+    ASSERT_EQ(engine.renderedAudioChannels(), 2);
+
+    std::string fileName = "offline_audio_test.wav";
+    ASSERT_TRUE(engine.saveRenderedAudio(fileName));
+
+    std::ifstream file(fileName, std::ios::binary);
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    file.close();
+    std::remove(fileName.c_str());
+    ASSERT_EQ(data.size(), 44 + 1470 * 2 * 2 * sizeof(float));
+    ASSERT_EQ(data.substr(0, 4), "RIFF");
+    ASSERT_EQ(data.substr(8, 4), "WAVE");
+    ASSERT_EQ(data.substr(36, 4), "data");
+
+    // The remaining fraction of a frame is added to the next step
+    engine.clearRenderedAudio();
+    ASSERT_TRUE(engine.renderedAudio().empty());
+    engine.setFps(60);
+    EXPECT_CALL(audioEngine, sampleRate()).WillRepeatedly(Return(44130)); // 735.5 frames per step
+    EXPECT_CALL(audioEngine, render(_, 735)).WillOnce(Return(735));
+    engine.step();
+    EXPECT_CALL(audioEngine, render(_, 736)).WillOnce(Return(736));
+    engine.step();
+    ASSERT_EQ(engine.renderedAudio().size(), (735 + 736) * 2);
+
+    engine.m_audioEngine = IAudioEngine::instance();
+}
+
 TEST(EngineTest, Step)
 {
     Project p("step.sb3");
@@ -605,6 +814,16 @@ TEST(EngineTest, KeyState)
     ASSERT_TRUE(engine.keyPressed("up arrow"));
     ASSERT_FALSE(engine.keyPressed("U"));
     ASSERT_TRUE(engine.keyPressed("any"));
+
+    // Key code
+    ASSERT_TRUE(engine.keyPressed(KeyEvent("a").code()));
+    ASSERT_FALSE(engine.keyPressed(KeyEvent("b").code()));
+    ASSERT_TRUE(engine.keyPressed(KeyEvent(KeyEvent::Type::Up).code()));
+    ASSERT_FALSE(engine.keyPressed(KeyEvent("u").code()));
+    ASSERT_FALSE(engine.keyPressed(KeyEvent::CODE_COUNT));
+
+    engine.setKeyState(KeyEvent("up arrow"), false);
+    ASSERT_FALSE(engine.keyPressed(KeyEvent(KeyEvent::Type::Up).code()));
 }
 
 TEST(EngineTest, WhenKeyPressed)
@@ -939,6 +1158,30 @@ TEST(EngineTest, SpriteFencingEnabled)
     ASSERT_TRUE(engine.spriteFencingEnabled());
 }
 
+TEST(EngineTest, CollisionCacheEnabled)
+{
+    Engine engine;
+    ASSERT_FALSE(engine.collisionCacheEnabled());
+
+    engine.setCollisionCacheEnabled(true);
+    ASSERT_TRUE(engine.collisionCacheEnabled());
+
+    engine.setCollisionCacheEnabled(false);
+    ASSERT_FALSE(engine.collisionCacheEnabled());
+}
+
+TEST(EngineTest, FrameCount)
+{
+    Engine engine;
+    ASSERT_EQ(engine.frameCount(), 0);
+
+    engine.step();
+    ASSERT_EQ(engine.frameCount(), 1);
+
+    engine.step();
+    ASSERT_EQ(engine.frameCount(), 2);
+}
+
 TEST(EngineTest, Timer)
 {
     Engine engine;
@@ -1008,6 +1251,11 @@ TEST(EngineTest, Broadcasts)
     ASSERT_EQ(engine.findBroadcasts("MessAge2"), std::vector<int>({ 1 }));
     ASSERT_EQ(engine.findBroadcasts("tEst"), std::vector<int>({ 2, 3 }));
 
+    StringPtr invalidName("invalid");
+    StringPtr testName("tEST");
+    ASSERT_TRUE(engine.findBroadcasts(&invalidName).empty());
+    ASSERT_EQ(engine.findBroadcasts(&testName), std::vector<int>({ 2, 3 }));
+
     ASSERT_EQ(engine.findBroadcastById("e"), -1);
     ASSERT_EQ(engine.findBroadcastById("a"), 0);
     ASSERT_EQ(engine.findBroadcastById("b"), 1);
@@ -1171,6 +1419,28 @@ TEST(EngineTest, Targets)
     ASSERT_EQ(engine.findTarget("Stage"), 3);
     ASSERT_EQ(engine.findTarget("_stage_"), 2);
 
+    StringPtr invalidName("invalid");
+    StringPtr sprite1Name("Sprite1");
+    StringPtr stageName("Stage");
+    StringPtr reservedStageName("_stage_");
+    ASSERT_EQ(engine.findTarget(&invalidName), -1);
+    ASSERT_EQ(engine.findTarget(&sprite1Name), 0);
+    ASSERT_EQ(engine.findTarget(&stageName), 3);
+    ASSERT_EQ(engine.findTarget(&reservedStageName), 2);
+
+    // Renamed targets are found by their new name
+    StringPtr renamedName("Renamed");
+    t1->setName("Renamed");
+    ASSERT_EQ(engine.findTarget(&sprite1Name), -1);
+    ASSERT_EQ(engine.findTarget(&renamedName), 0);
+    t4->setName("Sprite1");
+    ASSERT_EQ(engine.findTarget(&sprite1Name), 3);
+    ASSERT_EQ(engine.findTarget(&stageName), -1);
+    t1->setName("Sprite1");
+    ASSERT_EQ(engine.findTarget(&sprite1Name), 0);
+    ASSERT_EQ(engine.findTarget(&renamedName), -1);
+    t4->setName("Stage");
+
     engine.getVisibleTargets(visibleTargets);
     ASSERT_EQ(visibleTargets, std::vector<Target *>({ t1.get(), t4.get(), t3.get() }));
 
@@ -1515,6 +1785,38 @@ TEST(EngineTest, MoveDrawableBehindOther)
     ASSERT_EQ(sprites[4]->layerOrder(), 1);
 }
 
+TEST(EngineTest, MoveDrawableUpdatesAffectedLayersOnly)
+{
+    Engine engine;
+    std::vector<Sprite *> sprites;
+    createTargets(&engine, sprites);
+
+    // All layers are renumbered after setting the targets
+    engine.moveDrawableToFront(sprites[2]);
+    ASSERT_EQ(sprites[0]->layerOrder(), 1);
+    ASSERT_EQ(sprites[4]->layerOrder(), 2);
+    ASSERT_EQ(sprites[3]->layerOrder(), 3);
+
+    int changes[5] = { 0, 0, 0, 0, 0 };
+    int bubbleChanges = 0;
+
+    for (int i = 0; i < sprites.size(); i++) {
+        sprites[i]->layerOrderChanged().connect([&changes, i](int) { changes[i]++; });
+        sprites[i]->bubble()->layerOrderChanged().connect([&bubbleChanges](int) { bubbleChanges++; });
+    }
+
+    engine.moveDrawableToBack(sprites[4]);
+    ASSERT_EQ(sprites[4]->layerOrder(), 1);
+    ASSERT_EQ(sprites[0]->layerOrder(), 2);
+    ASSERT_EQ(sprites[3]->layerOrder(), 3);
+    ASSERT_EQ(changes[0], 1);
+    ASSERT_EQ(changes[1], 0);
+    ASSERT_EQ(changes[2], 0);
+    ASSERT_EQ(changes[3], 0);
+    ASSERT_EQ(changes[4], 1);
+    ASSERT_EQ(bubbleChanges, 0);
+}
+
 TEST(EngineTest, Stage)
 {
     Engine engine;
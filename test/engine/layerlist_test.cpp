@@ -0,0 +1,149 @@
+#include <scratchcpp/drawable.h>
+#include <algorithm>
+#include <random>
+
+#include "../common.h"
+#include "engine/internal/layerlist.h"
+
+using namespace libscratchcpp;
+
+TEST(LayerListTest, AppendAndRemove)
+{
+    Drawable d1, d2, d3;
+    LayerList list;
+    ASSERT_TRUE(list.empty());
+    ASSERT_EQ(list.size(), 0);
+    ASSERT_FALSE(list.contains(&d1));
+
+    list.append(&d1);
+    list.append(&d2);
+    list.append(&d3);
+    list.append(&d2);
+    ASSERT_FALSE(list.empty());
+    ASSERT_EQ(list.size(), 3);
+    ASSERT_TRUE(list.contains(&d2));
+    ASSERT_EQ(list.items(), std::vector<Drawable *>({ &d1, &d2, &d3 }));
+    ASSERT_EQ(list.indexOf(&d1), 0);
+    ASSERT_EQ(list.indexOf(&d2), 1);
+    ASSERT_EQ(list.indexOf(&d3), 2);
+    ASSERT_EQ(list.at(0), &d1);
+    ASSERT_EQ(list.at(2), &d3);
+    ASSERT_EQ(list.at(3), nullptr);
+
+    list.remove(&d2);
+    ASSERT_EQ(list.size(), 2);
+    ASSERT_FALSE(list.contains(&d2));
+    ASSERT_EQ(list.items(), std::vector<Drawable *>({ &d1, &d3 }));
+    ASSERT_EQ(list.indexOf(&d3), 1);
+
+    list.removeIf([&d1](Drawable *drawable) { return drawable == &d1; });
+    ASSERT_EQ(list.items(), std::vector<Drawable *>({ &d3 }));
+
+    list.clear();
+    ASSERT_TRUE(list.empty());
+    ASSERT_FALSE(list.contains(&d3));
+}
+
+TEST(LayerListTest, Move)
+{
+    Drawable d1, d2, d3, d4;
+    LayerList list;
+    list.assign({ &d1, &d2, &d3, &d4 });
+
+    list.move(&d2, 3);
+    ASSERT_EQ(list.items(), std::vector<Drawable *>({ &d1, &d3, &d4, &d2 }));
+
+    list.move(&d4, 0);
+    ASSERT_EQ(list.items(), std::vector<Drawable *>({ &d4, &d1, &d3, &d2 }));
+
+    list.move(&d3, 1);
+    ASSERT_EQ(list.items(), std::vector<Drawable *>({ &d4, &d3, &d1, &d2 }));
+    ASSERT_EQ(list.indexOf(&d1), 2);
+}
+
+TEST(LayerListTest, LayerOrders)
+{
+    Drawable stage, d1, d2, d3;
+    stage.setLayerOrder(0);
+    d1.setLayerOrder(1);
+    d2.setLayerOrder(2);
+    d3.setLayerOrder(3);
+
+    LayerList list;
+    list.assign({ &stage, &d1, &d2, &d3 });
+
+    int changes[3] = { 0, 0, 0 };
+    d1.layerOrderChanged().connect([&changes](int) { changes[0]++; });
+    d2.layerOrderChanged().connect([&changes](int) { changes[1]++; });
+    d3.layerOrderChanged().connect([&changes](int) { changes[2]++; });
+
+    // Layer orders are updated when they're read
+    list.move(&d1, 3);
+    list.move(&d2, 3);
+    ASSERT_EQ(changes[0], 0);
+    ASSERT_EQ(d3.layerOrder(), 1);
+    ASSERT_EQ(d1.layerOrder(), 2);
+    ASSERT_EQ(d2.layerOrder(), 3);
+    ASSERT_EQ(stage.layerOrder(), 0);
+    ASSERT_EQ(changes[0], 1);
+    ASSERT_EQ(changes[1], 1);
+    ASSERT_EQ(changes[2], 1);
+
+    // ...or explicitly
+    list.move(&d2, 1);
+    list.updateLayerOrders();
+    ASSERT_EQ(changes[0], 2);
+    ASSERT_EQ(changes[1], 2);
+    ASSERT_EQ(changes[2], 2);
+    ASSERT_EQ(d2.layerOrder(), 1);
+    ASSERT_EQ(d3.layerOrder(), 2);
+    ASSERT_EQ(d1.layerOrder(), 3);
+}
+
+TEST(LayerListTest, DestroyedDrawable)
+{
+    Drawable d1;
+    LayerList list;
+    list.append(&d1);
+
+    {
+        Drawable d2;
+        list.append(&d2);
+        ASSERT_EQ(list.size(), 2);
+    }
+
+    ASSERT_EQ(list.size(), 1);
+    ASSERT_EQ(list.items(), std::vector<Drawable *>({ &d1 }));
+}
+
+TEST(LayerListTest, RandomMoves)
+{
+    std::vector<std::unique_ptr<Drawable>> drawables;
+    std::vector<Drawable *> expected;
+    LayerList list;
+
+    for (int i = 0; i < 200; i++) {
+        drawables.push_back(std::make_unique<Drawable>());
+        expected.push_back(drawables.back().get());
+        list.append(expected.back());
+    }
+
+    std::mt19937 generator(1);
+
+    for (int i = 0; i < 2000; i++) {
+        Drawable *drawable = expected[generator() % expected.size()];
+        size_t index = generator() % expected.size();
+        list.move(drawable, index);
+
+        expected.erase(std::find(expected.begin(), expected.end(), drawable));
+        expected.insert(expected.begin() + index, drawable);
+
+        ASSERT_EQ(list.indexOf(drawable), index);
+        ASSERT_EQ(list.at(index), drawable);
+    }
+
+    ASSERT_EQ(list.items(), expected);
+
+    for (size_t i = 1; i < expected.size(); i++)
+        ASSERT_EQ(expected[i]->layerOrder(), i);
+}
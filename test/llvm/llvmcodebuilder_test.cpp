@@ -730,6 +730,69 @@ TEST_F(LLVMCodeBuilderTest, WriteVariable)
     ASSERT_EQ(localVar4->value(), 45.23);
 }
 
+TEST_F(LLVMCodeBuilderTest, VersionUpdates)
+{
+    Stage stage;
+    Sprite sprite;
+    sprite.setEngine(&m_utils.engine());
+    EXPECT_CALL(m_utils.engine(), stage()).WillRepeatedly(Return(&stage));
+
+    auto globalVar = std::make_shared<Variable>("", "");
+    auto localVar = std::make_shared<Variable>("", "");
+    auto globalList = std::make_shared<List>("", "");
+    auto localList = std::make_shared<List>("", "");
+    stage.addVariable(globalVar);
+    sprite.addVariable(localVar);
+    stage.addList(globalList);
+    sprite.addList(localList);
+
+    auto versions = [&]() { return std::vector<unsigned int>({ globalVar->version(), localVar->version(), globalList->version(), localList->version() }); };
+
+    // Monitors rely on compiled code bumping the version of the variable or list it modifies (see versions())
+    using BuildFunction = std::function<void(LLVMCodeBuilder *)>;
+
+    const std::vector<std::pair<BuildFunction, size_t>> cases = {
+        { [&](LLVMCodeBuilder *builder) { builder->createVariableWrite(globalVar.get(), builder->addConstValue(5)); }, 0 },
+        { [&](LLVMCodeBuilder *builder) { builder->createVariableWrite(localVar.get(), builder->addConstValue("test")); }, 1 },
+        { [&](LLVMCodeBuilder *builder) { builder->createListAppend(globalList.get(), builder->addConstValue(3)); }, 2 },
+        { [&](LLVMCodeBuilder *builder) { builder->createListAppend(localList.get(), builder->addConstValue("test")); }, 3 },
+        { [&](LLVMCodeBuilder *builder) { builder->createListInsert(globalList.get(), builder->addConstValue(0), builder->addConstValue(true)); }, 2 },
+        { [&](LLVMCodeBuilder *builder) { builder->createListReplace(localList.get(), builder->addConstValue(1), builder->addConstValue(-4.5)); }, 3 },
+        { [&](LLVMCodeBuilder *builder) { builder->createListRemove(globalList.get(), builder->addConstValue(0)); }, 2 },
+        { [&](LLVMCodeBuilder *builder) { builder->createListClear(localList.get()); }, 3 }
+    };
+
+    for (bool warp : { false, true }) {
+        for (const auto &[build, changed] : cases) {
+            for (auto list : { globalList, localList }) {
+                list->clear();
+                list->append(1);
+                list->append(2);
+            }
+
+            LLVMCodeBuilder *builder = m_utils.createBuilder(&sprite, warp);
+            build(builder);
+
+            auto code = builder->build();
+            Script script(&sprite, nullptr, nullptr);
+            script.setCode(code);
+            Thread thread(&sprite, nullptr, &script);
+            auto ctx = code->createExecutionContext(&thread);
+
+            const std::vector<unsigned int> before = versions();
+            code->run(ctx.get());
+            const std::vector<unsigned int> after = versions();
+
+            for (size_t i = 0; i < before.size(); i++) {
+                if (i == changed)
+                    ASSERT_GT(after[i], before[i]);
+                else
+                    ASSERT_EQ(after[i], before[i]);
+            }
+        }
+    }
+}
+
 TEST_F(LLVMCodeBuilderTest, Select)
 {
     Stage stage;
@@ -882,6 +945,80 @@ TEST_F(LLVMCodeBuilderTest, ReadVariable)
     ASSERT_EQ(testing::internal::GetCapturedStdout(), expected);
 }
 
+TEST_F(LLVMCodeBuilderTest, SelfAppendVariable)
+{
+    Stage stage;
+    Sprite sprite;
+    sprite.setEngine(&m_utils.engine());
+    EXPECT_CALL(m_utils.engine(), stage()).WillRepeatedly(Return(&stage));
+
+    auto var1 = std::make_shared<Variable>("", "", "ab");
+    auto var2 = std::make_shared<Variable>("", "", 5);
+    auto var3 = std::make_shared<Variable>("", "", "x");
+    sprite.addVariable(var1);
+    sprite.addVariable(var2);
+    sprite.addVariable(var3);
+
+    LLVMCodeBuilder *builder = m_utils.createBuilder(&sprite, true);
+
+    // set var1 to (join var1 "c")
+    CompilerValue *v = builder->addConstValue(3);
+    builder->beginRepeatLoop(v);
+    {
+        CompilerValue *v1 = builder->addVariableValue(var1.get());
+        CompilerValue *v2 = builder->addConstValue("c");
+        v = builder->createStringConcat(v1, v2);
+        builder->createVariableWrite(var1.get(), v);
+    }
+    builder->endLoop();
+
+    v = builder->addVariableValue(var1.get());
+    builder->addFunctionCall("test_print_string", Compiler::StaticType::Void, { Compiler::StaticType::String }, { v });
+
+    // Non-string variable: set var2 to (join var2 var2)
+    CompilerValue *v1 = builder->addVariableValue(var2.get());
+    CompilerValue *v2 = builder->addVariableValue(var2.get());
+    v = builder->createStringConcat(v1, v2);
+    builder->createVariableWrite(var2.get(), v);
+
+    // Now a string: set var2 to (join var2 var2)
+    v1 = builder->addVariableValue(var2.get());
+    v2 = builder->addVariableValue(var2.get());
+    v = builder->createStringConcat(v1, v2);
+    builder->createVariableWrite(var2.get(), v);
+
+    v = builder->addVariableValue(var2.get());
+    builder->addFunctionCall("test_print_string", Compiler::StaticType::Void, { Compiler::StaticType::String }, { v });
+
+    // The result of the join is used after the write
+    v1 = builder->addVariableValue(var3.get());
+    v2 = builder->addConstValue("y");
+    v = builder->createStringConcat(v1, v2);
+    builder->createVariableWrite(var3.get(), v);
+    builder->addFunctionCall("test_print_string", Compiler::StaticType::Void, { Compiler::StaticType::String }, { v });
+
+    v = builder->addVariableValue(var3.get());
+    builder->addFunctionCall("test_print_string", Compiler::StaticType::Void, { Compiler::StaticType::String }, { v });
+
+    static const std::string expected =
+        "abccc\n"
+        "55555555\n"
+        "xy\n"
+        "xy\n";
+
+    auto code = builder->build();
+    Script script(&sprite, nullptr, nullptr);
+    script.setCode(code);
+    Thread thread(&sprite, nullptr, &script);
+    auto ctx = code->createExecutionContext(&thread);
+    testing::internal::CaptureStdout();
+    code->run(ctx.get());
+    ASSERT_EQ(testing::internal::GetCapturedStdout(), expected);
+    ASSERT_EQ(var1->value().toString(), "abccc");
+    ASSERT_EQ(var2->value().toString(), "55555555");
+    ASSERT_EQ(var3->value().toString(), "xy");
+}
+
 TEST_F(LLVMCodeBuilderTest, SyncVariablesBeforeCallingFunction)
 {
     Sprite sprite;
@@ -3893,6 +4030,69 @@ TEST_F(LLVMCodeBuilderTest, Reporters)
     value_free(&ret);
 }
 
+TEST_F(LLVMCodeBuilderTest, ReporterBatch)
+{
+    Sprite sprite;
+    auto var = std::make_shared<Variable>("", "");
+    var->setValue("Hello world!");
+    sprite.addVariable(var);
+
+    LLVMCompilerContext ctx(&m_utils.engine(), &sprite);
+    ctx.setReporterBatchEnabled(true);
+
+    // Reporter 1
+    LLVMCodeBuilder builder1(&ctx, nullptr, Compiler::CodeType::Reporter);
+    builder1.addConstValue(-45.23);
+    auto code1 = builder1.build();
+
+    // Reporter 2
+    LLVMCodeBuilder builder2(&ctx, nullptr, Compiler::CodeType::Reporter);
+    builder2.addVariableValue(var.get());
+    auto code2 = builder2.build();
+
+    // Reporter 3
+    LLVMCodeBuilder builder3(&ctx, nullptr, Compiler::CodeType::Reporter);
+    CompilerValue *v = builder3.addConstValue("test");
+    builder3.addFunctionCall("test_const_string", Compiler::StaticType::String, { Compiler::StaticType::String }, { v });
+    auto code3 = builder3.build();
+
+    Thread thread(&sprite, nullptr, nullptr);
+    bool mask[] = { true, false, true };
+    ValueData results[3];
+
+    for (ValueData &value : results)
+        value_init(&value);
+
+    ASSERT_TRUE(ctx.runReporters(&thread, mask, results));
+    ASSERT_TRUE(value_isNumber(&results[0]));
+    ASSERT_EQ(value_toDouble(&results[0]), -45.23);
+    ASSERT_TRUE(value_isNumber(&results[1]));
+    ASSERT_EQ(value_toDouble(&results[1]), 0);
+    ASSERT_EQ(Value(results[2]).toString(), "test");
+    value_free(&results[0]);
+    value_free(&results[2]);
+
+    mask[0] = false;
+    mask[1] = true;
+    mask[2] = false;
+    ASSERT_TRUE(ctx.runReporters(&thread, mask, results));
+    var->setValue("abc"); // the string should be copied
+    ASSERT_EQ(Value(results[1]).toString(), "Hello world!");
+    value_free(&results[1]);
+
+    // Contexts without reporters don't support batches
+    LLVMCompilerContext emptyCtx(&m_utils.engine(), &sprite);
+    emptyCtx.setReporterBatchEnabled(true);
+    ASSERT_FALSE(emptyCtx.runReporters(&thread, mask, results));
+
+    // Reporters are only batched in contexts with batches enabled
+    LLVMCompilerContext scriptCtx(&m_utils.engine(), &sprite);
+    LLVMCodeBuilder builder4(&scriptCtx, nullptr, Compiler::CodeType::Reporter);
+    builder4.addConstValue(5);
+    auto code4 = builder4.build();
+    ASSERT_FALSE(scriptCtx.runReporters(&thread, mask, results));
+}
+
 TEST_F(LLVMCodeBuilderTest, UnknownTypeReporter)
 {
     Sprite sprite;
@@ -647,6 +647,88 @@ TEST(LoadProjectTest, LoadTestProject)
     }
 }
 
+TEST(LoadProjectTest, AssetLoadProgress)
+{
+    Project p("default_project.sb3");
+    std::mutex mutex;
+    std::vector<std::pair<unsigned int, unsigned int>> progress;
+
+    p.assetLoadProgressChanged().connect([&mutex, &progress](unsigned int loaded, unsigned int total) {
+        std::lock_guard<std::mutex> lock(mutex);
+        progress.push_back({ loaded, total });
+    });
+
+    ASSERT_TRUE(p.load());
+    ASSERT_EQ(progress.size(), 5);
+    std::sort(progress.begin(), progress.end());
+
+    for (unsigned int i = 0; i < progress.size(); i++)
+        ASSERT_EQ(progress[i], std::make_pair(i + 1, 5u));
+
+    // All assets should be loaded when load() returns
+    Sprite *sprite = static_cast<Sprite *>(p.engine()->targetAt(1));
+    ASSERT_TRUE(sprite->costumeAt(0)->data());
+    ASSERT_TRUE(sprite->costumeAt(1)->data());
+    ASSERT_TRUE(sprite->soundAt(0)->data());
+    ASSERT_TRUE(p.engine()->stage()->costumeAt(0)->data());
+}
+
+TEST(LoadProjectTest, AbortAssetLoading)
+{
+    Project p;
+    p.setFileName("default_project.sb3");
+    std::atomic<unsigned int> progressCount = 0;
+
+    p.assetLoadProgressChanged().connect([&p, &progressCount](unsigned int, unsigned int) {
+        if (progressCount++ == 0)
+            p.stopLoading();
+    });
+
+    ASSERT_FALSE(p.load());
+    ASSERT_GE(progressCount, 1);
+}
+
+TEST(LoadProjectTest, LazyAssetLoading)
+{
+    Project p("default_project.sb3");
+    ASSERT_FALSE(p.lazyAssetLoading());
+    p.setLazyAssetLoading(true);
+    ASSERT_TRUE(p.lazyAssetLoading());
+    ASSERT_TRUE(p.load());
+
+    Sprite *sprite = static_cast<Sprite *>(p.engine()->targetAt(1));
+    auto costume = sprite->costumeAt(0);
+    ASSERT_FALSE(costume->isDataLoaded());
+    ASSERT_TRUE(sprite->soundAt(0)->isDataLoaded());
+
+    // The costume is read from the archive on first access
+    std::string data(static_cast<const char *>(costume->data()), costume->dataSize());
+    ASSERT_TRUE(costume->isDataLoaded());
+    ASSERT_EQ(data.substr(0, 4), "<svg");
+}
+
+TEST(LoadProjectTest, DuplicateAssets)
+{
+    for (bool lazy : { false, true }) {
+        Project p("duplicate_assets.sb3");
+        p.setLazyAssetLoading(lazy);
+        ASSERT_TRUE(p.load());
+
+        auto engine = p.engine();
+        Sprite *sprite1 = static_cast<Sprite *>(engine->targetAt(engine->findTarget("Sprite1")));
+        Sprite *sprite2 = static_cast<Sprite *>(engine->targetAt(engine->findTarget("Sprite2")));
+
+        // Assets with the same file share one buffer
+        for (int i = 0; i < 2; i++) {
+            ASSERT_EQ(sprite1->costumeAt(i)->data(), sprite2->costumeAt(i)->data());
+            ASSERT_EQ(sprite1->costumeAt(i)->dataSize(), sprite2->costumeAt(i)->dataSize());
+        }
+
+        ASSERT_EQ(sprite1->soundAt(0)->data(), sprite2->soundAt(0)->data());
+        ASSERT_NE(sprite1->costumeAt(0)->data(), sprite1->costumeAt(1)->data());
+    }
+}
+
 TEST(LoadProjectTest, LoadTopLevelReporterProject)
 {
     int i = 0;
@@ -10,4 +10,16 @@ class AudioEngineMock : public IAudioEngine
     public:
         MOCK_METHOD(float, volume, (), (const, override));
         MOCK_METHOD(void, setVolume, (float), (override));
+
+        MOCK_METHOD(size_t, decodedMemoryBudget, (), (const, override));
+        MOCK_METHOD(void, setDecodedMemoryBudget, (size_t), (override));
+        MOCK_METHOD(size_t, decodedMemoryUsage, (), (const, override));
+
+        MOCK_METHOD(bool, isOffline, (), (const, override));
+        MOCK_METHOD(void, setOffline, (bool), (override));
+
+        MOCK_METHOD(unsigned int, sampleRate, (), (const, override));
+        MOCK_METHOD(unsigned int, channelCount, (), (const, override));
+
+        MOCK_METHOD(size_t, render, (float *, size_t), (override));
 };
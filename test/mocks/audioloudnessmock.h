@@ -9,4 +9,10 @@ class AudioLoudnessMock : public IAudioLoudness
 {
     public:
         MOCK_METHOD(int, getLoudness, (), (const, override));
+
+        MOCK_METHOD(unsigned int, windowSize, (), (const, override));
+        MOCK_METHOD(void, setWindowSize, (unsigned int), (override));
+
+        MOCK_METHOD(unsigned int, updateInterval, (), (const, override));
+        MOCK_METHOD(void, setUpdateInterval, (unsigned int), (override));
 };
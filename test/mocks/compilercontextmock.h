@@ -14,4 +14,5 @@ class CompilerContextMock : public CompilerContext
         }
 
         MOCK_METHOD(void, preoptimize, (), (override));
+        MOCK_METHOD(bool, runReporters, (Thread *, const bool *, ValueData *), (override));
 };
@@ -1,7 +1,10 @@
 #pragma once
 
 #include <scratchcpp/iengine.h>
+#include <scratchcpp/stringptr.h>
+#include <scratchcpp/keyevent.h>
 #include <gmock/gmock.h>
+#include <utf8.h>
 
 namespace libscratchcpp
 {
@@ -29,6 +32,12 @@ class EngineMock : public IEngine
         MOCK_METHOD(double, globalVolume, (), (const, override));
         MOCK_METHOD(void, setGlobalVolume, (double), (override));
 
+        MOCK_METHOD(const std::vector<float> &, renderedAudio, (), (const, override));
+        MOCK_METHOD(unsigned int, renderedAudioSampleRate, (), (const, override));
+        MOCK_METHOD(unsigned int, renderedAudioChannels, (), (const, override));
+        MOCK_METHOD(void, clearRenderedAudio, (), (override));
+        MOCK_METHOD(bool, saveRenderedAudio, (const std::string &), (const, override));
+
         MOCK_METHOD(void, updateMonitors, (), (override));
         MOCK_METHOD(void, step, (), (override));
         MOCK_METHOD(void, run, (), (override));
@@ -48,6 +57,17 @@ class EngineMock : public IEngine
         MOCK_METHOD(void, setTurboModeEnabled, (bool), (override));
 
         MOCK_METHOD(bool, keyPressed, (const std::string &), (const, override));
+
+        // Forward to the key name variant, so that the same expectations can be used for both
+        bool keyPressed(unsigned int keyCode) const override
+        {
+            if (keyCode < 256)
+                return keyPressed(std::string(1, static_cast<char>(keyCode)));
+            else if (keyCode < KeyEvent::CODE_COUNT - 1)
+                return keyPressed(KeyEvent(static_cast<KeyEvent::Type>(keyCode - 255)).name());
+            else
+                return keyPressed(std::string());
+        }
         MOCK_METHOD(void, setKeyState, (const std::string &, bool), (override));
         MOCK_METHOD(void, setKeyState, (const KeyEvent &, bool), (override));
         MOCK_METHOD(void, setAnyKeyPressed, (bool), (override));
@@ -82,6 +102,11 @@ class EngineMock : public IEngine
         MOCK_METHOD(bool, spriteFencingEnabled, (), (const, override));
         MOCK_METHOD(void, setSpriteFencingEnabled, (bool), (override));
 
+        MOCK_METHOD(bool, collisionCacheEnabled, (), (const, override));
+        MOCK_METHOD(void, setCollisionCacheEnabled, (bool), (override));
+
+        MOCK_METHOD(unsigned int, frameCount, (), (const, override));
+
         MOCK_METHOD(void, requestRedraw, (), (override));
 
         MOCK_METHOD(ITimer *, timer, (), (const, override));
@@ -96,6 +121,13 @@ class EngineMock : public IEngine
         MOCK_METHOD(void, setBroadcasts, (const std::vector<std::shared_ptr<Broadcast>> &), (override));
         MOCK_METHOD(std::shared_ptr<Broadcast>, broadcastAt, (int), (const, override));
         MOCK_METHOD(std::vector<int>, findBroadcasts, (const std::string &), (const, override));
+
+        // Forward to the UTF-8 variant, so that the same expectations can be used for both
+        const std::vector<int> &findBroadcasts(const StringPtr *broadcastName) const override
+        {
+            m_foundBroadcasts = findBroadcasts(utf8::utf16to8(std::u16string(broadcastName->data, broadcastName->size)));
+            return m_foundBroadcasts;
+        }
         MOCK_METHOD(int, findBroadcastById, (const std::string &), (const, override));
 
         MOCK_METHOD(void, addWhenTouchingObjectScript, (Block *), (override));
@@ -113,6 +145,9 @@ class EngineMock : public IEngine
         MOCK_METHOD(void, getVisibleTargets, (std::vector<Target *> &), (const, override));
         MOCK_METHOD(int, findTarget, (const std::string &), (const, override));
 
+        // Forward to the UTF-8 variant, so that the same expectations can be used for both
+        int findTarget(const StringPtr *targetName) const override { return findTarget(utf8::utf16to8(std::u16string(targetName->data, targetName->size))); }
+
         MOCK_METHOD(void, moveDrawableToFront, (Drawable *), (override));
         MOCK_METHOD(void, moveDrawableToBack, (Drawable *), (override));
         MOCK_METHOD(void, moveDrawableForwardLayers, (Drawable *, int), (override));
@@ -141,6 +176,9 @@ class EngineMock : public IEngine
         MOCK_METHOD(void, setUserAgent, (const std::string &), (override));
 
         MOCK_METHOD(const std::unordered_set<std::string> &, unsupportedBlocks, (), (const, override));
+
+    private:
+        mutable std::vector<int> m_foundBroadcasts;
 };
 
 } // namespace libscratchcpp
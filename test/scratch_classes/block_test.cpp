@@ -55,6 +55,18 @@ TEST_F(BlockTest, Constructors)
     }
 }
 
+TEST_F(BlockTest, OpcodeId)
+{
+    Block block1("a", "motion_movesteps");
+    Block block2("b", "motion_movesteps");
+    Block block3("c", "motion_turnright");
+    Block block4("d", "motion_turnright", true);
+
+    ASSERT_EQ(block1.opcodeId(), block2.opcodeId());
+    ASSERT_EQ(block3.opcodeId(), block4.opcodeId());
+    ASSERT_NE(block1.opcodeId(), block3.opcodeId());
+}
+
 TEST_F(BlockTest, Next)
 {
     Block block("", "");
@@ -243,3 +243,26 @@ TEST(KeyEventTest, EqualityOperator)
     ASSERT_FALSE(ev7 == ev10);
     ASSERT_FALSE(ev11 == ev13);
 }
+
+TEST(KeyEventTest, Code)
+{
+    ASSERT_EQ(KeyEvent().code(), KeyEvent::CODE_COUNT - 1);
+    ASSERT_EQ(KeyEvent("").code(), KeyEvent::CODE_COUNT - 1);
+    ASSERT_EQ(KeyEvent("a").code(), 'a');
+    ASSERT_EQ(KeyEvent("A").code(), 'a');
+    ASSERT_EQ(KeyEvent("8").code(), '8');
+    ASSERT_EQ(KeyEvent("56").code(), '8');
+    ASSERT_EQ(KeyEvent("ab").code(), 'a');
+    ASSERT_EQ(KeyEvent("\xc3\xa1").code(), 0xc3);
+
+    ASSERT_EQ(KeyEvent(KeyEvent::Type::Space).code(), 256);
+    ASSERT_EQ(KeyEvent(" ").code(), 256);
+    ASSERT_EQ(KeyEvent("32").code(), 256);
+    ASSERT_EQ(KeyEvent(KeyEvent::Type::Left).code(), 257);
+    ASSERT_EQ(KeyEvent(KeyEvent::Type::Up).code(), 258);
+    ASSERT_EQ(KeyEvent("up arrow").code(), 258);
+    ASSERT_EQ(KeyEvent(KeyEvent::Type::Right).code(), 259);
+    ASSERT_EQ(KeyEvent(KeyEvent::Type::Down).code(), 260);
+    ASSERT_EQ(KeyEvent(KeyEvent::Type::Enter).code(), 261);
+    ASSERT_EQ(KeyEvent("enter").code(), 261);
+}
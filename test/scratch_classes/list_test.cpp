@@ -117,6 +117,39 @@ TEST(ListTest, AllocatedSizePtr)
     ASSERT_NE(list.allocatedSizePtr(), list.sizePtr());
 }
 
+TEST(ListTest, Version)
+{
+    List list("", "test list");
+    ASSERT_TRUE(list.versionPtr());
+    ASSERT_EQ(*list.versionPtr(), list.version());
+    unsigned int version = list.version();
+
+    list.append("Lorem");
+    ASSERT_NE(list.version(), version);
+    version = list.version();
+
+    list.insert(0, "ipsum");
+    ASSERT_NE(list.version(), version);
+    version = list.version();
+
+    list.replace(1, "dolor");
+    ASSERT_NE(list.version(), version);
+    version = list.version();
+
+    list.removeAt(0);
+    ASSERT_NE(list.version(), version);
+    version = list.version();
+
+    list.clear();
+    ASSERT_NE(list.version(), version);
+    version = list.version();
+
+    list.size();
+    list.contains("Lorem");
+    ASSERT_EQ(list.version(), version);
+    ASSERT_EQ(*list.versionPtr(), version);
+}
+
 TEST(ListTest, Size)
 {
     List list("", "test list");
@@ -808,6 +808,109 @@ TEST(SpriteTest, TouchingSprite)
     ASSERT_FALSE(clone2->touchingSprite(&another));
 }
 
+TEST(SpriteTest, TouchingSpriteBroadPhase)
+{
+    Sprite sprite;
+    Sprite another;
+    EngineMock engine;
+    another.setEngine(&engine);
+
+    SpriteHandlerMock iface;
+    EXPECT_CALL(iface, init);
+    sprite.setInterface(&iface);
+
+    EXPECT_CALL(engine, cloneLimit()).WillRepeatedly(Return(-1));
+    EXPECT_CALL(engine, spriteFencingEnabled()).WillRepeatedly(Return(false));
+    EXPECT_CALL(engine, requestRedraw).WillRepeatedly(Return());
+    EXPECT_CALL(engine, initClone).Times(2);
+    EXPECT_CALL(engine, moveDrawableBehindOther).Times(2);
+    auto clone1 = another.clone();
+    auto clone2 = another.clone();
+    clone1->setPosition(100, 50);
+    clone2->setPosition(5, 5);
+    std::vector<Sprite *> actualClones;
+
+    // Only sprites with intersecting bounds are passed to the handler
+    EXPECT_CALL(iface, fastBoundingRect()).WillOnce(Return(Rect(-10, 10, 10, -10)));
+    EXPECT_CALL(iface, touchingClones(_)).WillOnce(WithArgs<0>(Invoke([&actualClones](const std::vector<Sprite *> &candidates) {
+        actualClones = candidates;
+        return true;
+    })));
+    ASSERT_TRUE(sprite.touchingSprite(&another));
+    ASSERT_EQ(actualClones, std::vector<Sprite *>({ &another, clone2.get() }));
+
+    // The bounds are cached until the sprite changes
+    clone1->setPosition(5, -5);
+    EXPECT_CALL(iface, fastBoundingRect()).Times(0);
+    EXPECT_CALL(iface, touchingClones(_)).WillOnce(WithArgs<0>(Invoke([&actualClones](const std::vector<Sprite *> &candidates) {
+        actualClones = candidates;
+        return false;
+    })));
+    ASSERT_FALSE(sprite.touchingSprite(&another));
+    ASSERT_EQ(actualClones, std::vector<Sprite *>({ &another, clone1.get(), clone2.get() }));
+
+    EXPECT_CALL(iface, onDirectionChanged);
+    sprite.setDirection(45);
+    EXPECT_CALL(iface, fastBoundingRect()).WillOnce(Return(Rect(-1, 1, 1, -1)));
+    EXPECT_CALL(iface, touchingClones(_)).WillOnce(WithArgs<0>(Invoke([&actualClones](const std::vector<Sprite *> &candidates) {
+        actualClones = candidates;
+        return true;
+    })));
+    ASSERT_TRUE(sprite.touchingSprite(&another));
+    ASSERT_EQ(actualClones, std::vector<Sprite *>({ &another }));
+
+    // The handler isn't called if there are no candidates
+    another.setPosition(50, 50);
+    EXPECT_CALL(iface, touchingClones).Times(0);
+    ASSERT_FALSE(sprite.touchingSprite(&another));
+}
+
+TEST(SpriteTest, RenderVersion)
+{
+    Sprite sprite;
+    SpriteHandlerMock iface;
+    EXPECT_CALL(iface, init);
+    sprite.setInterface(&iface);
+    unsigned int version = sprite.renderVersion();
+
+    EXPECT_CALL(iface, onMoved);
+    EXPECT_CALL(iface, onXChanged);
+    sprite.setX(10);
+    ASSERT_GT(sprite.renderVersion(), version);
+    version = sprite.renderVersion();
+
+    EXPECT_CALL(iface, onSizeChanged);
+    sprite.setSize(50);
+    ASSERT_GT(sprite.renderVersion(), version);
+    version = sprite.renderVersion();
+
+    EXPECT_CALL(iface, onDirectionChanged);
+    sprite.setDirection(-90);
+    ASSERT_GT(sprite.renderVersion(), version);
+    version = sprite.renderVersion();
+
+    EXPECT_CALL(iface, onRotationStyleChanged);
+    sprite.setRotationStyle(Sprite::RotationStyle::LeftRight);
+    ASSERT_GT(sprite.renderVersion(), version);
+    version = sprite.renderVersion();
+
+    EXPECT_CALL(iface, onVisibleChanged);
+    sprite.setVisible(false);
+    ASSERT_GT(sprite.renderVersion(), version);
+    version = sprite.renderVersion();
+
+    GraphicsEffectMock effect;
+    EXPECT_CALL(effect, clamp(5)).WillOnce(Return(5));
+    EXPECT_CALL(iface, onGraphicsEffectChanged);
+    sprite.setGraphicsEffectValue(&effect, 5);
+    ASSERT_GT(sprite.renderVersion(), version);
+    version = sprite.renderVersion();
+
+    EXPECT_CALL(iface, onGraphicsEffectsCleared);
+    sprite.clearGraphicsEffects();
+    ASSERT_GT(sprite.renderVersion(), version);
+}
+
 TEST(SpriteTest, TouchingPoint)
 {
     Sprite sprite;
@@ -849,6 +952,80 @@ TEST(SpriteTest, TouchingColor)
     ASSERT_TRUE(sprite.touchingColor(c2, c1));
 }
 
+TEST(SpriteTest, CollisionCache)
+{
+    Sprite sprite;
+    Sprite another;
+    EngineMock engine;
+    sprite.setEngine(&engine);
+    another.setEngine(&engine);
+
+    SpriteHandlerMock iface;
+    EXPECT_CALL(iface, init);
+    sprite.setInterface(&iface);
+
+    EXPECT_CALL(engine, requestRedraw).WillRepeatedly(Return());
+    EXPECT_CALL(engine, spriteFencingEnabled()).WillRepeatedly(Return(false));
+    EXPECT_CALL(engine, stageWidth()).WillRepeatedly(Return(480));
+    EXPECT_CALL(engine, stageHeight()).WillRepeatedly(Return(360));
+    EXPECT_CALL(iface, fastBoundingRect()).WillRepeatedly(Return(Rect(-10, 10, 10, -10)));
+    EXPECT_CALL(iface, boundingRect()).WillRepeatedly(Return(Rect(-10, 10, 10, -10)));
+    Rgb color = rgb(255, 0, 0);
+
+    // Disabled cache
+    EXPECT_CALL(engine, collisionCacheEnabled()).WillRepeatedly(Return(false));
+    EXPECT_CALL(iface, touchingClones).Times(2).WillRepeatedly(Return(true));
+    ASSERT_TRUE(sprite.touchingSprite(&another));
+    ASSERT_TRUE(sprite.touchingSprite(&another));
+    EXPECT_CALL(iface, touchingColor(color)).Times(2).WillRepeatedly(Return(false));
+    ASSERT_FALSE(sprite.touchingColor(color));
+    ASSERT_FALSE(sprite.touchingColor(color));
+    ASSERT_EQ(sprite.collisionCacheHits(), 0);
+    ASSERT_EQ(sprite.collisionCacheMisses(), 0);
+
+    // Enabled cache
+    EXPECT_CALL(engine, collisionCacheEnabled()).WillRepeatedly(Return(true));
+    EXPECT_CALL(engine, frameCount()).WillRepeatedly(Return(1));
+    EXPECT_CALL(iface, touchingClones).WillOnce(Return(true));
+    ASSERT_TRUE(sprite.touchingSprite(&another));
+    ASSERT_TRUE(sprite.touchingSprite(&another));
+    ASSERT_FALSE(sprite.touchingEdge());
+    ASSERT_FALSE(sprite.touchingEdge());
+    EXPECT_CALL(iface, touchingColor(color)).WillOnce(Return(true));
+    ASSERT_TRUE(sprite.touchingColor(color));
+    ASSERT_TRUE(sprite.touchingColor(color));
+    EXPECT_CALL(iface, touchingColor(color, color)).WillOnce(Return(false));
+    ASSERT_FALSE(sprite.touchingColor(color, color));
+    ASSERT_FALSE(sprite.touchingColor(color, color));
+    ASSERT_EQ(sprite.collisionCacheHits(), 4);
+    ASSERT_EQ(sprite.collisionCacheMisses(), 4);
+
+    // Changes of any involved target invalidate the results
+    another.setX(5);
+    EXPECT_CALL(iface, touchingClones).WillOnce(Return(false));
+    ASSERT_FALSE(sprite.touchingSprite(&another));
+    EXPECT_CALL(iface, touchingColor(color)).WillOnce(Return(false));
+    ASSERT_FALSE(sprite.touchingColor(color));
+    ASSERT_FALSE(sprite.touchingEdge());
+    ASSERT_EQ(sprite.collisionCacheHits(), 5);
+    ASSERT_EQ(sprite.collisionCacheMisses(), 6);
+
+    EXPECT_CALL(iface, onDirectionChanged);
+    sprite.setDirection(45);
+    EXPECT_CALL(iface, boundingRect()).WillOnce(Return(Rect(-250, 10, -230, -10)));
+    ASSERT_TRUE(sprite.touchingEdge());
+    ASSERT_TRUE(sprite.touchingEdge());
+    ASSERT_EQ(sprite.collisionCacheHits(), 6);
+    ASSERT_EQ(sprite.collisionCacheMisses(), 7);
+
+    // The results are dropped in the next frame
+    EXPECT_CALL(engine, frameCount()).WillRepeatedly(Return(2));
+    EXPECT_CALL(iface, touchingColor(color)).WillOnce(Return(true));
+    ASSERT_TRUE(sprite.touchingColor(color));
+    ASSERT_EQ(sprite.collisionCacheHits(), 6);
+    ASSERT_EQ(sprite.collisionCacheMisses(), 8);
+}
+
 TEST(SpriteTest, GraphicsEffects)
 {
     Sprite sprite;
@@ -1,5 +1,7 @@
 #include <scratchcpp/string_functions.h>
 #include <scratchcpp/stringptr.h>
+#include <utf8.h>
+#include <algorithm>
 
 #include "../common.h"
 
@@ -86,6 +88,74 @@ TEST(StringFunctionsTest, AssignAlloc)
     ASSERT_EQ(str1.data[0], u'\0');
 }
 
+TEST(StringFunctionsTest, AllocInline)
+{
+    StringPtr str;
+    string_alloc(&str, 1);
+    ASSERT_TRUE(str.isInline());
+    ASSERT_EQ(str.allocatedSize, StringPtr::INLINE_CAPACITY);
+
+    string_assign_cstring(&str, "abc");
+    ASSERT_TRUE(str.isInline());
+
+    // Growing moves the characters to the heap
+    string_alloc(&str, 100);
+    ASSERT_FALSE(str.isInline());
+    ASSERT_GE(str.allocatedSize, 101);
+    ASSERT_EQ(str.size, 3);
+    ASSERT_EQ(str.data[0], u'a');
+    ASSERT_EQ(str.data[1], u'b');
+    ASSERT_EQ(str.data[2], u'c');
+    ASSERT_EQ(str.data[3], u'\0');
+
+    // Heap strings stay on the heap
+    string_assign_cstring(&str, "x");
+    ASSERT_FALSE(str.isInline());
+    ASSERT_EQ(str.data[0], u'x');
+}
+
+TEST(StringFunctionsTest, Append)
+{
+    StringPtr str("ab");
+    StringPtr other("cd");
+
+    string_append(&str, &other);
+    ASSERT_EQ(str.size, 4);
+    ASSERT_EQ(utf8::utf16to8(std::u16string(str.data)), "abcd");
+    ASSERT_EQ(utf8::utf16to8(std::u16string(other.data)), "cd");
+
+    // Append to itself
+    string_append(&str, &str);
+    ASSERT_EQ(str.size, 8);
+    ASSERT_EQ(utf8::utf16to8(std::u16string(str.data)), "abcdabcd");
+
+    StringPtr empty;
+    string_alloc(&empty, 0);
+    empty.data[0] = u'\0';
+    string_append(&str, &empty);
+    ASSERT_EQ(utf8::utf16to8(std::u16string(str.data)), "abcdabcd");
+
+    // The allocation grows geometrically
+    StringPtr ch("x");
+    StringPtr longStr("");
+    size_t reallocations = 0;
+    size_t allocatedSize = longStr.allocatedSize;
+
+    for (int i = 0; i < 100000; i++) {
+        string_append(&longStr, &ch);
+
+        if (longStr.allocatedSize != allocatedSize) {
+            allocatedSize = longStr.allocatedSize;
+            reallocations++;
+        }
+    }
+
+    ASSERT_EQ(longStr.size, 100000);
+    ASSERT_EQ(longStr.data[99999], u'x');
+    ASSERT_EQ(longStr.data[100000], u'\0');
+    ASSERT_LT(reallocations, 20);
+}
+
 TEST(StringFunctionsTest, CompareCaseSensitive)
 {
     StringPtr str1, str2;
@@ -396,6 +466,74 @@ TEST(StringFunctionsTest, ContainsCaseInsensitive)
     ASSERT_FALSE(string_contains_raw_case_insensitive(str.data, substr.data));
 }
 
+TEST(StringFunctionsTest, ContainsOverlappingPrefix)
+{
+    StringPtr str, substr;
+
+    string_assign_cstring(&str, "aab");
+    string_assign_cstring(&substr, "ab");
+    ASSERT_TRUE(string_contains_case_sensitive(&str, &substr));
+    ASSERT_TRUE(string_contains_raw_case_sensitive(str.data, substr.data));
+    ASSERT_TRUE(string_contains_case_insensitive(&str, &substr));
+    ASSERT_TRUE(string_contains_raw_case_insensitive(str.data, substr.data));
+
+    string_assign_cstring(&str, "ááb");
+    string_assign_cstring(&substr, "ÁB");
+    ASSERT_FALSE(string_contains_case_sensitive(&str, &substr));
+    ASSERT_TRUE(string_contains_case_insensitive(&str, &substr));
+
+    string_assign_cstring(&str, "abc");
+    string_assign_cstring(&substr, "");
+    ASSERT_FALSE(string_contains_case_sensitive(&str, &substr));
+    ASSERT_FALSE(string_contains_case_insensitive(&str, &substr));
+}
+
+TEST(StringFunctionsTest, LongStrings)
+{
+    // Exercise the vectorized code paths (including the tails)
+    for (size_t len : { 7, 8, 15, 16, 17, 31, 32, 33, 100 }) {
+        std::string base;
+
+        for (size_t i = 0; i < len; i++)
+            base.push_back('a' + i % 26);
+
+        std::string upper = base;
+        std::transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
+
+        StringPtr str1(base), str2(base), str3(upper);
+        ASSERT_EQ(string_compare_case_sensitive(&str1, &str2), 0);
+        ASSERT_GT(string_compare_case_sensitive(&str1, &str3), 0);
+        ASSERT_EQ(string_compare_case_insensitive(&str1, &str3), 0);
+
+        // Difference at the last position
+        std::string changed = base;
+        changed.back() = '!';
+        StringPtr str4(changed);
+        ASSERT_GT(string_compare_case_sensitive(&str1, &str4), 0);
+        ASSERT_LT(string_compare_case_insensitive(&str4, &str3), 0);
+
+        // Non-ASCII character at the last position
+        StringPtr str5(base.substr(0, len - 1) + "Č");
+        StringPtr str6(upper.substr(0, len - 1) + "č");
+        ASSERT_NE(string_compare_case_sensitive(&str5, &str6), 0);
+        ASSERT_EQ(string_compare_case_insensitive(&str5, &str6), 0);
+
+        // Substring at the end
+        StringPtr substr(upper.substr(len - 5));
+        ASSERT_FALSE(string_contains_case_sensitive(&str1, &substr));
+        ASSERT_TRUE(string_contains_case_sensitive(&str3, &substr));
+        ASSERT_TRUE(string_contains_case_insensitive(&str1, &substr));
+
+        StringPtr missing(upper.substr(len - 5) + "?");
+        ASSERT_FALSE(string_contains_case_insensitive(&str1, &missing));
+    }
+
+    // Kelvin sign is a lower case variant of 'k'
+    StringPtr str("Lorem ipsum dolor sit amet \u212A");
+    StringPtr substr("amet k");
+    ASSERT_TRUE(string_contains_case_insensitive(&str, &substr));
+}
+
 TEST(StringFunctionsTest, EqualCaseSensitive)
 {
     StringPtr str1, str2;
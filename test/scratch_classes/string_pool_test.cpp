@@ -1,6 +1,7 @@
 #include <scratchcpp/string_pool.h>
 #include <scratchcpp/string_functions.h>
 #include <scratchcpp/stringptr.h>
+#include <thread>
 
 #include "../common.h"
 
@@ -28,3 +29,115 @@ TEST(StringPoolTest, NewAndFree)
 
     // str3 will be deallocated later
 }
+
+TEST(StringPoolTest, Reuse)
+{
+    string_pool_trim();
+    ASSERT_EQ(string_pool_free_count(), 0);
+    ASSERT_EQ(string_pool_free_bytes(), 0);
+    const size_t live = string_pool_live_count();
+
+    StringPtr *str1 = string_pool_new();
+    string_assign_cstring(str1, "a");
+    StringPtr *str2 = string_pool_new();
+    string_assign_cstring(str2, "Lorem ipsum dolor sit amet");
+    ASSERT_EQ(string_pool_live_count(), live + 2);
+
+    string_pool_free(str1);
+    string_pool_free(str2);
+    ASSERT_EQ(string_pool_live_count(), live);
+    ASSERT_EQ(string_pool_free_count(), 2);
+    ASSERT_GE(string_pool_free_bytes(), 2 * sizeof(StringPtr) + 27 * sizeof(char16_t));
+
+    // The string with the highest capacity is reused first
+    ASSERT_EQ(string_pool_new(), str2);
+    ASSERT_EQ(string_pool_new(), str1);
+    ASSERT_EQ(string_pool_free_count(), 0);
+    ASSERT_EQ(string_pool_free_bytes(), 0);
+
+    string_pool_free(str1);
+    string_pool_free(str2);
+    string_pool_trim();
+    ASSERT_EQ(string_pool_free_count(), 0);
+    ASSERT_EQ(string_pool_free_bytes(), 0);
+}
+
+TEST(StringPoolTest, Threads)
+{
+    StringPtr *str = string_pool_new();
+    string_pool_free(str);
+    const size_t freeCount = string_pool_free_count();
+
+    // Every thread has its own pool
+    std::thread thread([]() {
+        ASSERT_EQ(string_pool_free_count(), 0);
+        StringPtr *str = string_pool_new();
+        string_assign_cstring(str, "test");
+        string_pool_free(str);
+        ASSERT_EQ(string_pool_free_count(), 1);
+    });
+
+    thread.join();
+    ASSERT_EQ(string_pool_free_count(), freeCount);
+}
+
+TEST(StringPoolTest, LiveBytes)
+{
+    string_pool_trim();
+    const size_t liveBytes = string_pool_live_bytes();
+
+    StringPtr *str1 = string_pool_new();
+    string_assign_cstring(str1, "a");
+    ASSERT_EQ(string_pool_live_bytes(), liveBytes + sizeof(StringPtr));
+
+    // Characters which don't fit into the inline buffer are counted
+    StringPtr *str2 = string_pool_new();
+    string_assign_cstring(str2, "Lorem ipsum dolor sit amet");
+    ASSERT_EQ(string_pool_live_bytes(), liveBytes + 2 * sizeof(StringPtr) + 48 * sizeof(char16_t));
+
+    string_assign_cstring(str1, "Lorem ipsum dolor sit amet, consectetur adipiscing elit");
+    ASSERT_EQ(string_pool_live_bytes(), liveBytes + 2 * sizeof(StringPtr) + (48 + 96) * sizeof(char16_t));
+
+    // Free strings are counted by string_pool_free_bytes()
+    string_pool_free(str1);
+    ASSERT_EQ(string_pool_live_bytes(), liveBytes + sizeof(StringPtr) + 48 * sizeof(char16_t));
+    ASSERT_EQ(string_pool_free_bytes(), sizeof(StringPtr) + 96 * sizeof(char16_t));
+
+    string_pool_free(str2);
+    ASSERT_EQ(string_pool_live_bytes(), liveBytes);
+
+    // Strings which don't come from the pool are counted as well
+    {
+        StringPtr str;
+        string_assign_cstring(&str, "Lorem ipsum dolor sit amet");
+        ASSERT_EQ(string_pool_live_bytes(), liveBytes + 48 * sizeof(char16_t));
+    }
+
+    ASSERT_EQ(string_pool_live_bytes(), liveBytes);
+    string_pool_trim();
+    ASSERT_EQ(string_pool_live_bytes(), liveBytes);
+}
+
+TEST(StringPoolTest, LiveCountInThreads)
+{
+    const size_t live = string_pool_live_count();
+    const size_t liveBytes = string_pool_live_bytes();
+    StringPtr *str = nullptr;
+
+    // Live strings of all threads are counted, even after the thread finishes
+    std::thread thread([&str]() {
+        str = string_pool_new();
+        string_assign_cstring(str, "Lorem ipsum dolor sit amet");
+    });
+
+    thread.join();
+    ASSERT_EQ(string_pool_live_count(), live + 1);
+    ASSERT_EQ(string_pool_live_bytes(), liveBytes + sizeof(StringPtr) + 48 * sizeof(char16_t));
+
+    string_pool_free(str);
+    ASSERT_EQ(string_pool_live_count(), live);
+    ASSERT_EQ(string_pool_live_bytes(), liveBytes);
+
+    string_pool_trim();
+    ASSERT_EQ(string_pool_live_bytes(), liveBytes);
+}
@@ -25,3 +25,17 @@ TEST(StringPtrTest, StringConstructor)
     ASSERT_EQ(str.data[3], u't');
     ASSERT_EQ(str.data[4], u'\0');
 }
+
+TEST(StringPtrTest, InlineStorage)
+{
+    StringPtr str1("Hello world");
+    ASSERT_TRUE(str1.isInline());
+    ASSERT_EQ(str1.data, str1.inlineData);
+    ASSERT_EQ(str1.allocatedSize, StringPtr::INLINE_CAPACITY);
+
+    StringPtr str2("Hello world!");
+    ASSERT_FALSE(str2.isInline());
+    ASSERT_GE(str2.allocatedSize, 13);
+    ASSERT_EQ(str2.data[11], u'!');
+    ASSERT_EQ(str2.data[12], u'\0');
+}
@@ -76,6 +76,7 @@ TEST(TargetTest, Variables)
 
     Target target;
     ASSERT_EQ(target.variableData(), nullptr);
+    ASSERT_EQ(target.variableVersionData(), nullptr);
     ASSERT_EQ(target.addVariable(v1), 0);
     ASSERT_TRUE(target.variableData());
     ASSERT_EQ(target.variableData()[0], &v1->value().data());
@@ -89,6 +90,10 @@ TEST(TargetTest, Variables)
     ASSERT_EQ(target.variableData()[1], &v2->value().data());
     ASSERT_EQ(target.variableData()[2], &v3->value().data());
 
+    ASSERT_EQ(target.variableVersionData()[0], v1->versionPtr());
+    ASSERT_EQ(target.variableVersionData()[1], v2->versionPtr());
+    ASSERT_EQ(target.variableVersionData()[2], v3->versionPtr());
+
     ASSERT_EQ(v1->target(), &target);
     ASSERT_EQ(v2->target(), &target);
     ASSERT_EQ(v3->target(), &target);
@@ -111,6 +116,43 @@ TEST(TargetTest, Variables)
     ASSERT_EQ(target.findVariableById("c"), 2);
 }
 
+TEST(TargetTest, FindEntitiesWithDuplicateOrChangedIds)
+{
+    auto v1 = std::make_shared<Variable>("a", "var1");
+    auto v2 = std::make_shared<Variable>("a", "var2");
+    auto v3 = std::make_shared<Variable>("b", "var3");
+
+    Target target;
+    ASSERT_EQ(target.addVariable(v1), 0);
+    ASSERT_EQ(target.addVariable(v2), 1);
+    ASSERT_EQ(target.addVariable(v3), 2);
+    ASSERT_EQ(target.addVariable(v2), 1);
+    ASSERT_EQ(target.variables(), std::vector<std::shared_ptr<Variable>>({ v1, v2, v3 }));
+
+    // The first variable with the ID is returned
+    ASSERT_EQ(target.findVariableById("a"), 0);
+
+    v1->setId("c");
+    ASSERT_EQ(target.findVariableById("a"), 1);
+    ASSERT_EQ(target.findVariableById("b"), 2);
+    ASSERT_EQ(target.findVariableById("c"), 0);
+
+    auto b1 = std::make_shared<Block>("a", "");
+    auto b2 = std::make_shared<Block>("b", "");
+    ASSERT_EQ(target.addBlock(b1), 0);
+    ASSERT_EQ(target.addBlock(b2), 1);
+    b1->setId("c");
+    ASSERT_EQ(target.findBlock("a"), -1);
+    ASSERT_EQ(target.findBlock("b"), 1);
+    ASSERT_EQ(target.findBlock("c"), 0);
+
+    // Adding an entity with the new ID of an existing one
+    auto b3 = std::make_shared<Block>("c", "");
+    ASSERT_EQ(target.addBlock(b3), 2);
+    ASSERT_EQ(target.blocks(), std::vector<std::shared_ptr<Block>>({ b1, b2, b3 }));
+    ASSERT_EQ(target.findBlock("c"), 0);
+}
+
 TEST(TargetTest, Lists)
 {
     auto l1 = std::make_shared<List>("a", "list1");
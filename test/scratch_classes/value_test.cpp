@@ -3174,6 +3174,30 @@ TEST(ValueTest, ComparisonOperators)
         ASSERT_TRUE(v3 < v9);
     }
 
+    {
+        // Infinity strings are compared as numbers with number strings
+        Value v1 = "Infinity";
+        Value v2 = "-Infinity";
+        Value v3 = "-5";
+        Value v4 = "1e308";
+
+        ASSERT_FALSE(v2 > v3);
+        ASSERT_TRUE(v2 < v3);
+        ASSERT_TRUE(v3 > v2);
+        ASSERT_FALSE(v3 < v2);
+
+        ASSERT_TRUE(v1 > v3);
+        ASSERT_FALSE(v1 < v3);
+        ASSERT_TRUE(v1 > v4);
+        ASSERT_FALSE(v1 < v4);
+        ASSERT_FALSE(v1 == v4);
+
+        ASSERT_TRUE(v1 > v2);
+        ASSERT_FALSE(v1 < v2);
+        ASSERT_FALSE(v1 == v2);
+        ASSERT_TRUE(v2 == Value("-Infinity"));
+    }
+
     {
         Value v1 = "abc";
         Value v2 = " ";
@@ -3424,6 +3448,47 @@ TEST(ValueTest, DoubleToStringPtr)
     value_doubleToStringPtr(std::numeric_limits<double>::quiet_NaN(), ret);
     ASSERT_EQ(utf8::utf16to8(std::u16string(ret->data)), "NaN");
 
+    // Shortest representation which round-trips (same as JavaScript)
+    ret = string_pool_new();
+    value_doubleToStringPtr(0.1 + 0.2, ret);
+    ASSERT_EQ(utf8::utf16to8(std::u16string(ret->data)), "0.30000000000000004");
+
+    ret = string_pool_new();
+    value_doubleToStringPtr(1.0 / 3, ret);
+    ASSERT_EQ(utf8::utf16to8(std::u16string(ret->data)), "0.3333333333333333");
+
+    ret = string_pool_new();
+    value_doubleToStringPtr(1e21, ret);
+    ASSERT_EQ(utf8::utf16to8(std::u16string(ret->data)), "1e+21");
+
+    ret = string_pool_new();
+    value_doubleToStringPtr(123456789012345680000.0, ret);
+    ASSERT_EQ(utf8::utf16to8(std::u16string(ret->data)), "123456789012345680000");
+
+    ret = string_pool_new();
+    value_doubleToStringPtr(9007199254740993.0, ret);
+    ASSERT_EQ(utf8::utf16to8(std::u16string(ret->data)), "9007199254740992");
+
+    ret = string_pool_new();
+    value_doubleToStringPtr(65535.0, ret);
+    ASSERT_EQ(utf8::utf16to8(std::u16string(ret->data)), "65535");
+
+    ret = string_pool_new();
+    value_doubleToStringPtr(-1024.0, ret);
+    ASSERT_EQ(utf8::utf16to8(std::u16string(ret->data)), "-1024");
+
+    ret = string_pool_new();
+    value_doubleToStringPtr(5e-324, ret);
+    ASSERT_EQ(utf8::utf16to8(std::u16string(ret->data)), "5e-324");
+
+    ret = string_pool_new();
+    value_doubleToStringPtr(-1.7976931348623157e308, ret);
+    ASSERT_EQ(utf8::utf16to8(std::u16string(ret->data)), "-1.7976931348623157e+308");
+
+    ret = string_pool_new();
+    value_doubleToStringPtr(1.5e-7, ret);
+    ASSERT_EQ(utf8::utf16to8(std::u16string(ret->data)), "1.5e-7");
+
     std::setlocale(LC_NUMERIC, oldLocale.c_str());
 }
 
@@ -3576,6 +3641,42 @@ TEST(ValueTest, StringToDoubleWithCheck)
     ASSERT_FALSE(ok);
 }
 
+TEST(ValueTest, StringToDoubleCache)
+{
+    StringPtr str("3.5");
+    ASSERT_EQ(str.numberState, StringPtr::NumberState::Unknown);
+
+    ASSERT_EQ(value_stringToDouble(&str), 3.5);
+    ASSERT_EQ(str.numberState, StringPtr::NumberState::Valid);
+    ASSERT_EQ(str.numberValue, 3.5);
+
+    // Any change invalidates the cached number
+    string_assign_cstring(&str, "abc");
+    ASSERT_EQ(str.numberState, StringPtr::NumberState::Unknown);
+
+    bool ok = true;
+    ASSERT_EQ(value_stringToDoubleWithCheck(&str, &ok), 0);
+    ASSERT_FALSE(ok);
+    ASSERT_EQ(str.numberState, StringPtr::NumberState::Invalid);
+
+    // The cached result is used
+    str.numberValue = 5;
+    str.numberState = StringPtr::NumberState::Valid;
+    ASSERT_EQ(value_stringToDoubleWithCheck(&str, &ok), 5);
+    ASSERT_TRUE(ok);
+
+    StringPtr other("-Infinity");
+    string_assign(&str, &other);
+    ASSERT_EQ(str.numberState, StringPtr::NumberState::Unknown);
+    ASSERT_EQ(value_stringToDoubleWithCheck(&str, &ok), -std::numeric_limits<double>::infinity());
+    ASSERT_TRUE(ok);
+
+    string_append(&str, &other);
+    ASSERT_EQ(str.numberState, StringPtr::NumberState::Unknown);
+    ASSERT_EQ(value_stringToDoubleWithCheck(&str, &ok), 0);
+    ASSERT_FALSE(ok);
+}
+
 TEST(ValueTest, StringToBool)
 {
     ASSERT_TRUE(value_stringToBool(string_pool_new_assign("2147483647")));
@@ -51,6 +51,22 @@ TEST(VariableTest, ValuePtr)
     ASSERT_EQ(var.valuePtr()->toString(), "Hello, world!");
 }
 
+TEST(VariableTest, Version)
+{
+    Variable var("", "");
+    ASSERT_TRUE(var.versionPtr());
+    unsigned int version = var.version();
+    ASSERT_EQ(*var.versionPtr(), version);
+
+    var.setValue("hello");
+    ASSERT_NE(var.version(), version);
+    version = var.version();
+
+    var.setValue("hello");
+    ASSERT_NE(var.version(), version);
+    ASSERT_EQ(*var.versionPtr(), var.version());
+}
+
 TEST(VariableTest, IsCloudVariable)
 {
     Variable var("", "");
@@ -37,3 +37,44 @@ TEST(ZipTest, FileManager)
 {
     ASSERT_EQ(readSb3Json("file_manager.sb3"), readFileStr("file_manager.json"));
 }
+
+TEST(ZipTest, StoredEntries)
+{
+    ZipReader reader("stored_assets.sb3");
+    ASSERT_TRUE(reader.open());
+    ASSERT_FALSE(reader.isStored("project.json"));
+    ASSERT_TRUE(reader.isStored("cd21514d0531fdffb22204e0ec5ed84a.svg"));
+    ASSERT_FALSE(reader.isStored("idontexist.svg"));
+
+    std::string json;
+    reader.readFileToString("project.json", json);
+    ASSERT_EQ(json, readFileStr("default_project.json"));
+
+    // Stored entries are views into the mapped file
+    ZipReader compressedReader("default_project.sb3");
+    ASSERT_TRUE(compressedReader.open());
+    ASSERT_FALSE(compressedReader.isStored("cd21514d0531fdffb22204e0ec5ed84a.svg"));
+
+    for (const std::string &name : { "83a9787d4cb6f3b7632b4ddfebf74367.wav", "cd21514d0531fdffb22204e0ec5ed84a.svg", "project.json" }) {
+        std::shared_ptr<const void> data;
+        size_t size = reader.readFile(name, data);
+        ASSERT_TRUE(data);
+
+        std::shared_ptr<const void> expected;
+        size_t expectedSize = compressedReader.readFile(name, expected);
+        ASSERT_TRUE(expected);
+        ASSERT_EQ(size, expectedSize);
+        ASSERT_EQ(memcmp(data.get(), expected.get(), size), 0);
+    }
+
+    // The data stays valid after closing the reader
+    std::shared_ptr<const void> data;
+    size_t size = reader.readFile("cd21514d0531fdffb22204e0ec5ed84a.svg", data);
+    reader.close();
+    ASSERT_GT(size, 0);
+    ASSERT_EQ(std::string(static_cast<const char *>(data.get()), 4), "<svg");
+
+    std::shared_ptr<const void> missing;
+    ASSERT_EQ(reader.readFile("cd21514d0531fdffb22204e0ec5ed84a.svg", missing), 0);
+    ASSERT_FALSE(missing);
+}